@@ -0,0 +1,124 @@
+// accel.c
+
+#include "app/accel.h"
+
+#include <stddef.h>
+
+// 慢拧（< 4 格/秒）一格一秒，方便精调；
+// 拧到 40 格/秒（手指快速一搓）时一格两分钟，0 到 45:00 二十几格就够
+static const accel_point_t ACCEL_POINTS_DEFAULT[] = {
+    {  4000,   1 },
+    {  8000,   5 },
+    { 15000,  15 },
+    { 25000,  60 },
+    { 40000, 120 },
+};
+
+const accel_curve_t ACCEL_CURVE_DEFAULT = {
+    .points        = ACCEL_POINTS_DEFAULT,
+    .n_points      = sizeof(ACCEL_POINTS_DEFAULT) / sizeof(ACCEL_POINTS_DEFAULT[0]),
+    .smooth_shift  = 1,
+    .idle_reset_us = 400000,
+    .snap_min_step = 5,
+};
+
+// 吸附粒度：不超过当前步长的最大“整数”
+static const uint16_t ACCEL_SNAPS[] = { 300, 60, 30, 15, 10, 5 };
+
+static uint16_t curve_lookup(const accel_curve_t *c, uint32_t v) {
+    const accel_point_t *p = c->points;
+    if (v <= p[0].v_mdps) {
+        return p[0].step_sec;
+    }
+    for (uint8_t i = 1; i < c->n_points; ++i) {
+        if (v <= p[i].v_mdps) {
+            uint32_t dv = p[i].v_mdps - p[i - 1].v_mdps;
+            int32_t  ds = (int32_t)p[i].step_sec - (int32_t)p[i - 1].step_sec;
+            return (uint16_t)(p[i - 1].step_sec +
+                              ds * (int32_t)(v - p[i - 1].v_mdps) / (int32_t)dv);
+        }
+    }
+    return p[c->n_points - 1].step_sec;
+}
+
+void accel_reset(accel_t *a) {
+    *a = (accel_t){0};
+}
+
+int32_t accel_step(accel_t *a, const accel_curve_t *c, int8_t dir, uint64_t t_us, uint16_t target) {
+    uint64_t dt = t_us - a->last_us;
+
+    if (a->last_us == 0 || dir != a->last_dir || dt > c->idle_reset_us || dt == 0) {
+        // 第一格、换向、停顿：速度从 0 算起，这一格只走最小步长
+        a->v_mdps = 0;
+    } else {
+        // 1e9 / dt(us) = 毫格/秒
+        uint32_t v_inst = (uint32_t)(1000000000ull / dt);
+        if (v_inst >= a->v_mdps) {
+            a->v_mdps += (v_inst - a->v_mdps) >> c->smooth_shift;
+        } else {
+            a->v_mdps -= (a->v_mdps - v_inst) >> c->smooth_shift;
+        }
+    }
+    a->last_us  = t_us;
+    a->last_dir = dir;
+
+    uint16_t step = curve_lookup(c, a->v_mdps);
+    if (step == 0) {
+        step = 1;
+    }
+    a->step_sec = step;
+    a->snap_sec = 0;
+
+    int32_t next = (int32_t)target + dir * (int32_t)step;
+    if (step >= c->snap_min_step) {
+        for (size_t i = 0; i < sizeof(ACCEL_SNAPS) / sizeof(ACCEL_SNAPS[0]); ++i) {
+            uint16_t q = ACCEL_SNAPS[i];
+            if (q <= step) {
+                // 往转动方向取整：加的时候向下取整，减的时候向上取整，
+                // 这样每格都至少动一点，又总是落在 q 的整数倍上
+                if (dir > 0) {
+                    next = (next / q) * q;
+                    if (next <= (int32_t)target) next = ((int32_t)target / q + 1) * q;
+                } else {
+                    next = ((next + q - 1) / q) * q;
+                    if (next < 0) next = 0;
+                    if (next >= (int32_t)target) next = (((int32_t)target - 1) / q) * q;
+                }
+                a->snap_sec = q;
+                break;
+            }
+        }
+    }
+    return next - (int32_t)target;
+}
+
+// ---------- 原来的六档阶梯 ----------
+
+#define LADDER_FAST_US   50000     // < 50ms 才算真快
+#define LADDER_SLOW_US   400000    // > 400ms 算停顿
+
+static const int32_t LADDER_STEPS[] = { 1, 2, 5, 10, 20, 30 };
+#define LADDER_LEN  ((int)(sizeof(LADDER_STEPS) / sizeof(LADDER_STEPS[0])))
+
+void accel_ladder_reset(accel_ladder_t *l) {
+    *l = (accel_ladder_t){0};
+}
+
+int32_t accel_ladder_step(accel_ladder_t *l, int8_t dir, uint64_t t_us) {
+    if (l->last_us == 0) {
+        l->idx = 0;
+    } else {
+        uint64_t diff_ms = (t_us - l->last_us) / 1000;
+        if (dir == l->last_dir && diff_ms > 0 && diff_ms < LADDER_FAST_US / 1000) {
+            if (l->idx < LADDER_LEN - 1) {
+                l->idx++;
+            }
+        } else if (diff_ms > LADDER_SLOW_US / 1000 || dir != l->last_dir) {
+            l->idx = 0;
+        }
+    }
+    l->last_dir = dir;
+    l->last_us  = t_us;
+    return dir * LADDER_STEPS[l->idx];
+}
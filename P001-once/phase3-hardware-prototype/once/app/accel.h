@@ -0,0 +1,62 @@
+// accel.h
+// 旋钮加速：根据每一格的时间戳估计转速（平滑后），按可配置的曲线换算成“每格多少秒”，
+// 转得快时把目标时间吸附到整数值（整 5 秒 / 整分钟……）。
+// 原来的六档阶梯（STEP_TAB + FAST_MS / SLOW_MS）也保留在这里，方便对比。
+// 纯计算，不碰硬件，主机上可以直接回放。
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 曲线上的一个点：转速（毫格/秒）→ 每格秒数；点之间线性插值，两头取端点值
+typedef struct {
+    uint32_t v_mdps;
+    uint16_t step_sec;
+} accel_point_t;
+
+typedef struct {
+    const accel_point_t *points;     // 按 v_mdps 递增
+    uint8_t              n_points;
+    uint8_t              smooth_shift;  // 转速平滑：v += (v_inst - v) >> shift
+    uint32_t             idle_reset_us; // 停顿超过这么久就从头算（和原来 SLOW_MS 一样）
+    uint16_t             snap_min_step; // 每格步长达到这么多秒才开始吸附
+} accel_curve_t;
+
+extern const accel_curve_t ACCEL_CURVE_DEFAULT;
+
+typedef struct {
+    uint64_t last_us;
+    int8_t   last_dir;
+    uint32_t v_mdps;      // 平滑后的转速
+    uint16_t step_sec;    // 最近一格用的步长
+    uint16_t snap_sec;    // 最近一格用的吸附粒度，0 = 没吸附
+} accel_t;
+
+void accel_reset(accel_t *a);
+
+/**
+ * 来了一格：dir = +1 / -1，t_us 是这一格的检测时刻，target 是当前目标时间。
+ * 返回目标时间的增量（秒，带符号）；转得快时保证 target + 增量 落在整数值上。
+ */
+int32_t accel_step(accel_t *a, const accel_curve_t *c, int8_t dir, uint64_t t_us, uint16_t target);
+
+// ---------- 原来的六档阶梯 ----------
+
+typedef struct {
+    uint64_t last_us;
+    int8_t   last_dir;
+    int      idx;
+} accel_ladder_t;
+
+void accel_ladder_reset(accel_ladder_t *l);
+
+// 连续两格同向且间隔 < 50 ms 升一档，> 400 ms 或换向回到第一档
+int32_t accel_ladder_step(accel_ladder_t *l, int8_t dir, uint64_t t_us);
+
+#ifdef __cplusplus
+}
+#endif
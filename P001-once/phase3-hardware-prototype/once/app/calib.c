@@ -0,0 +1,167 @@
+// calib.c
+
+#include "app/calib.h"
+
+#include <string.h>
+
+#define CALIB_MAX_ENTRY(max_sec) max_sec,
+
+static const uint16_t CALIB_BUCKET_MAX[CALIB_BUCKETS] = {
+    CALIB_BUCKET_LIST(CALIB_MAX_ENTRY)
+};
+
+// 直方图格的边界（bp）：第 i 格是 [EDGES[i-1], EDGES[i])，第 0 格和最后一格是开区间
+static const int16_t CALIB_HIST_EDGES[CALIB_HIST_BINS - 1] = {
+    -1000, -500, -300, -200, -100, 0, 100, 200, 300, 500, 1000,
+};
+
+// 新记录的初始权重；涨到上限就整体减半
+#define CALIB_HIST_W0      64
+#define CALIB_HIST_W_MAX   4096
+
+void calib_init(calib_t *c) {
+    memset(c, 0, sizeof(*c));
+    for (uint8_t i = 0; i < CALIB_BUCKETS; ++i) {
+        c->b[i].hist_w = CALIB_HIST_W0;
+    }
+}
+
+uint8_t calib_bucket_of(uint16_t target_sec) {
+    uint8_t i = 0;
+    while (i < CALIB_BUCKETS - 1 && target_sec > CALIB_BUCKET_MAX[i]) {
+        i++;
+    }
+    return i;
+}
+
+uint16_t calib_bucket_max_sec(uint8_t bucket) {
+    return CALIB_BUCKET_MAX[bucket < CALIB_BUCKETS ? bucket : CALIB_BUCKETS - 1];
+}
+
+int32_t calib_err_bp(uint64_t actual_us, uint64_t target_us) {
+    int64_t diff = (int64_t)actual_us - (int64_t)target_us;
+    int64_t bp   = diff * 10000 / (int64_t)target_us;
+    if (bp > CALIB_ERR_LIMIT_BP) return CALIB_ERR_LIMIT_BP;
+    if (bp < -CALIB_ERR_LIMIT_BP) return -CALIB_ERR_LIMIT_BP;
+    return (int32_t)bp;
+}
+
+static uint8_t hist_bin(int32_t err_bp) {
+    uint8_t i = 0;
+    while (i < CALIB_HIST_BINS - 1 && err_bp >= CALIB_HIST_EDGES[i]) {
+        i++;
+    }
+    return i;
+}
+
+static void hist_halve(calib_bucket_t *b) {
+    for (uint8_t i = 0; i < CALIB_HIST_BINS; ++i) {
+        b->hist[i] = (uint16_t)((b->hist[i] + 1) >> 1);
+    }
+    b->hist_w = (uint16_t)((b->hist_w + 1) >> 1);
+}
+
+void calib_bucket_add(calib_bucket_t *b, int32_t err_bp) {
+    int64_t x = (int64_t)err_bp << 8;
+
+    // Welford：先用旧均值算 delta，再用新均值算 delta2，平方和加 delta * delta2
+    // 除法四舍五入，截断的话误差每次都往 0 那边偏，几千次以后能差出 1 bp
+    b->n++;
+    int64_t delta = x - b->mean_q8;
+    int64_t half  = (int64_t)(b->n / 2);
+    b->mean_q8 += (int32_t)((delta >= 0 ? delta + half : delta - half) / (int64_t)b->n);
+    int64_t prod = delta * (x - b->mean_q8);
+    if (prod > 0) {
+        b->m2 += (uint64_t)prod >> 16;
+    }
+
+    if (b->n == 1) {
+        b->ew_q8 = (int32_t)x;
+    } else {
+        b->ew_q8 += (int32_t)(x - b->ew_q8) >> CALIB_EW_SHIFT;
+    }
+
+    // 权重涨到上限或者这一格装不下了就整体减半，比例不变
+    uint8_t bin = hist_bin(err_bp);
+    if (b->hist_w == 0) {
+        b->hist_w = CALIB_HIST_W0;
+    }
+    while (b->hist_w >= CALIB_HIST_W_MAX || b->hist[bin] > UINT16_MAX - b->hist_w) {
+        hist_halve(b);
+    }
+    b->hist[bin] += b->hist_w;
+    b->hist_w += b->hist_w >> CALIB_HIST_GROW_SHIFT;
+}
+
+bool calib_update(calib_t *c, uint16_t target_sec, uint64_t actual_us) {
+    if (target_sec == 0) {
+        return false;
+    }
+    calib_bucket_add(&c->b[calib_bucket_of(target_sec)],
+                     calib_err_bp(actual_us, (uint64_t)target_sec * 1000000u));
+    return true;
+}
+
+// 四舍五入的 Q8 -> 整数，负数也对称
+static int32_t q8_round(int32_t v) {
+    return (v >= 0) ? (v + 128) >> 8 : -((-v + 128) >> 8);
+}
+
+static uint32_t isqrt64(uint64_t v) {
+    uint64_t r = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+int32_t calib_quantile_bp(const calib_bucket_t *b, uint16_t q_permille) {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < CALIB_HIST_BINS; ++i) {
+        total += b->hist[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint32_t want = (uint32_t)(((uint64_t)total * q_permille + 500) / 1000);
+    uint32_t cum  = 0;
+    for (uint8_t i = 0; i < CALIB_HIST_BINS; ++i) {
+        uint32_t c = b->hist[i];
+        if (c == 0 || cum + c < want) {
+            cum += c;
+            continue;
+        }
+        // 两头的开区间没有宽度，直接给边界
+        if (i == 0) {
+            return CALIB_HIST_EDGES[0];
+        }
+        if (i == CALIB_HIST_BINS - 1) {
+            return CALIB_HIST_EDGES[CALIB_HIST_BINS - 2];
+        }
+        int32_t lo = CALIB_HIST_EDGES[i - 1];
+        int32_t hi = CALIB_HIST_EDGES[i];
+        return lo + (int32_t)((int64_t)(hi - lo) * (int64_t)(want - cum) / (int64_t)c);
+    }
+    return CALIB_HIST_EDGES[CALIB_HIST_BINS - 2];
+}
+
+void calib_summary(const calib_bucket_t *b, calib_summary_t *out) {
+    out->n         = b->n;
+    out->mean_bp   = q8_round(b->mean_q8);
+    out->stddev_bp = (b->n >= 2) ? isqrt64(b->m2 / (b->n - 1)) : 0;
+    out->ew_bp     = q8_round(b->ew_q8);
+    out->p10_bp    = calib_quantile_bp(b, 100);
+    out->p50_bp    = calib_quantile_bp(b, 500);
+    out->p90_bp    = calib_quantile_bp(b, 900);
+}
@@ -0,0 +1,92 @@
+// calib.h
+// 校准统计：按目标时间分几档，每档对“停表误差”做流式统计，每次停表 O(1) 更新、内存固定，
+// 从不回头翻历史记录：
+//   - Welford 均值 / 方差：整体偏早还是偏晚、稳不稳；
+//   - 指数加权偏差：最近十来次的趋势（练着练着偏差会变）；
+//   - 滚动分位数：12 格直方图，新记录权重按 1/16 递增（等价于旧记录按同样比例衰减），
+//     权重大了整体减半，所以也是摊还 O(1)；查询时在格内线性插值出 p10 / p50 / p90。
+// 误差是相对目标的万分比（bp，0.01%），带符号，负数 = 停早了，限幅 ±100%。
+// M0+ 没有 FPU，全程整数：均值和加权偏差用 Q8。
+// 纯计算，不碰硬件；整个 calib_t 原样存进 flash（drivers/session_log.c）。
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 目标时间分档（秒，含上界）：<= 15 s / 1 min / 5 min / 20 min / 更长
+#define CALIB_BUCKET_LIST(X)   \
+    X(15)                      \
+    X(60)                      \
+    X(300)                     \
+    X(1200)                    \
+    X(UINT16_MAX)
+
+#define CALIB_COUNT_ENTRY(max_sec) +1
+#define CALIB_BUCKETS          (0 CALIB_BUCKET_LIST(CALIB_COUNT_ENTRY))
+
+// 直方图格数：两头各一个开区间，中间按 ±1% / 2% / 3% / 5% / 10% 分
+#define CALIB_HIST_BINS        12
+
+// 指数加权：ew += (x - ew) >> CALIB_EW_SHIFT，大约看最近 8 次
+#define CALIB_EW_SHIFT         3
+
+// 直方图新记录的权重每次乘 (1 + 1/16)，大约看最近 16 次
+#define CALIB_HIST_GROW_SHIFT  4
+
+#define CALIB_ERR_LIMIT_BP     10000
+
+typedef struct {
+    uint32_t n;                        // 这一档停过几次
+    int32_t  mean_q8;                  // 误差均值，bp Q8
+    uint64_t m2;                       // Welford 的平方和，bp^2
+    int32_t  ew_q8;                    // 指数加权偏差，bp Q8
+    uint16_t hist_w;                   // 下一条记录的权重
+    uint16_t hist[CALIB_HIST_BINS];
+} calib_bucket_t;
+
+typedef struct {
+    calib_bucket_t b[CALIB_BUCKETS];
+} calib_t;
+
+// 查询结果，全是 bp
+typedef struct {
+    uint32_t n;
+    int32_t  mean_bp;
+    uint32_t stddev_bp;    // 样本标准差，n < 2 时为 0
+    int32_t  ew_bp;
+    int32_t  p10_bp;
+    int32_t  p50_bp;
+    int32_t  p90_bp;
+} calib_summary_t;
+
+void calib_init(calib_t *c);
+
+// 目标时间属于哪一档
+uint8_t calib_bucket_of(uint16_t target_sec);
+
+// 每档的上界（秒），打印用
+uint16_t calib_bucket_max_sec(uint8_t bucket);
+
+// 带符号相对误差，bp，限幅 ±CALIB_ERR_LIMIT_BP
+int32_t calib_err_bp(uint64_t actual_us, uint64_t target_us);
+
+/**
+ * 记一次停表。target_sec 为 0（秒表）不算，返回 false。
+ */
+bool calib_update(calib_t *c, uint16_t target_sec, uint64_t actual_us);
+
+// 单独喂一个误差（bp）给某一档，主机基准直接用
+void calib_bucket_add(calib_bucket_t *b, int32_t err_bp);
+
+void calib_summary(const calib_bucket_t *b, calib_summary_t *out);
+
+// 直方图上的分位数，q 为千分比（500 = 中位数）
+int32_t calib_quantile_bp(const calib_bucket_t *b, uint16_t q_permille);
+
+#ifdef __cplusplus
+}
+#endif
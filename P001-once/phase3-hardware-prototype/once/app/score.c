@@ -0,0 +1,51 @@
+// score.c
+
+#include "app/score.h"
+
+// x = r / sigma 的定点格式：Q12
+#define SCORE_X_SHIFT     12
+// 查表步长 1/16，x 的低 8 位是两点之间的插值比例
+#define SCORE_TAB_SHIFT   4
+#define SCORE_FRAC_SHIFT  (SCORE_X_SHIFT - SCORE_TAB_SHIFT)
+#define SCORE_FRAC_MASK   ((1u << SCORE_FRAC_SHIFT) - 1)
+// x >= 4 时 exp(-x^2/2) < 0.00034，四舍五入已经是 0 分
+#define SCORE_X_MAX       4
+
+// exp(-x^2 / 2)，x = 0, 1/16, ..., 4，Q15（第一项本应是 32768，压到 32767 好放进 uint16_t）
+// 生成：round(32768 * exp(-0.5 * (i / 16.0)^2))
+static const uint16_t SCORE_GAUSS_Q15[(SCORE_X_MAX << SCORE_TAB_SHIFT) + 1] = {
+    32767, 32704, 32513, 32197, 31760, 31206, 30543, 29777,
+    28918, 27973, 26954, 25871, 24735, 23556, 22346, 21115,
+    19875, 18634, 17403, 16190, 15002, 13848, 12732, 11661,
+    10638,  9667,  8751,  7890,  7087,  6340,  5650,  5015,
+     4435,  3906,  3427,  2995,  2607,  2261,  1953,  1680,
+     1440,  1229,  1045,   885,   747,   628,   526,   438,
+      364,   301,   248,   204,   167,   136,   110,    89,
+       72,    57,    46,    37,    29,    23,    18,    14,
+       11,
+};
+
+uint8_t score_run(uint64_t elapsed_us, uint64_t target_us) {
+    if (target_us == 0) {
+        return SCORE_NONE;
+    }
+
+    uint64_t err_us = (elapsed_us > target_us) ? elapsed_us - target_us : target_us - elapsed_us;
+
+    // x = err / (target * sigma)；先挡掉 x >= 4，剩下的 x 放得进 32 位 Q12
+    uint64_t den = target_us * SCORE_SIGMA_PERMILLE;
+    uint64_t num = err_us * 1000u;
+    if (num >= den * SCORE_X_MAX) {
+        return 0;
+    }
+    uint32_t x = (uint32_t)((num << SCORE_X_SHIFT) / den);
+
+    uint32_t i    = x >> SCORE_FRAC_SHIFT;
+    uint32_t frac = x & SCORE_FRAC_MASK;
+    int32_t  g0   = SCORE_GAUSS_Q15[i];
+    int32_t  g1   = SCORE_GAUSS_Q15[i + 1];
+    int32_t  g    = g0 + (((g1 - g0) * (int32_t)frac) >> SCORE_FRAC_SHIFT);
+
+    // 100 * g / 32768，四舍五入；g 最大 32767，正好停在目标上也是 100
+    return (uint8_t)(((uint32_t)g * 100u + (1u << 14)) >> 15);
+}
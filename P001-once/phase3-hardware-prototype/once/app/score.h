@@ -0,0 +1,32 @@
+// score.h
+// 打分：和网页原型的 evaluate() 一样，相对误差 r = |实际 - 目标| / 目标，
+// 分数 = round(100 * exp(-0.5 * (r / 0.05)^2))，0..100，正好停在目标上 100 分，差 5% 约 61 分。
+// M0+ 没有 FPU，这里全程整数：r / 0.05 用 Q12 定点算，高斯曲线查 65 点的 Q15 表再线性插值，
+// 和双精度参考值的差不超过 1 分（host/bench_score 扫全范围验证）。
+// 纯计算，不碰硬件。
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 网页原型里的 sigma = 0.05，这里按千分比写
+#define SCORE_SIGMA_PERMILLE   50
+
+// 目标为 0（秒表）没有分数
+#define SCORE_NONE             0xffu
+
+// 网页原型 evaluate() 里 sc >= 90 才有那一下亮度脉冲（once.c 里播背光的 PULSE）
+#define SCORE_SWEET_SPOT       90
+
+/**
+ * 一次计时的分数：elapsed_us 是停下时的实际计时，target_us 是目标时间。
+ * 返回 0..100；target_us 为 0 时返回 SCORE_NONE。
+ */
+uint8_t score_run(uint64_t elapsed_us, uint64_t target_us);
+
+#ifdef __cplusplus
+}
+#endif
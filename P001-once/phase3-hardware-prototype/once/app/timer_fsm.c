@@ -0,0 +1,275 @@
+// timer_fsm.c
+// 转移表里每一格是一个动作函数：动作只改“想要的”状态和输出，
+// 显示 / 背光的副作用最后统一和旧值比一次再决定发不发。
+
+#include "app/timer_fsm.h"
+
+#include <stddef.h>
+
+#define US_PER_SEC     1000000u
+#define US_PER_TENTH   100000u
+
+typedef struct {
+    timer_fsm_t     *s;    // 正在构造的新状态
+    timer_fx_list_t *fx;
+    timer_fx_kind_t  want_kind;    // TIMER_FX_SHOW / TIMER_FX_SHOW_ELAPSED
+    uint32_t         want_show;
+    bool             want_backlight;
+} timer_ctx_t;
+
+// 返回 false = 事件被忽略
+typedef bool (*timer_action_fn)(timer_ctx_t *c, const timer_event_t *ev);
+
+static void fx_push(timer_ctx_t *c, timer_fx_kind_t kind, int32_t arg) {
+    if (c->fx->count < TIMER_FX_MAX) {
+        c->fx->fx[c->fx->count++] = (timer_fx_t){ kind, arg };
+    }
+}
+
+static void adjust_target(timer_ctx_t *c, int32_t delta) {
+    int32_t t = (int32_t)c->s->target_sec + delta;
+    if (t < 0) t = 0;
+    if (t > TIMER_FSM_MAX_SEC) t = TIMER_FSM_MAX_SEC;
+    c->s->target_sec = (uint16_t)t;
+    c->want_kind     = TIMER_FX_SHOW;
+    c->want_show     = c->s->target_sec;
+}
+
+// 计时到这么多就算完成：有目标就是目标，秒表是 3 小时
+static uint64_t run_limit_us(const timer_fsm_t *s) {
+    uint32_t sec = s->target_sec ? s->target_sec : TIMER_FSM_FREE_RUN_MAX_SEC;
+    return (uint64_t)sec * US_PER_SEC;
+}
+
+// 显示计时：按分档取整到屏上能显示的精度，精度以下的变化不产生副作用
+static void show_elapsed(timer_ctx_t *c, uint64_t elapsed_us) {
+    uint64_t tenths = elapsed_us / US_PER_TENTH;
+    switch (timer_fsm_show_fmt(c->s->tenths, elapsed_us)) {
+    case TIMER_SHOW_MSSD:
+        break;
+    case TIMER_SHOW_MMSS:
+        tenths -= tenths % 10;
+        break;
+    case TIMER_SHOW_HMM:
+        tenths -= tenths % 600;
+        break;
+    }
+    c->want_kind = TIMER_FX_SHOW_ELAPSED;
+    c->want_show = (uint32_t)tenths;
+}
+
+// 回到 SET：计时归零，背光常亮，显示目标时间
+static void enter_set(timer_ctx_t *c) {
+    c->s->state       = TIMER_STATE_SET;
+    c->s->elapsed_us  = 0;
+    c->want_backlight = true;
+    c->want_kind      = TIMER_FX_SHOW;
+    c->want_show      = c->s->target_sec;
+}
+
+// 计时到了目标：停刷新，开始闪烁
+static void enter_done(timer_ctx_t *c) {
+    c->s->elapsed_us  = run_limit_us(c->s);
+    c->s->state       = TIMER_STATE_DONE;
+    c->want_backlight = true;
+    show_elapsed(c, c->s->elapsed_us);
+    fx_push(c, TIMER_FX_TICK_STOP, 0);
+    fx_push(c, TIMER_FX_BLINK_START, 0);
+}
+
+// 从 elapsed_us 起继续计时：刷新都落在 origin_us 的整周期上，暂停时的零头不丢
+static void run_from(timer_ctx_t *c, uint64_t t_us) {
+    uint32_t tick = timer_fsm_tick_us(c->s);
+    c->s->state     = TIMER_STATE_RUNNING;
+    c->s->origin_us = t_us - c->s->elapsed_us;
+    fx_push(c, TIMER_FX_TICK_START, (int32_t)(tick - c->s->elapsed_us % tick));
+}
+
+// ---------- 动作 ----------
+
+static bool act_ignore(timer_ctx_t *c, const timer_event_t *ev) {
+    (void)c;
+    (void)ev;
+    return false;
+}
+
+// SET --key--> RUNNING，从按键的时间戳起算
+static bool act_start(timer_ctx_t *c, const timer_event_t *ev) {
+    c->s->elapsed_us  = 0;
+    c->want_backlight = true;
+    show_elapsed(c, 0);
+    run_from(c, ev->t_us);
+    return true;
+}
+
+// SET --rotate--> SET
+static bool act_adjust(timer_ctx_t *c, const timer_event_t *ev) {
+    adjust_target(c, ev->arg);
+    return true;
+}
+
+// RUNNING --key--> PAUSED，按按键的时间戳结算到 us。
+// 按键和刷新前后脚时，刷新可能还没来得及处理（或者反过来），显示以时间戳为准
+static bool act_pause(timer_ctx_t *c, const timer_event_t *ev) {
+    uint64_t run_us = timer_fsm_elapsed_us(c->s, ev->t_us);
+    if (run_us >= run_limit_us(c->s)) {
+        enter_done(c);
+        return true;
+    }
+    c->s->elapsed_us  = run_us;
+    c->s->state       = TIMER_STATE_PAUSED;
+    c->want_backlight = true;
+    show_elapsed(c, run_us);
+    fx_push(c, TIMER_FX_TICK_STOP, 0);
+    return true;
+}
+
+// RUNNING --tick--> RUNNING / DONE，计时由到点的理论时刻算出
+static bool act_tick(timer_ctx_t *c, const timer_event_t *ev) {
+    uint64_t run_us = timer_fsm_elapsed_us(c->s, ev->t_us);
+    if (run_us >= run_limit_us(c->s)) {
+        enter_done(c);
+    } else {
+        show_elapsed(c, run_us);
+    }
+    return true;
+}
+
+// PAUSED --key--> RUNNING，接着暂停时没走完的那一格继续数
+static bool act_resume(timer_ctx_t *c, const timer_event_t *ev) {
+    c->want_backlight = true;
+    run_from(c, ev->t_us);
+    return true;
+}
+
+// PAUSED --rotate--> SET，基于原目标时间调整
+static bool act_paused_adjust(timer_ctx_t *c, const timer_event_t *ev) {
+    enter_set(c);
+    adjust_target(c, ev->arg);
+    return true;
+}
+
+// DONE --key--> SET，停止闪烁
+static bool act_reset(timer_ctx_t *c, const timer_event_t *ev) {
+    (void)ev;
+    fx_push(c, TIMER_FX_BLINK_STOP, 0);
+    enter_set(c);
+    return true;
+}
+
+// DONE --rotate--> SET，停止闪烁并按这一格调整
+static bool act_done_adjust(timer_ctx_t *c, const timer_event_t *ev) {
+    fx_push(c, TIMER_FX_BLINK_STOP, 0);
+    enter_set(c);
+    adjust_target(c, ev->arg);
+    return true;
+}
+
+// DONE --blink--> DONE
+static bool act_blink(timer_ctx_t *c, const timer_event_t *ev) {
+    (void)ev;
+    c->want_backlight = !c->want_backlight;
+    return true;
+}
+
+// ---------- 转移表 ----------
+
+static const timer_action_fn TIMER_TABLE[TIMER_STATE_COUNT][TIMER_EV_COUNT] = {
+    //                        KEY          ROTATE             TICK        BLINK
+    [TIMER_STATE_SET]     = { act_start,   act_adjust,        act_ignore, act_ignore },
+    [TIMER_STATE_RUNNING] = { act_pause,   act_ignore,        act_tick,   act_ignore },
+    [TIMER_STATE_PAUSED]  = { act_resume,  act_paused_adjust, act_ignore, act_ignore },
+    [TIMER_STATE_DONE]    = { act_reset,   act_done_adjust,   act_ignore, act_blink  },
+};
+
+static const char *const TIMER_STATE_NAMES[TIMER_STATE_COUNT] = {
+    "SET",
+    "RUNNING",
+    "PAUSED",
+    "DONE",
+};
+
+// ---------- 对外接口 ----------
+
+void timer_fsm_init(timer_fsm_t *fsm) {
+    fsm->state        = TIMER_STATE_SET;
+    fsm->target_sec   = 0;
+    fsm->tenths       = false;
+    fsm->elapsed_us   = 0;
+    fsm->origin_us    = 0;
+    fsm->shown_kind   = TIMER_FX_SHOW;
+    fsm->shown        = 0;
+    fsm->backlight_on = true;
+}
+
+bool timer_fsm_step(const timer_fsm_t *in, const timer_event_t *ev,
+                    timer_fsm_t *out, timer_fx_list_t *fx) {
+    fx->count = 0;
+    if (in->state >= TIMER_STATE_COUNT || ev->kind >= TIMER_EV_COUNT) {
+        if (out != in) {
+            *out = *in;
+        }
+        return false;
+    }
+
+    timer_fsm_t next = *in;
+    timer_ctx_t c = {
+        .s              = &next,
+        .fx             = fx,
+        .want_kind      = in->shown_kind,
+        .want_show      = in->shown,
+        .want_backlight = in->backlight_on,
+    };
+
+    if (!TIMER_TABLE[in->state][ev->kind](&c, ev)) {
+        fx->count = 0;
+        if (out != in) {
+            *out = *in;
+        }
+        return false;
+    }
+
+    // 输出去重：同一个事件里先后要求的多次显示只留最后一次，值没变就不发
+    if (c.want_kind != in->shown_kind || c.want_show != in->shown) {
+        fx_push(&c, c.want_kind, (int32_t)c.want_show);
+        next.shown_kind = c.want_kind;
+        next.shown      = c.want_show;
+    }
+    if (c.want_backlight != in->backlight_on) {
+        fx_push(&c, TIMER_FX_BACKLIGHT, c.want_backlight ? 1 : 0);
+        next.backlight_on = c.want_backlight;
+    }
+
+    *out = next;
+    return true;
+}
+
+void timer_fsm_set_tenths(timer_fsm_t *fsm, bool tenths) {
+    fsm->tenths = tenths;
+}
+
+uint32_t timer_fsm_tick_us(const timer_fsm_t *fsm) {
+    return fsm->tenths ? US_PER_TENTH : US_PER_SEC;
+}
+
+uint64_t timer_fsm_elapsed_us(const timer_fsm_t *fsm, uint64_t now_us) {
+    if (fsm->state != TIMER_STATE_RUNNING) {
+        return fsm->elapsed_us;
+    }
+    return (now_us > fsm->origin_us) ? now_us - fsm->origin_us : 0;
+}
+
+timer_show_fmt_t timer_fsm_show_fmt(bool tenths, uint64_t elapsed_us) {
+    if (tenths && elapsed_us < TIMER_SHOW_TENTHS_BELOW_US) {
+        return TIMER_SHOW_MSSD;
+    }
+    return (elapsed_us < TIMER_SHOW_MMSS_BELOW_US) ? TIMER_SHOW_MMSS : TIMER_SHOW_HMM;
+}
+
+bool timer_fsm_rotate_adjusts(const timer_fsm_t *fsm) {
+    return fsm->state != TIMER_STATE_RUNNING;
+}
+
+const char *timer_fsm_state_name(timer_state_t state) {
+    return (state < TIMER_STATE_COUNT) ? TIMER_STATE_NAMES[state] : "?";
+}
@@ -0,0 +1,122 @@
+// timer_fsm.h
+// 计时器状态机：SET / RUNNING / PAUSED / DONE。
+// 纯函数 + 显式转移表：输入“当前状态 + 一个事件”，输出“新状态 + 要做的副作用列表”，
+// 不碰硬件、不分配内存，主机上可以单独跑、单独测每个事件的开销。
+// 显示和背光按“值有没有变”去重，只有真的变了才产生副作用。
+// 计时是 64 位 us：按开始 / 暂停 / 到点事件的时间戳相减得出，不靠数秒跳。
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 目标时间上限：四位数码管只能显示 59:59
+#define TIMER_FSM_MAX_SEC   (59 * 60 + 59)
+
+// 目标为 0 时当秒表用，最长 3 小时（和桌面版一致）
+#define TIMER_FSM_FREE_RUN_MAX_SEC  (3 * 3600)
+
+// 计时显示的分档：不到 10 分钟可以带 0.1 s（M.SS.d），不到 1 小时 MM:SS，再往上 H:MM
+#define TIMER_SHOW_TENTHS_BELOW_US  (10ull * 60 * 1000000)
+#define TIMER_SHOW_MMSS_BELOW_US    (60ull * 60 * 1000000)
+
+typedef enum {
+    TIMER_SHOW_MSSD = 0,      // M.SS.d
+    TIMER_SHOW_MMSS,          // MM:SS
+    TIMER_SHOW_HMM,           // H:MM
+} timer_show_fmt_t;
+
+typedef enum {
+    TIMER_STATE_SET = 0,      // 设定目标时间
+    TIMER_STATE_RUNNING,      // 正在计时
+    TIMER_STATE_PAUSED,       // 暂停在中途某个时间
+    TIMER_STATE_DONE,         // 计时完成，闪烁背光
+    TIMER_STATE_COUNT
+} timer_state_t;
+
+typedef enum {
+    TIMER_EV_KEY = 0,         // 按键
+    TIMER_EV_ROTATE,          // 旋钮，arg = 目标时间增量（秒，带符号）
+    TIMER_EV_TICK,            // 刷新计时到点（每秒，或显示 0.1 s 时每 100 ms）
+    TIMER_EV_BLINK,           // 闪烁翻转到点
+    TIMER_EV_COUNT
+} timer_event_kind_t;
+
+typedef struct {
+    timer_event_kind_t kind;
+    int32_t            arg;
+    uint64_t           t_us;  // 事件时刻（按键 / 旋钮的检测时刻，或秒跳的理论时刻）
+} timer_event_t;
+
+typedef enum {
+    TIMER_FX_SHOW = 0,        // 显示目标时间 arg 秒（MM:SS）
+    TIMER_FX_SHOW_ELAPSED,    // 显示计时，arg 单位 0.1 s，已经按分档取整（格式见 timer_fsm_show_fmt）
+    TIMER_FX_BACKLIGHT,       // arg = 1 亮 / 0 灭
+    TIMER_FX_TICK_START,      // 从事件时刻起 arg us 后第一跳，之后每 timer_fsm_tick_us() 一跳
+    TIMER_FX_TICK_STOP,
+    TIMER_FX_BLINK_START,     // 从事件时刻起闪烁
+    TIMER_FX_BLINK_STOP,
+} timer_fx_kind_t;
+
+typedef struct {
+    timer_fx_kind_t kind;
+    int32_t         arg;
+} timer_fx_t;
+
+// 单个事件最多产生的副作用数：停秒跳 + 开闪烁 + 显示 + 背光
+#define TIMER_FX_MAX  4
+
+typedef struct {
+    uint8_t    count;
+    timer_fx_t fx[TIMER_FX_MAX];
+} timer_fx_list_t;
+
+typedef struct {
+    timer_state_t state;
+    uint16_t      target_sec;    // 目标时间，0 = 秒表
+    bool          tenths;        // 计时显示到 0.1 s，刷新 10 Hz
+    uint64_t      elapsed_us;    // 已经计时：暂停 / 完成时按事件时间戳结算，RUNNING 时不更新
+    uint64_t      origin_us;     // RUNNING 时：计时为 0 对应的时刻，计时 = t - origin_us
+    // 当前已经输出到硬件上的值，用来给副作用去重
+    timer_fx_kind_t shown_kind;  // TIMER_FX_SHOW 或 TIMER_FX_SHOW_ELAPSED
+    uint32_t      shown;         // 对应副作用的 arg
+    bool          backlight_on;
+} timer_fsm_t;
+
+/**
+ * 初始状态：SET、目标 0。认为屏上已经是 00:00、背光亮着（开机流程会先做好）。
+ */
+void timer_fsm_init(timer_fsm_t *fsm);
+
+/**
+ * 计时显示到 0.1 s（刷新 10 Hz）还是整秒（1 Hz）。在 SET 状态下设。
+ */
+void timer_fsm_set_tenths(timer_fsm_t *fsm, bool tenths);
+
+// 刷新计时的周期（TIMER_FX_TICK_START 之后的间隔）
+uint32_t timer_fsm_tick_us(const timer_fsm_t *fsm);
+
+// now_us 时刻的计时：RUNNING 时现算，其余状态是结算好的值
+uint64_t timer_fsm_elapsed_us(const timer_fsm_t *fsm, uint64_t now_us);
+
+// 计时 elapsed_us 该用哪种格式显示
+timer_show_fmt_t timer_fsm_show_fmt(bool tenths, uint64_t elapsed_us);
+
+/**
+ * 处理一个事件：in 不变，结果写进 out（可以和 in 是同一个），副作用写进 fx。
+ * 返回 false 表示这个事件在当前状态下没有意义（状态和输出都不变，fx 为空）。
+ */
+bool timer_fsm_step(const timer_fsm_t *in, const timer_event_t *ev,
+                    timer_fsm_t *out, timer_fx_list_t *fx);
+
+// 当前状态下拧旋钮会不会改目标时间（RUNNING 时不会），调用方据此决定要不要算加速
+bool timer_fsm_rotate_adjusts(const timer_fsm_t *fsm);
+
+const char *timer_fsm_state_name(timer_state_t state);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,220 @@
+// bench_kernels.c
+
+#include "bench/bench_kernels.h"
+#include "drivers/board.h"
+#include "drivers/lcd_pcf8576.h"
+#include "drivers/encoder_ec11.h"
+#include "app/timer_fsm.h"
+#include "app/accel.h"
+#include "app/score.h"
+#include "app/calib.h"
+#include "bench/fsm_script.h"
+
+#include "pico/stdlib.h"
+
+#if !ONCE_HOST
+#include "hardware/structs/xip_ctrl.h"
+#endif
+
+#if !ONCE_BENCH
+#error "bench_kernels.c 要和 ONCE_BENCH=1 一起编（驱动里的基准入口）"
+#endif
+
+// 输入：事先生成好，计时只算内核本身；个数是 2 的幂，循环着用
+#define BENCH_INPUTS   256
+#define BENCH_MASK     (BENCH_INPUTS - 1)
+
+// 每个内核的结果都往这里加一下，编译器不能把整个循环优化掉
+static volatile uint32_t bench_sink;
+
+static timer_event_t bench_fsm_events[FSM_SCRIPT_LEN];
+static bool          bench_fsm_ok;    // 剧本一圈真的走遍了四个状态、出了背光副作用
+static uint64_t      bench_run_us[BENCH_INPUTS];
+static uint16_t      bench_target_sec[BENCH_INPUTS];
+
+static uint32_t rng_state = 0x12345678u;
+
+static uint32_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+#define BENCH_NAME_ENTRY(id, name, ops) name,
+#define BENCH_OPS_ENTRY(id, name, ops)  ops,
+
+static const char *const BENCH_NAMES[BENCH_KERNEL_COUNT] = {
+    BENCH_KERNEL_LIST(BENCH_NAME_ENTRY)
+};
+
+static const uint32_t BENCH_OPS[BENCH_KERNEL_COUNT] = {
+    BENCH_KERNEL_LIST(BENCH_OPS_ENTRY)
+};
+
+const char *bench_kernel_name(bench_kernel_t k) {
+    return BENCH_NAMES[k];
+}
+
+uint32_t bench_kernel_ops(bench_kernel_t k) {
+    return BENCH_OPS[k];
+}
+
+void bench_kernels_init(void) {
+    lcd_pcf8576_init();
+    lcd_pcf8576_show_time_mmss(0, 0);
+    lcd_backlight_on();
+    Encoder_Init();
+
+    // 状态机：和 host/bench_timer_fsm.c 同一个剧本，先空跑一圈确认每个状态都走到了
+    timer_fsm_t fsm;
+    timer_fx_list_t fx;
+    uint32_t seen = 0;
+    bool backlight = false;
+    timer_fsm_init(&fsm);
+    for (uint32_t k = 0; k < FSM_SCRIPT_LEN; ++k) {
+        bench_fsm_events[k] = fsm_script_event(k, 0);
+        seen |= 1u << fsm.state;
+        timer_fsm_step(&fsm, &bench_fsm_events[k], &fsm, &fx);
+        for (uint8_t j = 0; j < fx.count; ++j) {
+            backlight |= (fx.fx[j].kind == TIMER_FX_BACKLIGHT);
+        }
+    }
+    bench_fsm_ok = (seen == (1u << TIMER_STATE_COUNT) - 1u) && backlight && fsm.state == TIMER_STATE_SET;
+
+    for (uint32_t i = 0; i < BENCH_INPUTS; ++i) {
+        uint32_t r = rng_next();
+
+        // 停表：目标 1 s .. 1 h，实际差 ±10 %
+        bench_target_sec[i] = (uint16_t)(1u + (r >> 4) % 3600u);
+        uint64_t target_us  = (uint64_t)bench_target_sec[i] * 1000000u;
+        bench_run_us[i]     = target_us - target_us / 10u + (uint64_t)(rng_next() % 1000u) * (target_us / 5000u);
+    }
+}
+
+// 整帧同步写：每次先让显存影子失效，保证 5 个字节都真的上总线（同 lcd_pcf8576_bus_report）
+static bool bench_lcd_frame(lcd_bus_kind_t kind, uint32_t n) {
+    bool ok = lcd_pcf8576_set_bus(kind) || kind == LCD_BUS_BITBANG;
+    if (ok) {
+        for (uint32_t i = 0; i < n; ++i) {
+            lcd_pcf8576_invalidate();
+            lcd_pcf8576_show_time_mmss(12, 34);
+        }
+    }
+    lcd_pcf8576_set_bus(LCD_BUS_DEFAULT);
+    return ok;
+}
+
+// 内容没变的异步提交：影子比对以后一个字节都不发，量的是每次秒跳的固定开销
+static void bench_lcd_same(uint32_t n) {
+    lcd_pcf8576_show_time_mmss(12, 34);
+    for (uint32_t i = 0; i < n; ++i) {
+        lcd_pcf8576_submit_mmss(12, 34);
+    }
+    lcd_pcf8576_wait_idle();
+}
+
+static void bench_enc_sample(uint32_t n) {
+    for (uint32_t i = 0; i < n; ++i) {
+        Encoder_BenchSample();
+    }
+}
+
+// 每次采样前先清掉 XIP cache：热路径在 flash 里（ONCE_RAM_HOT=0）时每次都要从 QSPI 重新取指，
+// 在 SRAM 里时只剩清 cache 本身和这个循环的开销。两种构建的结果对比着看；主机上没有 cache，和上一个一样
+static void bench_enc_cold(uint32_t n) {
+    for (uint32_t i = 0; i < n; ++i) {
+#if !ONCE_HOST
+        xip_ctrl_hw->flush = 1;
+        (void)xip_ctrl_hw->flush;   // 读会等到清完
+#endif
+        Encoder_BenchSample();
+    }
+}
+
+// 一次操作 = 塞一个事件 + 取走一个事件；事件环 64 格，一批 32 个不会满
+static void bench_enc_drain(uint32_t n) {
+    encoder_event_t evs[32];
+    uint32_t done = 0;
+    while (done < n) {
+        uint32_t batch = (n - done < 32u) ? n - done : 32u;
+        for (uint32_t i = 0; i < batch; ++i) {
+            Encoder_BenchPush(cw, done + i);
+        }
+        bench_sink += (uint32_t)Encoder_ReadEvents(evs, batch);
+        done += batch;
+    }
+}
+
+// 一圈剧本反复喂：每圈回到 SET、目标 0，圈内时刻可以原样重用
+static bool bench_fsm_step(uint32_t n) {
+    if (!bench_fsm_ok) {
+        return false;
+    }
+    timer_fsm_t fsm;
+    timer_fx_list_t fx;
+    timer_fsm_init(&fsm);
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        timer_fsm_step(&fsm, &bench_fsm_events[k], &fsm, &fx);
+        bench_sink += fx.count;
+        if (++k == FSM_SCRIPT_LEN) {
+            k = 0;
+        }
+    }
+    return true;
+}
+
+// 一直往一个方向拧，每格 20 ms（够快，会走到吸附），每 256 格停一下重新开始
+static void bench_accel_step(uint32_t n) {
+    accel_t a;
+    accel_reset(&a);
+    uint16_t target = 0;
+    uint64_t t = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        if ((i & BENCH_MASK) == 0) {
+            target = 0;
+            t += 1000000u;
+        }
+        t += 20000u;
+        int32_t d = accel_step(&a, &ACCEL_CURVE_DEFAULT, +1, t, target);
+        target = (uint16_t)((int32_t)target + d > TIMER_FSM_MAX_SEC ? 0 : (int32_t)target + d);
+    }
+    bench_sink += target;
+}
+
+static void bench_score_run(uint32_t n) {
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        uint32_t k = i & BENCH_MASK;
+        sum += score_run(bench_run_us[k], (uint64_t)bench_target_sec[k] * 1000000u);
+    }
+    bench_sink += sum;
+}
+
+static void bench_calib_update(uint32_t n) {
+    static calib_t c;
+    calib_init(&c);
+    for (uint32_t i = 0; i < n; ++i) {
+        uint32_t k = i & BENCH_MASK;
+        calib_update(&c, bench_target_sec[k], bench_run_us[k]);
+    }
+    bench_sink += c.b[0].n;
+}
+
+bool bench_kernel_run(bench_kernel_t k, uint32_t n) {
+    switch (k) {
+    case BENCH_LCD_HW_I2C:   return bench_lcd_frame(LCD_BUS_HW_I2C, n);
+    case BENCH_LCD_PIO:      return bench_lcd_frame(LCD_BUS_PIO, n);
+    case BENCH_LCD_BITBANG:  return bench_lcd_frame(LCD_BUS_BITBANG, n);
+    case BENCH_LCD_SAME:     bench_lcd_same(n);     return true;
+    case BENCH_ENC_SAMPLE:   bench_enc_sample(n);   return true;
+    case BENCH_ENC_COLD:     bench_enc_cold(n);     return true;
+    case BENCH_ENC_DRAIN:    bench_enc_drain(n);    return true;
+    case BENCH_FSM_STEP:     return bench_fsm_step(n);
+    case BENCH_ACCEL_STEP:   bench_accel_step(n);   return true;
+    case BENCH_SCORE_RUN:    bench_score_run(n);    return true;
+    case BENCH_CALIB_UPDATE: bench_calib_update(n); return true;
+    default:                 return false;
+    }
+}
@@ -0,0 +1,50 @@
+// bench_kernels.h
+// 微基准的内核：板子上（once_bench.uf2）和主机上（once_bench_host）编的是同一份。
+// 每个内核做 n 次“操作”（写一帧、采一次样、走一步状态机……），不自己计时，
+// 由 once_bench.c 统一掐表、倍增 n 直到够长、取多次里最快的一次。
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 内核：X(名字, 打印用的名字, 第一次试的操作数)，打印用的名字就是结果里的键，改了旧结果就对不上了
+#define BENCH_KERNEL_LIST(X)                            \
+    X(LCD_HW_I2C,   "lcd_frame_hw_i2c",    16)          \
+    X(LCD_PIO,      "lcd_frame_pio",       16)          \
+    X(LCD_BITBANG,  "lcd_frame_bitbang",   16)          \
+    X(LCD_SAME,     "lcd_submit_same",     256)         \
+    X(ENC_SAMPLE,   "enc_sample_step",     1024)        \
+    X(ENC_COLD,     "enc_sample_cold",     256)         \
+    X(ENC_DRAIN,    "enc_push_drain",      1024)        \
+    X(FSM_STEP,     "fsm_step",            1024)        \
+    X(ACCEL_STEP,   "accel_step",          1024)        \
+    X(SCORE_RUN,    "score_run",           1024)        \
+    X(CALIB_UPDATE, "calib_update",        1024)
+
+#define BENCH_ENUM_ENTRY(id, name, ops) BENCH_##id,
+
+typedef enum {
+    BENCH_KERNEL_LIST(BENCH_ENUM_ENTRY)
+    BENCH_KERNEL_COUNT
+} bench_kernel_t;
+
+/**
+ * LCD、编码器初始化，生成各内核的输入。最先调一次。
+ */
+void bench_kernels_init(void);
+
+const char *bench_kernel_name(bench_kernel_t k);
+uint32_t bench_kernel_ops(bench_kernel_t k);
+
+/**
+ * 跑 n 次操作。这个内核在当前构建里用不了（例如主机上没有硬件 I2C）返回 false。
+ */
+bool bench_kernel_run(bench_kernel_t k, uint32_t n);
+
+#ifdef __cplusplus
+}
+#endif
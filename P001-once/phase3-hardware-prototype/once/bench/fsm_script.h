@@ -0,0 +1,42 @@
+// fsm_script.h
+// 状态机基准的事件流：按固定剧本走一圈 SET -> RUNNING -> PAUSED -> RUNNING -> DONE（闪烁）-> SET，
+// 每种转移和背光去重都真的走到。随机事件流到不了 DONE：按键太密，秒跳还没攒够目标时间就被打断。
+// 一圈从 SET、目标 0 开始，也回到 SET、目标 0，时刻只在圈内有意义（SET 里按键重新起算），
+// 所以同一圈可以原样反复喂。host/bench_timer_fsm.c 和 bench/bench_kernels.c 共用。
+#pragma once
+
+#include <stdint.h>
+
+#include "app/timer_fsm.h"
+
+typedef struct {
+    uint32_t           t_ms;   // 圈内时刻
+    timer_event_kind_t kind;
+    int32_t            arg;
+} fsm_script_step_t;
+
+static const fsm_script_step_t FSM_SCRIPT[] = {
+    {    0, TIMER_EV_ROTATE, +3 },   // SET：目标 3 s
+    {  200, TIMER_EV_KEY,     0 },   // -> RUNNING
+    {  700, TIMER_EV_ROTATE, +1 },   // RUNNING 里拧旋钮：忽略
+    { 1200, TIMER_EV_TICK,    0 },
+    { 2200, TIMER_EV_TICK,    0 },
+    { 2700, TIMER_EV_KEY,     0 },   // -> PAUSED，2.5 s
+    { 3200, TIMER_EV_KEY,     0 },   // -> RUNNING
+    { 3700, TIMER_EV_TICK,    0 },   // 3.0 s：-> DONE，开始闪烁
+    { 4000, TIMER_EV_BLINK,   0 },   // 灭
+    { 4300, TIMER_EV_BLINK,   0 },   // 亮
+    { 4600, TIMER_EV_BLINK,   0 },   // 灭
+    { 4700, TIMER_EV_TICK,    0 },   // DONE 里的秒跳：忽略
+    { 5000, TIMER_EV_KEY,     0 },   // -> SET，停闪烁、背光亮
+    { 5500, TIMER_EV_ROTATE, -3 },   // 目标回到 0
+};
+
+#define FSM_SCRIPT_LEN     (sizeof(FSM_SCRIPT) / sizeof(FSM_SCRIPT[0]))
+#define FSM_SCRIPT_SPAN_MS 6000u     // 一圈的长度，连着喂多圈时每圈往后挪这么多
+
+static inline timer_event_t fsm_script_event(uint32_t k, uint64_t base_us) {
+    const fsm_script_step_t *s = &FSM_SCRIPT[k];
+    timer_event_t e = { s->kind, s->arg, base_us + (uint64_t)s->t_ms * 1000u };
+    return e;
+}
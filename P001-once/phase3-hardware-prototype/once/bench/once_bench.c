@@ -0,0 +1,120 @@
+// once_bench.c
+// 微基准入口：板子上是单独的 once_bench.uf2（USB 串口出结果），主机上是 once_bench_host。
+// 每个内核先倍增操作数直到一轮跑够 BENCH_MIN_REP_NS，再跑 BENCH_REPS 轮，取最快和中位数。
+//
+// 输出一行一个内核，主机上的 bench_compare 直接比两次的结果：
+//   [BENCH] once_bench platform=rp2040 clk_sys_khz=125000 image=flash ram_hot=1
+//   #B lcd_frame_hw_i2c     ops=64      min_ns=  412345.0  med_ns=  412400.2
+//   #B lcd_frame_pio        unavailable
+//   [BENCH] done
+// 板子上跑完以后串口发 r 再跑一遍。
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+
+#include "bench/bench_kernels.h"
+#include "drivers/board.h"
+
+#if ONCE_HOST
+#include <time.h>
+#endif
+
+#define BENCH_REPS          5
+#define BENCH_MIN_REP_NS    20000000ull     // 一轮至少 20 ms，定时器 1 us 的分辨率就不算什么了
+#define BENCH_MAX_OPS       (1u << 24)
+#define BENCH_USB_WAIT_MS   5000            // 板子上等主机打开串口，免得表头丢了
+
+#if ONCE_HOST
+#define BENCH_PLATFORM      "host"
+#else
+#define BENCH_PLATFORM      "rp2040"
+#endif
+
+// 整个程序拷进 SRAM 跑（CMake 的 ONCE_COPY_TO_RAM）还是在 flash 里就地执行
+#if defined(PICO_COPY_TO_RAM) && PICO_COPY_TO_RAM
+#define BENCH_IMAGE         "copy_to_ram"
+#else
+#define BENCH_IMAGE         "flash"
+#endif
+
+// 板子上用硬件定时器（1 us），主机上用墙钟：仿真的虚拟时钟量不出真正的耗时
+static uint64_t bench_now_ns(void) {
+#if ONCE_HOST
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ull + (uint64_t)t.tv_nsec;
+#else
+    return time_us_64() * 1000u;
+#endif
+}
+
+static uint64_t bench_rep(bench_kernel_t k, uint32_t n, bool *ok) {
+    uint64_t t0 = bench_now_ns();
+    *ok = bench_kernel_run(k, n);
+    return bench_now_ns() - t0;
+}
+
+static void bench_one(bench_kernel_t k) {
+    const char *name = bench_kernel_name(k);
+    uint32_t n = bench_kernel_ops(k);
+    bool ok;
+
+    // 先热一轮（cache / XIP），顺便看这个内核能不能跑
+    uint64_t ns = bench_rep(k, n, &ok);
+    if (!ok) {
+        printf("#B %-20s unavailable\n", name);
+        return;
+    }
+    while (ns < BENCH_MIN_REP_NS && n < BENCH_MAX_OPS) {
+        n *= 2;
+        ns = bench_rep(k, n, &ok);
+    }
+
+    uint64_t reps[BENCH_REPS];
+    for (int i = 0; i < BENCH_REPS; ++i) {
+        uint64_t r = bench_rep(k, n, &ok);
+        // 插入排序，最后 reps[0] 最快、reps[BENCH_REPS / 2] 是中位数
+        int j = i;
+        while (j > 0 && reps[j - 1] > r) {
+            reps[j] = reps[j - 1];
+            j--;
+        }
+        reps[j] = r;
+    }
+
+    printf("#B %-20s ops=%-8lu min_ns=%10.1f  med_ns=%10.1f\n", name, (unsigned long)n,
+           (double)reps[0] / (double)n, (double)reps[BENCH_REPS / 2] / (double)n);
+}
+
+static void bench_all(void) {
+    printf("[BENCH] once_bench platform=%s clk_sys_khz=%lu image=%s ram_hot=%d\n", BENCH_PLATFORM,
+           (unsigned long)(clock_get_hz(clk_sys) / 1000u), BENCH_IMAGE, ONCE_RAM_HOT);
+    for (int k = 0; k < BENCH_KERNEL_COUNT; ++k) {
+        bench_one((bench_kernel_t)k);
+    }
+    printf("[BENCH] done\n");
+}
+
+int main(void) {
+    stdio_init_all();
+#if !ONCE_HOST && defined(LIB_PICO_STDIO_USB)
+    for (int i = 0; i < BENCH_USB_WAIT_MS / 10 && !stdio_usb_connected(); ++i) {
+        sleep_ms(10);
+    }
+#endif
+
+    bench_kernels_init();
+    bench_all();
+
+#if ONCE_HOST
+    return 0;
+#else
+    while (true) {
+        if (getchar_timeout_us(100000) == 'r') {
+            bench_all();
+        }
+    }
+#endif
+}
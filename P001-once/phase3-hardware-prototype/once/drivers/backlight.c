@@ -0,0 +1,275 @@
+// backlight.c
+// PWM 背光和图案播放，见 backlight.h。
+
+#include "drivers/backlight.h"
+
+#if ONCE_BL_PWM
+
+#include "drivers/instr.h"
+
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+// 计数上限：亮度 255 的平方是 65025，比它大一，所以 255 = 一直是高、0 = 一直是低。
+// 125 MHz 不分频约 1.9 kHz，降到 48 MHz 也有 740 Hz，都看不出闪
+#define BL_PWM_TOP       65024u
+
+#define BL_ON            LCD_BL_LEVEL_ON
+#define BL_FADE_FLOOR    16u      // 开机渐亮的起点：很暗，但第一帧一写完就能看见
+
+// 一步：先保持上一步的亮度 hold_ms，再在 ramp_ms 里线性变到 level（0 = 直接跳）。
+// ramp_ms 别超过 8000，中断里的插值是 32 位乘法
+typedef struct {
+    uint16_t hold_ms;
+    uint16_t ramp_ms;
+    uint8_t  level;
+} bl_step_t;
+
+typedef struct {
+    const bl_step_t *steps;
+    uint8_t          n;
+    bool             loop;       // 循环的图案每一圈的总时长不能是 0
+} bl_pattern_t;
+
+// DONE：和原来主循环翻转的节奏一样，亮 300 ms、灭 300 ms
+static const bl_step_t BL_BLINK[] = {
+    { 300, 0, 0 },
+    { 300, 0, BL_ON },
+};
+
+// 呼吸：1.2 s 暗下去、1.2 s 亮回来，两头各停 200 ms
+static const bl_step_t BL_BREATHE[] = {
+    { 200, 1200, BL_ON / 8 },
+    { 200, 1200, BL_ON },
+};
+
+// 开机：先跳到很暗，400 ms 渐亮到平时的亮度
+static const bl_step_t BL_FADE_IN[] = {
+    { 0, 0,   BL_FADE_FLOOR },
+    { 0, 400, BL_ON },
+};
+
+// 高分：网页原型 evaluate() 里 420 ms 的 1.0 -> 1.2 -> 1.0；上去快、下来慢，近似它的 ease-out
+static const bl_step_t BL_PULSE[] = {
+    { 0, 140, BACKLIGHT_LEVEL_MAX },
+    { 0, 280, BL_ON },
+};
+
+#define BL_PATTERN(steps, loop)  { steps, (uint8_t)(sizeof(steps) / sizeof(steps[0])), loop }
+
+static const bl_pattern_t BL_PATTERNS[BACKLIGHT_PATTERN_COUNT] = {
+    [BACKLIGHT_BLINK]   = BL_PATTERN(BL_BLINK,   true),
+    [BACKLIGHT_BREATHE] = BL_PATTERN(BL_BREATHE, true),
+    [BACKLIGHT_FADE_IN] = BL_PATTERN(BL_FADE_IN, false),
+    [BACKLIGHT_PULSE]   = BL_PATTERN(BL_PULSE,   false),
+};
+
+#define BACKLIGHT_NAME_ENTRY(id, name) name,
+static const char *const BL_PATTERN_NAMES[BACKLIGHT_PATTERN_COUNT] = {
+    BACKLIGHT_PATTERN_LIST(BACKLIGHT_NAME_ENTRY)
+};
+
+static uint bl_slice;
+static uint bl_chan;
+
+// 播放状态：回绕中断和 backlight_set/play 都会改，后者关中断改
+static const bl_pattern_t *volatile bl_pat = NULL;   // NULL = 没在播
+static uint8_t           bl_step;
+static uint32_t          bl_step_t0;    // 这一步开始的时刻（time_us_32）
+static uint8_t           bl_from;       // 这一步开始时的亮度
+static volatile uint8_t  bl_level;
+static alarm_id_t        bl_alarm = 0;  // 保持段结束时叫醒回绕中断的 alarm，0 = 没挂
+static backlight_stats_t bl_stats;
+
+// bl_advance 的结果：此刻在哪种段上
+typedef enum {
+    BL_AT_HOLD = 0,   // 亮度不变，到 *hold_end 之前不用管
+    BL_AT_RAMP,       // 渐变中，每个 PWM 周期都要算
+    BL_AT_END,        // 不循环的图案播完了
+} bl_phase_t;
+
+static void ONCE_HOT_FUNC(bl_write)(uint8_t level) {
+    if (level == bl_level) {
+        return;
+    }
+    bl_level = level;
+    bl_stats.level_writes++;
+    pwm_set_chan_level(bl_slice, bl_chan, (uint16_t)((uint32_t)level * level));
+}
+
+static void ONCE_HOT_FUNC(bl_cancel_alarm)(void) {
+    if (bl_alarm > 0) {
+        cancel_alarm(bl_alarm);
+        bl_alarm = 0;
+    }
+}
+
+static void ONCE_HOT_FUNC(bl_stop)(void) {
+    bl_pat = NULL;
+    pwm_set_irq_enabled(bl_slice, false);
+    bl_cancel_alarm();
+}
+
+// 保持段到头了：只把回绕中断重新打开，下一个周期由中断接着走。
+// 双核时 alarm 在 core 0 上响，这里只碰 INTE（原子置位），播放状态还是只归 core 1 的中断管
+static int64_t ONCE_HOT_FUNC(bl_alarm_cb)(alarm_id_t id, void *user_data) {
+    (void)id;
+    (void)user_data;
+    pwm_clear_irq(bl_slice);
+    pwm_set_irq_enabled(bl_slice, true);
+    return 0;
+}
+
+// 按 now 走到当前所在的那一步，算出此刻的亮度
+static bl_phase_t ONCE_HOT_FUNC(bl_advance)(uint32_t now, uint8_t *level, uint32_t *hold_end) {
+    const bl_pattern_t *p = bl_pat;
+    for (;;) {
+        const bl_step_t *s = &p->steps[bl_step];
+        uint32_t hold = (uint32_t)s->hold_ms * 1000u;
+        uint32_t ramp = (uint32_t)s->ramp_ms * 1000u;
+        uint32_t dt   = now - bl_step_t0;
+
+        if ((int32_t)dt < (int32_t)hold) {
+            *level    = bl_from;
+            *hold_end = bl_step_t0 + hold;
+            return BL_AT_HOLD;
+        }
+        if (dt < hold + ramp) {
+            int32_t span = (int32_t)s->level - (int32_t)bl_from;
+            *level = (uint8_t)((int32_t)bl_from + span * (int32_t)(dt - hold) / (int32_t)ramp);
+            return BL_AT_RAMP;
+        }
+
+        bl_from     = s->level;
+        bl_step_t0 += hold + ramp;
+        if (++bl_step == p->n) {
+            if (!p->loop) {
+                *level = bl_from;
+                return BL_AT_END;
+            }
+            bl_step = 0;
+        }
+    }
+}
+
+// 中断里或关中断时调：写出此刻的亮度，再决定下一次什么时候来。
+// 只有渐变段开着回绕中断；保持段（闪烁的每一步都是）关掉它，挂一个 alarm 到段尾，
+// 一段只花一次 alarm + 一次回绕。alarm 池满了就退回每个周期都来
+static void ONCE_HOT_FUNC(bl_service)(void) {
+    uint32_t   now = time_us_32();
+    uint8_t    level;
+    uint32_t   hold_end = now;
+    bl_phase_t phase = bl_advance(now, &level, &hold_end);
+    bl_write(level);
+
+    bl_cancel_alarm();
+    if (phase == BL_AT_END) {
+        bl_stop();
+        return;
+    }
+    if (phase == BL_AT_HOLD) {
+        // 先关再挂：段尾已经很近时 SDK 会在 add_alarm 里直接调回调，把中断又打开
+        pwm_set_irq_enabled(bl_slice, false);
+        bl_alarm = add_alarm_in_us((uint64_t)(hold_end - now), bl_alarm_cb, NULL, true);
+        if (bl_alarm >= 0) {
+            return;
+        }
+        bl_alarm = 0;
+    }
+    pwm_clear_irq(bl_slice);
+    pwm_set_irq_enabled(bl_slice, true);
+}
+
+static void ONCE_HOT_FUNC(backlight_wrap_irq)(void) {
+    INSTR_BEGIN(BL_WRAP);
+    pwm_clear_irq(bl_slice);
+    bl_stats.wrap_irqs++;
+    if (bl_pat) {
+        bl_service();
+    } else {
+        pwm_set_irq_enabled(bl_slice, false);   // 停下的同时 alarm 刚好响过
+    }
+    INSTR_END(BL_WRAP);
+}
+
+void backlight_init(void) {
+    bl_slice = pwm_gpio_to_slice_num(LCD_BL_PIN);
+    bl_chan  = pwm_gpio_to_channel(LCD_BL_PIN);
+
+    pwm_config cfg = pwm_get_default_config();
+    pwm_config_set_wrap(&cfg, BL_PWM_TOP);
+    pwm_config_set_clkdiv_int(&cfg, 1);
+#if !LCD_BL_ACTIVE_HIGH
+    pwm_config_set_output_polarity(&cfg, bl_chan == PWM_CHAN_A, bl_chan == PWM_CHAN_B);
+#endif
+    pwm_init(bl_slice, &cfg, false);
+    pwm_set_chan_level(bl_slice, bl_chan, 0);   // 默认关灯
+    bl_level = 0;
+    bl_pat   = NULL;
+
+    pwm_clear_irq(bl_slice);
+    pwm_set_irq_enabled(bl_slice, false);
+    irq_set_exclusive_handler(PWM_IRQ_WRAP, backlight_wrap_irq);
+    irq_set_enabled(PWM_IRQ_WRAP, true);
+
+    pwm_set_enabled(bl_slice, true);
+    gpio_set_function(LCD_BL_PIN, GPIO_FUNC_PWM);
+}
+
+void backlight_set(uint8_t level) {
+    uint32_t irq = save_and_disable_interrupts();
+    bl_stop();
+    bl_write(level);
+    restore_interrupts(irq);
+}
+
+void backlight_play(backlight_pattern_t pattern, uint64_t start_us) {
+    if (pattern >= BACKLIGHT_PATTERN_COUNT) {
+        return;
+    }
+    uint32_t irq = save_and_disable_interrupts();
+    bl_pat     = &BL_PATTERNS[pattern];
+    bl_step    = 0;
+    bl_step_t0 = (uint32_t)start_us;
+    bl_from    = bl_level;
+    bl_stats.plays++;
+
+    // 第一步马上生效，不等下一次回绕
+    bl_service();
+    restore_interrupts(irq);
+}
+
+uint8_t backlight_level(void) {
+    return bl_level;
+}
+
+bool backlight_busy(void) {
+    return bl_pat != NULL;
+}
+
+// 先把 SIO 的输出值和方向备好再切功能，切换的那一下不会闪
+void backlight_suspend(void) {
+    gpio_put(LCD_BL_PIN, (bl_level > 0) == (LCD_BL_ACTIVE_HIGH != 0));
+    gpio_set_dir(LCD_BL_PIN, GPIO_OUT);
+    gpio_set_function(LCD_BL_PIN, GPIO_FUNC_SIO);
+}
+
+void backlight_resume(void) {
+    gpio_set_function(LCD_BL_PIN, GPIO_FUNC_PWM);
+}
+
+const char *backlight_pattern_name(backlight_pattern_t pattern) {
+    return (pattern < BACKLIGHT_PATTERN_COUNT) ? BL_PATTERN_NAMES[pattern] : "?";
+}
+
+void backlight_get_stats(backlight_stats_t *out) {
+    uint32_t irq = save_and_disable_interrupts();
+    *out = bl_stats;
+    restore_interrupts(irq);
+}
+
+#endif // ONCE_BL_PWM
@@ -0,0 +1,88 @@
+// backlight.h
+// PWM 背光：LCD_BL_PIN 所在的 PWM slice，亮度 0..255，按平方映射到占空比（暗处也调得细），
+// 255 是常亮、0 是常灭。LCD_BL_ACTIVE_HIGH 为 0 时输出反相，亮度的意思不变。
+//
+// 图案（DONE 闪烁、呼吸、开机渐亮、高分脉冲）是一串“保持一段 -> 渐变到某个亮度”的步。
+// 渐变段才开 PWM 回绕中断：每个 PWM 周期（约 0.5 ms）按 timer 的 us 算一次当前亮度，
+// 写进比较寄存器，下个周期生效，不会有毛刺。保持段（DONE 闪烁全是）只写一次比较值，
+// 关掉回绕中断，挂一个 alarm 到段尾再打开它，一段只来一次。播完或者被 backlight_set()
+// 打断就关中断，停在某个亮度上时零开销。主循环只在开始时调一次 backlight_play()，之后不用管。
+//
+// 节奏按 timer 算，不数 PWM 周期：降频（power.c 的 SLOW）时 PWM 频率跟着 clk_sys 变，图案快慢不变。
+// DORMANT 里 clk_sys 停，PWM 也停在半路：进去之前 backlight_suspend() 把脚切回普通 GPIO，
+// 亮度不是 0 就按“亮”输出，醒来 backlight_resume() 再切回 PWM。正在播图案时不让进 DORMANT。
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "board.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BACKLIGHT_LEVEL_MAX   255u
+
+// 图案：X(名字, 打印用的名字)
+#define BACKLIGHT_PATTERN_LIST(X)     \
+    X(BLINK,   "blink")               \
+    X(BREATHE, "breathe")             \
+    X(FADE_IN, "fade_in")             \
+    X(PULSE,   "pulse")
+
+#define BACKLIGHT_ENUM_ENTRY(id, name) BACKLIGHT_##id,
+
+typedef enum {
+    BACKLIGHT_PATTERN_LIST(BACKLIGHT_ENUM_ENTRY)
+    BACKLIGHT_PATTERN_COUNT
+} backlight_pattern_t;
+
+typedef struct {
+    uint32_t plays;        // backlight_play() 次数
+    uint32_t wrap_irqs;    // 回绕中断次数（渐变时每个周期一次，保持段一段一次）
+    uint32_t level_writes; // 真正改了比较寄存器的次数
+} backlight_stats_t;
+
+#if ONCE_BL_PWM
+
+/**
+ * 脚切到 PWM，亮度 0（灭）。回绕中断挂在调用它的这个核上。
+ */
+void backlight_init(void);
+
+/**
+ * 停掉正在播的图案，直接设亮度。
+ */
+void backlight_set(uint8_t level);
+
+/**
+ * 从 start_us（绝对时间，可以稍早于现在）开始播一个图案，起点是当前亮度。
+ * 循环的图案（闪烁、呼吸）一直播到下一次 backlight_set() / backlight_play()；
+ * 其余的播完停在最后一步的亮度上。
+ */
+void backlight_play(backlight_pattern_t pattern, uint64_t start_us);
+
+uint8_t backlight_level(void);
+
+// 正在播图案
+bool backlight_busy(void);
+
+// 进 / 出 DORMANT 时由 power.c 调，见文件头
+void backlight_suspend(void);
+void backlight_resume(void);
+
+const char *backlight_pattern_name(backlight_pattern_t pattern);
+void backlight_get_stats(backlight_stats_t *out);
+
+#else
+
+static inline bool backlight_busy(void) { return false; }
+static inline void backlight_suspend(void) {}
+static inline void backlight_resume(void) {}
+
+#endif // ONCE_BL_PWM
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,18 +6,179 @@
 #define LCD_SDA_PIN   2
 #define LCD_SCL_PIN   3
 
+// LCD 总线：GP2/GP3 正好是 I2C1 的 SDA/SCL
+#define LCD_I2C_INST      i2c1
+#define LCD_I2C_IRQ       I2C1_IRQ
+#define LCD_I2C_BAUD      400000     // Fast-mode，PCF8576 最高支持 400 kHz
+#define LCD_PIO_INST      pio0
+#define LCD_PIO_IRQ       PIO0_IRQ_0
+
+// 默认传输方式，可在 CMake 里用 -DLCD_BUS_DEFAULT=LCD_BUS_PIO 覆盖
+// 可选：LCD_BUS_HW_I2C / LCD_BUS_PIO / LCD_BUS_BITBANG（见 lcd_bus.h）
+#ifndef LCD_BUS_DEFAULT
+#define LCD_BUS_DEFAULT   LCD_BUS_HW_I2C
+#endif
+
+// 0 = 只编译位模拟方式（主机仿真构建没有 I2C / PIO / DMA 外设）
+#ifndef LCD_BUS_HAS_HW
+#define LCD_BUS_HAS_HW    1
+#endif
+
+// 置 1 时上电后依次测一遍三种总线的每帧耗时并打印
+#ifndef LCD_BUS_REPORT_AT_BOOT
+#define LCD_BUS_REPORT_AT_BOOT  0
+#endif
+
 // 背光控制：BL- 通过这个脚拉低/拉高
 #define LCD_BL_PIN    4          // 替换成你实际接的 GPIO
 
 // 极性：1 表示输出 1 = 背光点亮，0 表示输出 0 = 背光点亮
 #define LCD_BL_ACTIVE_HIGH  1
 
+// 1 = 背光脚挂在 PWM 上（drivers/backlight.h）：亮度可调，DONE 闪烁、开机渐亮、高分脉冲
+// 由 PWM 回绕中断按时刻播放，主循环不管；0 = 原来的 GPIO 开关，闪烁由主循环按 alarm 翻转
+#ifndef ONCE_BL_PWM
+#define ONCE_BL_PWM         1
+#endif
+
+// 平时的亮度（0..255）。不开满，给高分脉冲留出往上走的余量（网页原型是 1.0 -> 1.2 -> 1.0）
+#ifndef LCD_BL_LEVEL_ON
+#define LCD_BL_LEVEL_ON     213
+#endif
+
 // EC11 旋转编码器
 #define ENCODER_EC11_PIN_A   6   // OTA
 #define ENCODER_EC11_PIN_B   8   // OTB
 #define ENCODER_EC11_PIN_C   7   // OTC (按键)
 
+// 1 = A/B 用 PIO 状态机硬件解码（空闲零中断）；0 = A/B 退回定时器轮询。
+// 按键两种方式下都走边沿中断 + 锁定式去抖
+#ifndef ENCODER_USE_PIO
+#define ENCODER_USE_PIO      1
+#endif
+// 定时器采样（ENCODER_USE_PIO=0）的自适应采样率：A/B 稳定时慢采，A/B 一有边沿（边沿中断）
+// 马上切快采，安静 HOLD 以后周期逐次翻倍退回慢采。SLOW = FAST = 1000 就是原来固定的 1 kHz
+#ifndef ENCODER_SAMPLE_SLOW_US
+#define ENCODER_SAMPLE_SLOW_US   10000   // 100 Hz
+#endif
+#ifndef ENCODER_SAMPLE_FAST_US
+#define ENCODER_SAMPLE_FAST_US   200     // 5 kHz
+#endif
+#ifndef ENCODER_SAMPLE_HOLD_US
+#define ENCODER_SAMPLE_HOLD_US   50000
+#endif
+#ifndef ENCODER_SAMPLE_EDGE_KICK
+#define ENCODER_SAMPLE_EDGE_KICK 1       // 0 = 只靠慢采发现旋钮开始动
+#endif
+// 解码程序要装在地址 0，和 LCD 的 PIO I2C 分开放
+#define ENCODER_PIO_INST     pio1
+#define ENCODER_PIO_IRQ      PIO1_IRQ_0
+
 #define encoder_none  0
 #define cw            1   // 顺时针
 #define ccw           2   // 逆时针
 #define key           3   // 按键
+
+// 主循环空闲时用 WFE 睡到下一个截止时间或中断；0 = 退回原来的忙等轮询
+#ifndef ONCE_IDLE_WFE
+#define ONCE_IDLE_WFE        1
+#endif
+
+// 每秒打印一次主循环迭代次数，用来对比睡眠前后
+#ifndef ONCE_LOOP_STATS
+#define ONCE_LOOP_STATS      0
+#endif
+
+// 每次秒跳打印相对理论时刻的迟到（alarm 中断里 / 主循环里各一份）
+#ifndef ONCE_TICK_STATS
+#define ONCE_TICK_STATS      0
+#endif
+
+// 旋钮加速：1 = 按转速查曲线并吸附整数值（app/accel.c），0 = 原来的六档阶梯
+#ifndef ONCE_ACCEL_VELOCITY
+#define ONCE_ACCEL_VELOCITY  1
+#endif
+
+// 热点路径计时（drivers/instr.h）：1 = 编进去，USB 串口发 'p' 打印、'r' 清零；0 = 完全不编
+#ifndef ONCE_INSTR
+#define ONCE_INSTR           0
+#endif
+
+// 事件日志（drivers/trace.h）：1 = 热点路径只往 RAM 环里写二进制记录，主循环空闲时成批发到 USB 串口，
+// 主机上用 trace_decode 解码；0 = 完全不编，也不再有逐条 printf
+#ifndef ONCE_TRACE
+#define ONCE_TRACE           1
+#endif
+
+// 双核：1 = 显示、背光、USB 日志放到 core 1（drivers/ui_core.c），core 0 只管计时、输入和状态机；
+// 0 = 原来的单核主循环
+#ifndef ONCE_DUAL_CORE
+#define ONCE_DUAL_CORE       0
+#endif
+
+// 每秒给每个核记一条 CPU 占用（忙的千分比 + 唤醒次数）到事件日志；双核时默认打开
+#ifndef ONCE_CPU_STATS
+#define ONCE_CPU_STATS       ONCE_DUAL_CORE
+#endif
+
+// 计时显示：1 = 不到 10 分钟时显示到 0.1 s（M.SS.d，10 Hz 刷新）；0 = 只到整秒（1 Hz）
+#ifndef ONCE_SHOW_TENTHS
+#define ONCE_SHOW_TENTHS     1
+#endif
+
+// 会话记录（drivers/session_log.h）：每次停表记一条到 flash 最后几个扇区，断电不丢；'h' 打印最近几条
+#ifndef ONCE_SESSION_LOG
+#define ONCE_SESSION_LOG     1
+#endif
+
+// 开机预算：从上电复位到第一帧上屏（含 boot ROM 和时钟初始化），超了记一条 BOOT_SLOW，'b' 打印时标 OVER
+#ifndef ONCE_BOOT_FRAME_BUDGET_US
+#define ONCE_BOOT_FRAME_BUDGET_US  20000
+#endif
+
+// 空闲省电（drivers/power.h）：SET / DONE 里没人碰，先把 clk_sys 降下来，SET 里再久一点进 DORMANT，
+// 旋钮 / 按键叫醒；0 = 一直满速
+#ifndef ONCE_POWER
+#define ONCE_POWER           1
+#endif
+
+#ifndef ONCE_POWER_SLOW_MS
+#define ONCE_POWER_SLOW_MS      10000     // 没人碰多久降频
+#endif
+
+#ifndef ONCE_POWER_DORMANT_MS
+#define ONCE_POWER_DORMANT_MS   60000     // 没人碰多久进 DORMANT
+#endif
+
+// 降频后的 clk_sys，从 pll_usb（48 MHz）整数分频，pll_sys 关掉。低于 48 MHz 时 USB 串口可能掉线
+#ifndef ONCE_POWER_SLOW_KHZ
+#define ONCE_POWER_SLOW_KHZ     48000
+#endif
+
+// 基准构建（bench/once_bench.c 置 1）：驱动里多编几个给基准直接调的入口，正常固件不带
+#ifndef ONCE_BENCH
+#define ONCE_BENCH           0
+#endif
+
+// 旋钮原始波形采集（drivers/enc_capture.h）：串口 'x' 开始，A/B/C 每条边沿连同时刻记进 RAM，
+// 再发 'x' 停下并按 "#E <t_us> <ABC>" 逐行打出来，主机上用 enc_replay 回放；0 = 不编，省下缓冲区
+#ifndef ONCE_ENC_CAPTURE
+#define ONCE_ENC_CAPTURE     1
+#endif
+
+#ifndef ENC_CAPTURE_SIZE
+#define ENC_CAPTURE_SIZE     4096      // 条，每条 4 字节
+#endif
+
+// 热路径放 SRAM：中断回调（编码器采样 / 按键 / alarm / LCD 帧完成）和显示提交、位模拟 I2C
+// 用 ONCE_HOT_FUNC(名字) 定义，置 1 时链接到 .time_critical（开机从 flash 拷进 SRAM），
+// 不再受 XIP cache 缺失影响；0 = 原样在 flash 里执行。整个程序都进 RAM 见 CMake 的 ONCE_COPY_TO_RAM
+#ifndef ONCE_RAM_HOT
+#define ONCE_RAM_HOT         1
+#endif
+
+#if ONCE_RAM_HOT
+#define ONCE_HOT_FUNC(f)     __not_in_flash_func(f)
+#else
+#define ONCE_HOT_FUNC(f)     f
+#endif
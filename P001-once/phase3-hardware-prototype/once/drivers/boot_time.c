@@ -0,0 +1,68 @@
+// boot_time.c
+
+#include "drivers/boot_time.h"
+#include "drivers/trace.h"
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/timer.h"
+
+#define BOOT_NAME_ENTRY(id, name) name,
+
+static const char *const BOOT_PHASE_NAMES[BOOT_PHASE_COUNT] = {
+    BOOT_PHASE_LIST(BOOT_NAME_ENTRY)
+};
+
+// 时刻 0 也是合法的（主机仿真从 0 开始），所以另用一个标记
+static volatile uint32_t boot_t_us[BOOT_PHASE_COUNT];
+static volatile bool     boot_reached[BOOT_PHASE_COUNT];
+
+void boot_mark(boot_phase_t phase) {
+    if (phase >= BOOT_PHASE_COUNT || boot_reached[phase]) {
+        return;
+    }
+    uint32_t t = time_us_32();
+    boot_t_us[phase]    = t;
+    boot_reached[phase] = true;
+
+    TRACE(BOOT_PHASE, phase, t, 0);
+    if (phase == BOOT_FIRST_FRAME && t > ONCE_BOOT_FRAME_BUDGET_US) {
+        TRACE(BOOT_SLOW, phase, t, ONCE_BOOT_FRAME_BUDGET_US);
+    }
+}
+
+bool boot_phase_us(boot_phase_t phase, uint32_t *t_us) {
+    if (phase >= BOOT_PHASE_COUNT || !boot_reached[phase]) {
+        return false;
+    }
+    *t_us = boot_t_us[phase];
+    return true;
+}
+
+void boot_dump(void) {
+    uint32_t prev = 0;
+    bool     have_prev = false;
+    for (int i = 0; i < BOOT_PHASE_COUNT; ++i) {
+        uint32_t t;
+        if (!boot_phase_us((boot_phase_t)i, &t)) {
+            printf("[BOOT] %-12s -\n", BOOT_PHASE_NAMES[i]);
+            continue;
+        }
+        if (have_prev) {
+            printf("[BOOT] %-12s %8lu us  %+9ld\n", BOOT_PHASE_NAMES[i], (unsigned long)t,
+                   (long)(int32_t)(t - prev));
+        } else {
+            printf("[BOOT] %-12s %8lu us\n", BOOT_PHASE_NAMES[i], (unsigned long)t);
+        }
+        prev      = t;
+        have_prev = true;
+    }
+
+    uint32_t frame;
+    if (boot_phase_us(BOOT_FIRST_FRAME, &frame)) {
+        printf("[BOOT] first frame %lu us, budget %lu us: %s\n", (unsigned long)frame,
+               (unsigned long)ONCE_BOOT_FRAME_BUDGET_US,
+               frame > ONCE_BOOT_FRAME_BUDGET_US ? "OVER" : "ok");
+    }
+}
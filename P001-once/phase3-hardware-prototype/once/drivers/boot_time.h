@@ -0,0 +1,52 @@
+// boot_time.h
+// 开机各阶段的时间戳：每个阶段第一次走到时记一次 time_us_32()（从上电复位算起，
+// boot ROM、crt0、时钟初始化都算在 main 之前），存在 RAM 里，串口发 'b' 随时能看，
+// 同时往事件日志里记一条 BOOT_PHASE。
+// 第一帧上屏超过 ONCE_BOOT_FRAME_BUDGET_US 时再记一条 BOOT_SLOW，开机变慢了一眼就能看出来。
+//
+// 开机顺序（见 once.c）：LCD 总线 + 模式设置 -> 第一帧 -> 背光 -> 编码器 -> flash 记录扫描
+// -> USB 串口 -> 进主循环。双核时 USB 串口在 core 1 上起，可能比 core 0 进主循环还晚。
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "board.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 阶段：X(名字, 打印用的名字)，按正常开机的先后排
+#define BOOT_PHASE_LIST(X)                  \
+    X(MAIN,        "main")                  \
+    X(LCD_READY,   "lcd_ready")             \
+    X(FIRST_FRAME, "first_frame")           \
+    X(BACKLIGHT,   "backlight")             \
+    X(ENCODER,     "encoder")               \
+    X(SESSION_LOG, "session_log")           \
+    X(STDIO,       "usb_stdio")             \
+    X(MAIN_LOOP,   "main_loop")
+
+#define BOOT_ENUM_ENTRY(id, name) BOOT_##id,
+
+typedef enum {
+    BOOT_PHASE_LIST(BOOT_ENUM_ENTRY)
+    BOOT_PHASE_COUNT
+} boot_phase_t;
+
+/**
+ * 记下这个阶段的时刻，只有第一次算数。
+ * 每个阶段只在一个核上走到，两个核同时打点也不用加锁。
+ */
+void boot_mark(boot_phase_t phase);
+
+// 没走到返回 false
+bool boot_phase_us(boot_phase_t phase, uint32_t *t_us);
+
+// 打印各阶段时刻、和上一阶段的间隔，以及第一帧有没有超预算
+void boot_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
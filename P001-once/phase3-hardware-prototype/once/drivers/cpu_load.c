@@ -0,0 +1,39 @@
+// cpu_load.c
+
+#include "drivers/cpu_load.h"
+#include "drivers/board.h"
+#include "drivers/trace.h"
+
+#include "hardware/timer.h"
+
+void cpu_load_init(cpu_load_t *l, uint8_t core) {
+    *l = (cpu_load_t){0};
+    l->core         = core;
+    l->window_t0_us = time_us_64();
+}
+
+void cpu_load_idle_begin(cpu_load_t *l) {
+    l->idle_t0_us = time_us_64();
+}
+
+void cpu_load_idle_end(cpu_load_t *l) {
+    l->idle_us += time_us_64() - l->idle_t0_us;
+    l->wakeups++;
+}
+
+void cpu_load_poll(cpu_load_t *l, uint64_t now_us) {
+    uint64_t span = now_us - l->window_t0_us;
+    if (span < CPU_LOAD_WINDOW_US) {
+        return;
+    }
+    uint64_t busy = (l->idle_us < span) ? span - l->idle_us : 0;
+    l->last_permille = (uint16_t)(busy * 1000u / span);
+
+#if ONCE_CPU_STATS
+    TRACE(CPU, l->core, l->last_permille, l->wakeups);
+#endif
+
+    l->window_t0_us = now_us;
+    l->idle_us      = 0;
+    l->wakeups      = 0;
+}
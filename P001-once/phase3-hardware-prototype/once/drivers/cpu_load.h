@@ -0,0 +1,34 @@
+// cpu_load.h
+// 每个核的占用统计：睡觉（WFE）前后各打一次时间戳，一个窗口里没睡掉的时间就是“忙”。
+// 窗口满 1 秒往事件日志里记一条 CPU 记录（ONCE_CPU_STATS 为 0 时只统计不记）。
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CPU_LOAD_WINDOW_US  1000000
+
+typedef struct {
+    uint8_t  core;
+    uint64_t window_t0_us;  // 当前窗口的起点
+    uint64_t idle_t0_us;    // 这一觉开始的时刻
+    uint64_t idle_us;       // 当前窗口里睡掉的时间
+    uint32_t wakeups;       // 当前窗口里醒了几次
+    uint16_t last_permille; // 上一个窗口的忙碌千分比
+} cpu_load_t;
+
+void cpu_load_init(cpu_load_t *l, uint8_t core);
+
+// 包在 WFE / sleep 两边
+void cpu_load_idle_begin(cpu_load_t *l);
+void cpu_load_idle_end(cpu_load_t *l);
+
+// 每圈调一次，窗口满了就结算
+void cpu_load_poll(cpu_load_t *l, uint64_t now_us);
+
+#ifdef __cplusplus
+}
+#endif
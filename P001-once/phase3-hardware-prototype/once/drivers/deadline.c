@@ -0,0 +1,93 @@
+// deadline.c
+// 周期截止时间：用 SDK 默认 alarm 池（硬件 alarm 3），回调返回负的周期，
+// SDK 会按“上一次的理论时刻 + 周期”重新挂上，所以不会累积漂移。
+
+#include "drivers/deadline.h"
+#include "drivers/instr.h"
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+static int64_t ONCE_HOT_FUNC(deadline_alarm_cb)(alarm_id_t id, void *user_data) {
+    (void)id;
+    INSTR_BEGIN(DEADLINE_CB);
+    deadline_t *d = (deadline_t *)user_data;
+
+    uint64_t now = time_us_64();
+    uint64_t due = d->due_us;
+    uint32_t late = (now > due) ? (uint32_t)(now - due) : 0;
+
+    d->stats.fired++;
+    d->stats.last_late_us   = late;
+    d->stats.total_late_us += late;
+    if (late > d->stats.max_late_us) {
+        d->stats.max_late_us = late;
+    }
+
+    d->due_us = due + d->period_us;
+    d->fired++;
+    __sev();    // 主循环可能在 WFE
+
+    INSTR_END(DEADLINE_CB);
+    return -(int64_t)d->period_us;
+}
+
+bool deadline_start(deadline_t *d, uint64_t first_us, uint32_t period_us) {
+    deadline_cancel(d);
+
+    d->period_us = period_us;
+    d->due_us    = first_us;
+    d->taken     = d->fired;
+
+    alarm_id_t id = add_alarm_at(from_us_since_boot(first_us), deadline_alarm_cb, d, true);
+    if (id <= 0) {
+        // id == 0 只在 first_us 已过且 fire_if_past 为 false 时出现，这里不会
+        d->id = 0;
+        return false;
+    }
+    d->id = id;
+    return true;
+}
+
+void deadline_cancel(deadline_t *d) {
+    if (d->id > 0) {
+        cancel_alarm(d->id);
+        d->id = 0;
+    }
+    // 回调和主循环在同一个核上，cancel 之后不会再改 fired
+    d->taken = d->fired;
+}
+
+uint32_t deadline_take(deadline_t *d, uint64_t *due_us) {
+    if (d->fired == d->taken) {
+        return 0;
+    }
+
+    // fired 和 due_us 要一起读，中间不能再被回调挪一次
+    uint32_t irq   = save_and_disable_interrupts();
+    uint32_t fired = d->fired;
+    uint64_t next  = d->due_us;
+    restore_interrupts(irq);
+
+    uint32_t n = fired - d->taken;
+    d->taken = fired;
+
+    // due_us 已经挪到“下一次”，往回推一个周期就是最后到点的那一次
+    d->last_due_us = next - d->period_us;
+    if (due_us) {
+        *due_us = d->last_due_us;
+    }
+    return n;
+}
+
+void deadline_get_stats(const deadline_t *d, deadline_stats_t *out) {
+    uint32_t irq = save_and_disable_interrupts();
+    *out = d->stats;
+    restore_interrupts(irq);
+}
+
+void deadline_reset_stats(deadline_t *d) {
+    uint32_t irq = save_and_disable_interrupts();
+    d->stats = (deadline_stats_t){0};
+    restore_interrupts(irq);
+}
@@ -0,0 +1,63 @@
+// deadline.h
+// 基于硬件 alarm 的周期截止时间：秒跳、背光闪烁这类“到点就该发生”的事
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "pico/time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 每次触发相对“理论时刻”的迟到统计（单位 us，在 alarm 中断里测）
+typedef struct {
+    uint32_t fired;        // 触发次数
+    uint32_t last_late_us; // 最近一次迟到
+    uint32_t max_late_us;  // 最大迟到
+    uint64_t total_late_us;// 累计迟到，配合 fired 求平均
+} deadline_stats_t;
+
+/*
+ * 一个周期截止时间。alarm 回调只记一笔“到点了”并 SEV 叫醒主循环，
+ * 真正的活（改显示、切背光）还是在主循环里做。
+ * 下一次的理论时刻 = 上一次理论时刻 + period，和回调 / 主循环跑了多久无关，不会漂。
+ */
+typedef struct {
+    alarm_id_t        id;        // 0 = 没在跑
+    uint32_t          period_us;
+    volatile uint64_t due_us;    // 下一次理论触发时刻
+    volatile uint32_t fired;     // 只由中断写
+    uint32_t          taken;     // 只由主循环写
+    uint64_t          last_due_us; // 最近一次被取走的理论时刻
+    deadline_stats_t  stats;
+} deadline_t;
+
+/**
+ * 从 first_us（绝对时间，us since boot）开始，每隔 period_us 触发一次。
+ * 已经在跑的会先取消。返回 false 表示 alarm 池满了。
+ */
+bool deadline_start(deadline_t *d, uint64_t first_us, uint32_t period_us);
+
+/**
+ * 取消，丢掉还没取走的触发。没在跑也可以调。
+ */
+void deadline_cancel(deadline_t *d);
+
+static inline bool deadline_running(const deadline_t *d) {
+    return d->id > 0;
+}
+
+/**
+ * 主循环里调：返回自上次以来到点的次数（通常是 0 或 1，主循环卡住时可能更多），
+ * 并把计数清零。*due_us 填最后一次的理论时刻（可以为 NULL）。
+ */
+uint32_t deadline_take(deadline_t *d, uint64_t *due_us);
+
+void deadline_get_stats(const deadline_t *d, deadline_stats_t *out);
+void deadline_reset_stats(deadline_t *d);
+
+#ifdef __cplusplus
+}
+#endif
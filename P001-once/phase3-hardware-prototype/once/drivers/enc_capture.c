@@ -0,0 +1,73 @@
+// enc_capture.c
+
+#include "drivers/enc_capture.h"
+
+#if ONCE_ENC_CAPTURE
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+// 一条 = 相对时刻 << 3 | 电平
+#define CAP_PIN_BITS   3
+#define CAP_T_MASK     (UINT32_MAX >> CAP_PIN_BITS)
+
+/*
+ * 生产者只有编码器的 GPIO 中断，消费者（dump）只读 n 之前的条目：
+ * 先写条目、__dmb()、再挪 n，另一个核上的 dump 也不会读到写了一半的。
+ */
+static uint32_t          cap_buf[ENC_CAPTURE_SIZE];
+static volatile uint32_t cap_n       = 0;
+static volatile uint32_t cap_dropped = 0;
+static uint64_t          cap_t0_us   = 0;
+static uint8_t           cap_pins0   = 0;
+
+void enc_capture_start(uint64_t now_us, uint8_t pins) {
+    cap_t0_us   = now_us;
+    cap_pins0   = pins;
+    cap_dropped = 0;
+    __dmb();
+    cap_n = 0;
+}
+
+bool ONCE_HOT_FUNC(enc_capture_record)(uint64_t now_us, uint8_t pins) {
+    uint32_t n = cap_n;
+    if (n >= ENC_CAPTURE_SIZE) {
+        cap_dropped++;
+        return false;
+    }
+    cap_buf[n] = ((uint32_t)(now_us - cap_t0_us) << CAP_PIN_BITS) | (pins & ((1u << CAP_PIN_BITS) - 1));
+    __dmb();
+    cap_n = n + 1;
+    return true;
+}
+
+uint32_t enc_capture_count(void) {
+    return cap_n;
+}
+
+static void print_edge(uint64_t t_us, uint8_t pins) {
+    printf("#E %llu %u%u%u\n", (unsigned long long)t_us,
+           (pins & ENC_CAPTURE_A) ? 1u : 0u, (pins & ENC_CAPTURE_B) ? 1u : 0u, (pins & ENC_CAPTURE_C) ? 1u : 0u);
+}
+
+void enc_capture_dump(void) {
+    uint32_t n = cap_n;
+    __dmb();
+    printf("[CAP] edges=%lu dropped=%lu\n", (unsigned long)n, (unsigned long)cap_dropped);
+    print_edge(cap_t0_us, cap_pins0);
+
+    // 相对时刻只有 29 位：按相邻两条的差还原
+    uint64_t t    = cap_t0_us;
+    uint32_t prev = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        uint32_t rel = cap_buf[i] >> CAP_PIN_BITS;
+        t += (rel - prev) & CAP_T_MASK;
+        prev = rel;
+        print_edge(t, (uint8_t)(cap_buf[i] & ((1u << CAP_PIN_BITS) - 1)));
+    }
+    printf("[CAP] end\n");
+}
+
+#endif // ONCE_ENC_CAPTURE
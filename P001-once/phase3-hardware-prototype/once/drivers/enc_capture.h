@@ -0,0 +1,55 @@
+// enc_capture.h
+// 旋钮原始波形采集：“转快了丢格”复现不出来，先把现场的 A/B/C 波形原样录下来。
+// 开着的时候编码器驱动给 A/B/C 都开边沿中断，每条边沿在中断里记一条：
+// 相对开始时刻的 us（29 位，约 536 s 回绕，相邻两条只要不隔这么久就能还原）+ 三根脚的电平。
+// 录满就不再记，只数丢了几条。停下以后 enc_capture_dump() 按行打出来：
+//   [CAP] edges=<n> dropped=<n>
+//   #E <t_us> <A><B><C>      第一行是开始时的电平，之后每条边沿一行，电平 1 = 高（没接地）
+//   [CAP] end
+// 主机上 enc_replay 直接吃整段串口输出，按同样的时刻把电平灌进仿真，跑一遍真正的解码器。
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "board.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 电平位：和 #E 行里的顺序一致
+#define ENC_CAPTURE_A   0x1u
+#define ENC_CAPTURE_B   0x2u
+#define ENC_CAPTURE_C   0x4u
+
+#if ONCE_ENC_CAPTURE
+
+/**
+ * 清空缓冲，从 now_us 开始记；pins 是这一刻的电平。只由编码器驱动在中断上下文里调。
+ */
+void enc_capture_start(uint64_t now_us, uint8_t pins);
+
+/**
+ * 中断里记一条边沿。满了返回 false（计入 dropped）。
+ */
+bool enc_capture_record(uint64_t now_us, uint8_t pins);
+
+// 已经记了几条边沿（不含开始那一行）
+uint32_t enc_capture_count(void);
+
+// 打印整段波形，格式见上
+void enc_capture_dump(void);
+
+#else
+
+static inline void enc_capture_start(uint64_t now_us, uint8_t pins) { (void)now_us; (void)pins; }
+static inline bool enc_capture_record(uint64_t now_us, uint8_t pins) { (void)now_us; (void)pins; return false; }
+static inline uint32_t enc_capture_count(void) { return 0; }
+static inline void enc_capture_dump(void) {}
+
+#endif // ONCE_ENC_CAPTURE
+
+#ifdef __cplusplus
+}
+#endif
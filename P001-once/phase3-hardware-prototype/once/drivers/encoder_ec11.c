@@ -1,23 +1,67 @@
 /**
  * @file    encoder_ec11.c
- * @brief   EC11 旋转编码器 (RP2040 精细版，带 spin lock 同步)
+ * @brief   EC11 旋转编码器 (RP2040 精细版，无锁事件环)
+ *
+ * 两种解码方式，编译期由 board.h 的 ENCODER_USE_PIO 选择：
+ *   - PIO：状态机硬件解码 A/B，计数变化时才触发 RX 中断，空闲时零中断
+ *   - 定时器：轮询 + quad_table 查表，作为兜底。采样率自适应：A/B 稳定时 100 Hz，
+ *     A/B 边沿中断一来马上切到 5 kHz 并关掉边沿中断，安静一段以后逐步退回 100 Hz
+ * 按键两种方式下都走 GPIO 边沿中断：第一条边沿立刻生效，时间戳就是进中断的那一刻。
+ *
+ * 每一格 / 每次按键在中断里检测到的那一刻打上 us 时间戳，写进单生产者单消费者的
+ * 无锁环形队列，主循环按需一次性取走，不再需要 spin lock。
  */
 
 #include "drivers/encoder_ec11.h"
 #include "drivers/board.h"
+#include "drivers/instr.h"
+#include "drivers/trace.h"
+#include "drivers/enc_capture.h"
+
+#include <stdio.h>
 
 #include "pico/stdlib.h"
 #include "pico/time.h"
-#include "pico/sync.h"
 #include "hardware/gpio.h"
+#include "hardware/sync.h"
+
+#if ENCODER_USE_PIO
+#include "hardware/pio.h"
+#include "hardware/irq.h"
+#include "encoder_ec11_quad.pio.h"
+#endif
 
 /* 一般 EC11 一格 4 个边沿，如果你那个实际是一格 2 步，可以改成 2 */
 #define ENCODER_STEPS_PER_NOTCH  4
 
-/* 1 kHz 采样，单位 us，负号表示从“现在”起反复触发 */
-#define ENCODER_SAMPLE_PERIOD_US (-1000)
+/* 事件环大小，必须是 2 的幂 */
+#define ENCODER_RING_SIZE        64
+#define ENCODER_RING_MASK        (ENCODER_RING_SIZE - 1)
+
+/* 按键锁定式去抖：一次有效边沿之后这段时间内的抖动全部忽略 */
+#define ENCODER_BTN_LOCKOUT_US   20000
+
+#if ENCODER_USE_PIO
+
+static int      enc_pio_sm        = -1;
+static int32_t  enc_pio_last_pos  = 0;      // 上次读到的 PIO 边沿计数
 
-static repeating_timer_t encoder_timer;
+#else
+
+static repeating_timer_t  encoder_timer;
+static encoder_sampling_t enc_cfg = {
+    ENCODER_SAMPLE_SLOW_US, ENCODER_SAMPLE_FAST_US, ENCODER_SAMPLE_HOLD_US, ENCODER_SAMPLE_EDGE_KICK != 0
+};
+
+/* 采样状态和统计：只在中断（采样定时器 / GPIO 边沿 / alarm，同优先级）里改 */
+static uint32_t        enc_period_us    = ENCODER_SAMPLE_SLOW_US;  // 当前采样周期
+static uint64_t        enc_last_edge_us = 0;                       // 最近一次采到 A/B 变化
+static uint64_t        enc_due_us       = 0;                       // 采样定时器下一次的理论时刻
+static encoder_stats_t enc_stats;
+
+static void encoder_ab_edge(void);
+
+#endif
 
 /* 正交解码查表：prev(2bit) << 2 | curr(2bit) => -1 / 0 / +1 */
 static const int8_t quad_table[16] = {
@@ -31,74 +75,238 @@ static const int8_t quad_table[16] = {
      0,  -1, +1,  0
 };
 
-/* 编码器内部状态（原始边沿累积 / 已确认“格数”） */
-static volatile int32_t encoder_accum   = 0;   // 原始 +1/-1 累积
-static volatile int32_t encoder_notches = 0;   // 确认的一格步进累计
+/* 编码器内部状态（原始边沿累积），只在中断里改 */
+static int32_t          encoder_accum   = 0;   // 原始 +1/-1 累积
 static uint8_t          prev_ab_state   = 0;   // 上一次 A/B 状态 0..3
 
-/* 按键内部状态：稳定去抖 + 按下事件 */
-static bool     btn_last_level   = false;   // 上一次采样的“是否按下”
-static bool     btn_stable_level = false;   // 去抖后的稳定状态
-static uint8_t  btn_stable_count = 0;       // 连续相同采样计数
-static volatile bool btn_press_event = false;
+/* A/B 的 GPIO 边沿中断：定时器方式慢采时要（edge kick），录原始波形时也要，有一个要就开着。
+ * 只在中断里（或者关了中断）改 */
+static bool enc_ab_irq_kick    = false;
+static bool enc_ab_irq_capture = false;
+static bool enc_ab_irq_hw      = false;
+
+static void ONCE_HOT_FUNC(encoder_ab_irq_apply)(void) {
+    bool on = enc_ab_irq_kick || enc_ab_irq_capture;
+    if (on != enc_ab_irq_hw) {
+        gpio_set_irq_enabled(ENCODER_EC11_PIN_A, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, on);
+        gpio_set_irq_enabled(ENCODER_EC11_PIN_B, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, on);
+        enc_ab_irq_hw = on;
+    }
+}
 
-/* 用于在 timer 回调 和 Encoder_ReadData() 之间同步 */
-static spin_lock_t *enc_lock = NULL;
+/* 按键内部状态：只在中断（GPIO 边沿 / 锁定期结束的 alarm，同优先级）里改 */
+static bool     btn_stable_level = false;   // 去抖后的稳定状态（true = 按下）
+static bool     btn_locked       = false;   // 还在锁定期里
 
-/* 内部：单次采样步骤，由定时器回调周期调用 */
-static inline void encoder_sample_step(void) {
-    uint32_t flags = spin_lock_blocking(enc_lock);
+/*
+ * 事件环：生产者是中断（定时器 / alarm 回调、PIO RX、GPIO 边沿——都是默认同优先级，
+ * 不会互相嵌套，等效于单生产者），消费者是主循环。
+ * head 只由生产者写，tail 只由消费者写，靠 __dmb() 保证先写数据后挪指针。
+ */
+static encoder_event_t   enc_ring[ENCODER_RING_SIZE];
+static volatile uint32_t enc_ring_head = 0;
+static volatile uint32_t enc_ring_tail = 0;
+static volatile uint32_t enc_ring_overflows = 0;
+
+static inline void ONCE_HOT_FUNC(encoder_push)(uint8_t type, uint64_t t_us) {
+    uint32_t head = enc_ring_head;
+    if (head - enc_ring_tail >= ENCODER_RING_SIZE) {
+        enc_ring_overflows++;   // 主循环太久没取，丢最新的
+        INSTR_COUNT(ENC_RING_FULL);
+        TRACE(ENC_DROP, type, enc_ring_overflows, 0);
+        return;
+    }
+    enc_ring[head & ENCODER_RING_MASK].t_us = t_us;
+    enc_ring[head & ENCODER_RING_MASK].type = type;
+    __dmb();
+    enc_ring_head = head + 1;
+    __sev();    // 主循环可能正在 WFE，叫醒它（另一个核也能收到）
+}
 
-    /* 读取 A/B：EC11 通常上拉，未触发为 1，触发为 0 */
-    uint8_t a = gpio_get(ENCODER_EC11_PIN_A) ? 1 : 0;
-    uint8_t b = gpio_get(ENCODER_EC11_PIN_B) ? 1 : 0;
-    uint8_t curr_ab = (b << 1) | a;  // 低位 A，高位 B，范围 0..3
+/* 内部：原始边沿累积成“格”，凑满一格就打上时间戳入队，两种解码方式共用 */
+static inline void ONCE_HOT_FUNC(encoder_accumulate)(int32_t delta, uint64_t t_us) {
+    encoder_accum += delta;
 
-    uint8_t idx   = (prev_ab_state << 2) | curr_ab;
-    int8_t  delta = quad_table[idx];
+    while (encoder_accum >= ENCODER_STEPS_PER_NOTCH) {
+        encoder_accum -= ENCODER_STEPS_PER_NOTCH;
+        encoder_push(cw, t_us);    // 顺时针一格
+    }
+    while (encoder_accum <= -ENCODER_STEPS_PER_NOTCH) {
+        encoder_accum += ENCODER_STEPS_PER_NOTCH;
+        encoder_push(ccw, t_us);   // 逆时针一格
+    }
+}
 
-    if (delta != 0) {
-        encoder_accum += delta;
+static void encoder_btn_accept(bool pressed, uint64_t t_us);
 
-        if (encoder_accum >= ENCODER_STEPS_PER_NOTCH) {
-            encoder_accum   -= ENCODER_STEPS_PER_NOTCH;
-            encoder_notches += 1;  // 顺时针一格
-        } else if (encoder_accum <= -ENCODER_STEPS_PER_NOTCH) {
-            encoder_accum   += ENCODER_STEPS_PER_NOTCH;
-            encoder_notches -= 1;  // 逆时针一格
-        }
+/* 锁定期结束：期间被忽略的边沿可能已经把电平改了（例如不到 20 ms 的轻点，
+ * 松开的边沿落在锁定期里），这里按真实电平对齐一次，否则下一次按下会被当成抖动 */
+static int64_t ONCE_HOT_FUNC(encoder_btn_lockout_end)(alarm_id_t id, void *user_data) {
+    (void)id;
+    (void)user_data;
+    btn_locked = false;
+
+    bool raw_pressed = !gpio_get(ENCODER_EC11_PIN_C);
+    if (raw_pressed != btn_stable_level) {
+        encoder_btn_accept(raw_pressed, time_us_64());
     }
+    return 0;
+}
 
-    prev_ab_state = curr_ab;
+#if ONCE_ENC_CAPTURE
+/* 三根脚现在的电平，位定义见 enc_capture.h */
+static uint8_t ONCE_HOT_FUNC(encoder_pins)(void) {
+    return (uint8_t)((gpio_get(ENCODER_EC11_PIN_A) ? ENC_CAPTURE_A : 0u) |
+                     (gpio_get(ENCODER_EC11_PIN_B) ? ENC_CAPTURE_B : 0u) |
+                     (gpio_get(ENCODER_EC11_PIN_C) ? ENC_CAPTURE_C : 0u));
+}
+#endif
 
-    /* 按键去抖：引脚上拉，按下为 0；raw_pressed = true 表示“按下” */
-    bool raw_pressed = !gpio_get(ENCODER_EC11_PIN_C);
+/* 接受一次电平变化：按下就带着时间戳入队，然后进入锁定期 */
+static void ONCE_HOT_FUNC(encoder_btn_accept)(bool pressed, uint64_t t_us) {
+    btn_stable_level = pressed;
+    if (pressed) {
+        encoder_push(key, t_us);
+    }
+    btn_locked = add_alarm_in_us(ENCODER_BTN_LOCKOUT_US, encoder_btn_lockout_end, NULL, true) > 0;
+}
 
-    if (raw_pressed == btn_last_level) {
-        if (btn_stable_count < 5) {
-            btn_stable_count++;
-        } else if (btn_stable_level != raw_pressed) {
-            btn_stable_level = raw_pressed;
-            if (btn_stable_level) {
-                /* 从未按下 -> 按下，记一次事件 */
-                btn_press_event = true;
-            }
+/* 按键 GPIO 中断：两个方向的边沿都进来。进门先打时间戳，锁定期外的第一条边沿立刻生效，
+ * 不等电平稳定；方向看边沿本身而不是读电平（抖动中读电平可能正好读到反的） */
+static void ONCE_HOT_FUNC(encoder_btn_irq)(uint gpio, uint32_t events) {
+    uint64_t now = time_us_64();
+#if ONCE_ENC_CAPTURE
+    if (enc_ab_irq_capture) {
+        enc_capture_record(now, encoder_pins());
+    }
+#endif
+    /* SDK 每个核只有一个 GPIO 回调，A/B 的边沿中断也从这里进 */
+    if (gpio == ENCODER_EC11_PIN_A || gpio == ENCODER_EC11_PIN_B) {
+#if !ENCODER_USE_PIO
+        if (enc_ab_irq_kick) {
+            encoder_ab_edge();
         }
+#endif
+        return;
+    }
+    if (gpio != ENCODER_EC11_PIN_C || btn_locked) {
+        return;
+    }
+
+    bool pressed;
+    if ((events & (GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE)) == GPIO_IRQ_EDGE_FALL) {
+        pressed = true;
+    } else if ((events & (GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE)) == GPIO_IRQ_EDGE_RISE) {
+        pressed = false;
     } else {
-        btn_stable_count = 0;
-        btn_last_level   = raw_pressed;
+        /* 进中断前两个方向都攒下了，只能看现在的电平 */
+        pressed = !gpio_get(ENCODER_EC11_PIN_C);
     }
 
-    spin_unlock(enc_lock, flags);
+    if (pressed != btn_stable_level) {
+        encoder_btn_accept(pressed, now);
+    }
 }
 
-/* 定时器回调：每 1ms 调用一次 encoder_sample_step */
-static bool encoder_timer_callback(repeating_timer_t *t) {
-    (void)t;
+#if ENCODER_USE_PIO
+
+/* PIO RX 非空中断：计数变化才会进来，把新增的边沿并进 accum */
+static void ONCE_HOT_FUNC(encoder_pio_irq)(void) {
+    INSTR_BEGIN(ENC_PIO_IRQ);
+    uint64_t now = time_us_64();
+    int32_t  pos;
+
+    while (encoder_ec11_quad_try_get(ENCODER_PIO_INST, (uint)enc_pio_sm, &pos)) {
+        int32_t delta = pos - enc_pio_last_pos;
+        enc_pio_last_pos = pos;
+        encoder_accumulate(delta, now);
+    }
+    INSTR_END(ENC_PIO_IRQ);
+}
+
+#else
+
+/* edge kick 只在没快采时要：快采已经够密，不用再为每条边沿进一次中断 */
+static void ONCE_HOT_FUNC(encoder_edge_irq)(bool on) {
+    enc_ab_irq_kick = on && enc_cfg.edge_kick;
+    encoder_ab_irq_apply();
+}
+
+/* 内部：单次采样步骤，顺带定下一次的采样周期：
+ * 看到变化就切快采；安静够 hold_us 以后每采一次周期翻倍，直到慢采 */
+static inline void ONCE_HOT_FUNC(encoder_sample_step)(void) {
+    INSTR_BEGIN(ENC_SAMPLE);
+    uint64_t now = time_us_64();
+
+    /* 读取 A/B：EC11 通常上拉，未触发为 1，触发为 0 */
+    uint8_t a = gpio_get(ENCODER_EC11_PIN_A) ? 1 : 0;
+    uint8_t b = gpio_get(ENCODER_EC11_PIN_B) ? 1 : 0;
+    uint8_t curr_ab = (b << 1) | a;  // 低位 A，高位 B，范围 0..3
+
+    enc_stats.samples++;
+    if (curr_ab != prev_ab_state) {
+        if ((curr_ab ^ prev_ab_state) == 3) {
+            /* 两位都翻了：中间漏采了一步，quad_table 里是 0，这一步丢掉 */
+            enc_stats.invalid++;
+            INSTR_COUNT(ENC_INVALID);
+        } else {
+            enc_stats.transitions++;
+            encoder_accumulate(quad_table[(prev_ab_state << 2) | curr_ab], now);
+        }
+        enc_last_edge_us = now;
+        if (enc_period_us != enc_cfg.fast_us) {
+            enc_period_us = enc_cfg.fast_us;
+            enc_stats.fast_entries++;
+        }
+    } else if (enc_period_us < enc_cfg.slow_us && now - enc_last_edge_us >= enc_cfg.hold_us) {
+        enc_period_us = (enc_period_us * 2 < enc_cfg.slow_us) ? enc_period_us * 2 : enc_cfg.slow_us;
+    }
+
+    prev_ab_state = curr_ab;
+    encoder_edge_irq(enc_period_us != enc_cfg.fast_us);
+    INSTR_END(ENC_SAMPLE);
+}
+
+/* 定时器回调：采一次，下一次的间隔按 enc_period_us 来（SDK 用回调返回后的 delay_us 排下一次，
+ * 负数表示从上一次的理论时刻算起） */
+static bool ONCE_HOT_FUNC(encoder_timer_callback)(repeating_timer_t *t) {
+    uint64_t now  = time_us_64();
+    uint32_t late = (now > enc_due_us) ? (uint32_t)(now - enc_due_us) : 0;
+    enc_stats.timer_irqs++;
+    enc_stats.late_total_us += late;
+    if (late > enc_stats.late_max_us) {
+        enc_stats.late_max_us = late;
+    }
+
     encoder_sample_step();
+    t->delay_us = -(int64_t)enc_period_us;
+    enc_due_us += enc_period_us;
     return true;
 }
 
+static void encoder_timer_start(void) {
+    cancel_repeating_timer(&encoder_timer);
+    enc_due_us = time_us_64() + enc_period_us;
+    add_repeating_timer_us(-(int64_t)enc_period_us, encoder_timer_callback, NULL, &encoder_timer);
+}
+
+/* 定时器之外补采一次（A/B 边沿中断、醒来对齐）：刚切到快采的话，
+ * 排好的下一次慢采可能还要等好几 ms，定时器按新周期重新起 */
+static void ONCE_HOT_FUNC(encoder_sample_now)(void) {
+    uint32_t before = enc_period_us;
+    encoder_sample_step();
+    if (enc_period_us != before) {
+        encoder_timer_start();
+    }
+}
+
+static void ONCE_HOT_FUNC(encoder_ab_edge)(void) {
+    enc_stats.edge_irqs++;
+    encoder_sample_now();
+}
+
+#endif
+
 void Encoder_Init(void) {
     /* GPIO 初始化：全部上拉输入 */
     gpio_init(ENCODER_EC11_PIN_A);
@@ -118,50 +326,211 @@ void Encoder_Init(void) {
     uint8_t b = gpio_get(ENCODER_EC11_PIN_B) ? 1 : 0;
     prev_ab_state = (b << 1) | a;
 
-    btn_last_level   = !gpio_get(ENCODER_EC11_PIN_C);
-    btn_stable_level = btn_last_level;
-    btn_stable_count = 0;
+    /* 按键：引脚上拉，按下为 0 */
+    btn_stable_level = !gpio_get(ENCODER_EC11_PIN_C);
+    btn_locked       = false;
+
+    encoder_accum      = 0;
+    enc_ring_head      = 0;
+    enc_ring_tail      = 0;
+    enc_ring_overflows = 0;
+
+    /* 按键走边沿中断，不参与周期采样；A/B 的边沿中断（定时器方式）也挂在这个回调上，所以先注册 */
+    gpio_set_irq_enabled_with_callback(ENCODER_EC11_PIN_C,
+                                       GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE,
+                                       true,
+                                       encoder_btn_irq);
+
+    /* 重新初始化时不管 A/B 边沿中断之前开没开，先关一次 */
+    enc_ab_irq_kick    = false;
+    enc_ab_irq_capture = false;
+    enc_ab_irq_hw      = true;
+    encoder_ab_irq_apply();
+
+#if ENCODER_USE_PIO
+    /* A/B 交给 PIO 状态机解码（程序要求装在地址 0，所以单独占一个 PIO） */
+    pio_add_program_at_offset(ENCODER_PIO_INST, &encoder_ec11_quad_program, 0);
+    enc_pio_sm = pio_claim_unused_sm(ENCODER_PIO_INST, true);
+    encoder_ec11_quad_program_init(ENCODER_PIO_INST, (uint)enc_pio_sm,
+                                   ENCODER_EC11_PIN_A, ENCODER_EC11_PIN_B);
+    enc_pio_last_pos = 0;
+
+    /* 计数一变化 RX FIFO 就非空，进中断打时间戳 */
+    pio_set_irq0_source_enabled(ENCODER_PIO_INST, pis_sm0_rx_fifo_not_empty + enc_pio_sm, true);
+    irq_set_exclusive_handler(ENCODER_PIO_IRQ, encoder_pio_irq);
+    irq_set_enabled(ENCODER_PIO_IRQ, true);
+#else
+    /* 从慢采开始，后台自动跑状态机 */
+    enc_period_us    = enc_cfg.slow_us;
+    enc_last_edge_us = time_us_64();
+    enc_stats        = (encoder_stats_t){0};
+    encoder_edge_irq(enc_period_us != enc_cfg.fast_us);
+    encoder_timer_start();
+#endif
+}
 
-    encoder_accum   = 0;
-    encoder_notches = 0;
-    btn_press_event = false;
+/* 醒来后的对齐：按键和锁定期结束一样按真实电平补一次（锁定期里什么都不做）；
+ * 定时器采样马上补采一次，不等下一个 1 ms——采样相位在睡着时是冻住的，
+ * 醒来后第一次采样可能正好撞上第二条边沿，第一条就被跳过了 */
+static int64_t encoder_wake_resync(alarm_id_t id, void *user_data) {
+    (void)id;
+    (void)user_data;
+#if !ENCODER_USE_PIO
+    encoder_sample_now();
+#endif
+    if (!btn_locked) {
+        bool raw_pressed = !gpio_get(ENCODER_EC11_PIN_C);
+        if (raw_pressed != btn_stable_level) {
+            encoder_btn_accept(raw_pressed, time_us_64());
+        }
+    }
+    return 0;
+}
 
-    /* 申请一个硬件自旋锁，用于 timer 与主循环之间的同步 */
-    uint32_t lock_num = spin_lock_claim_unused(true);
-    enc_lock = spin_lock_init(lock_num);
+void Encoder_Resync(void) {
+    /* 按键和采样状态只在中断里改：借一个马上到点的 alarm，和它们同优先级，不会互相打断 */
+    add_alarm_in_us(0, encoder_wake_resync, NULL, true);
+}
 
-    /* 创建 1 kHz 定时器，后台自动跑状态机 */
-    add_repeating_timer_us(ENCODER_SAMPLE_PERIOD_US,
-                           encoder_timer_callback,
-                           NULL,
-                           &encoder_timer);
+#if ONCE_ENC_CAPTURE
+static int64_t encoder_capture_apply(alarm_id_t id, void *user_data) {
+    (void)id;
+    bool on = (user_data != NULL);
+    if (on) {
+        enc_capture_start(time_us_64(), encoder_pins());
+    }
+    enc_ab_irq_capture = on;
+    encoder_ab_irq_apply();
+    return 0;
+}
+#endif
+
+void Encoder_Capture(bool on) {
+#if ONCE_ENC_CAPTURE
+    /* 和 Resync 一样借 alarm 回到中断上下文：双核时串口命令在 core 1 上，
+     * GPIO 中断和默认 alarm 池都在 core 0，边沿中断得在 core 0 上开 */
+    add_alarm_in_us(0, encoder_capture_apply, on ? (void *)1 : NULL, true);
+#else
+    (void)on;
+#endif
 }
 
 /**
- * 读取一次事件：
- *   - 有按键事件：返回 key
- *   - 否则有旋转步进：顺时针返回 cw，逆时针返回 ccw（每次只消费一步）
- *   - 否则返回 encoder_none
- *
- * 注意：这里用 spin lock 做原子快照，避免与 1kHz 定时器回调并发修改。
+ * 取出一个事件（带检测时刻），没有事件返回 false。
+ * 只由主循环调用：读 head、拷数据、再挪 tail，全程无锁。
  */
-uint8_t Encoder_ReadData(void) {
-    uint8_t result = encoder_none;
+bool Encoder_ReadEvent(encoder_event_t *ev) {
+    uint32_t tail = enc_ring_tail;
+    if (tail == enc_ring_head) {
+        return false;
+    }
+    __dmb();
+    *ev = enc_ring[tail & ENCODER_RING_MASK];
+    __dmb();
+    enc_ring_tail = tail + 1;
+    return true;
+}
 
-    uint32_t flags = spin_lock_blocking(enc_lock);
+size_t Encoder_ReadEvents(encoder_event_t *out, size_t max) {
+    size_t n = 0;
+    while (n < max && Encoder_ReadEvent(&out[n])) {
+        n++;
+    }
+    return n;
+}
 
-    if (btn_press_event) {
-        btn_press_event = false;
-        result = key;
-    } else if (encoder_notches > 0) {
-        encoder_notches--;
-        result = cw;
-    } else if (encoder_notches < 0) {
-        encoder_notches++;
-        result = ccw;
+bool Encoder_ReadBatch(encoder_batch_t *out) {
+    *out = (encoder_batch_t){0};
+
+    encoder_event_t ev;
+    bool any = false;
+    while (Encoder_ReadEvent(&ev)) {
+        any = true;
+        if (ev.type == key) {
+            /* 按键之前的旋转已经都在 out 里了，按键本身结束这一批，保证先后顺序 */
+            out->pressed    = true;
+            out->pressed_us = ev.t_us;
+            break;
+        }
+        if (out->detents == 0) {
+            out->first_us = ev.t_us;
+        }
+        out->last_us = ev.t_us;
+        out->detents++;
+        out->net += (ev.type == cw) ? 1 : -1;
     }
+    return any;
+}
+
+bool Encoder_HasEvent(void) {
+    return enc_ring_tail != enc_ring_head;
+}
+
+uint32_t Encoder_GetOverflows(void) {
+    return enc_ring_overflows;
+}
+
+void Encoder_SetSampling(const encoder_sampling_t *cfg) {
+#if ENCODER_USE_PIO
+    (void)cfg;
+#else
+    /* 采样状态平时只在中断里改，这里关一下中断 */
+    uint32_t irq = save_and_disable_interrupts();
+    enc_cfg          = *cfg;
+    enc_period_us    = cfg->slow_us;
+    enc_last_edge_us = time_us_64();
+    encoder_edge_irq(enc_period_us != enc_cfg.fast_us);
+    encoder_timer_start();
+    restore_interrupts(irq);
+#endif
+}
 
-    spin_unlock(enc_lock, flags);
+void Encoder_GetStats(encoder_stats_t *out) {
+#if ENCODER_USE_PIO
+    *out = (encoder_stats_t){0};
+#else
+    *out = enc_stats;
+    out->period_us = enc_period_us;
+#endif
+}
 
-    return result;
+#if ONCE_BENCH
+void Encoder_BenchSample(void) {
+#if ENCODER_USE_PIO
+    encoder_pio_irq();
+#else
+    encoder_sample_step();
+#endif
+}
+
+void Encoder_BenchPush(uint8_t type, uint64_t t_us) {
+    encoder_push(type, t_us);
+}
+#endif
+
+void Encoder_DumpStats(void) {
+#if ENCODER_USE_PIO
+    printf("[ENC] pio decoder, overflows=%lu\n", (unsigned long)enc_ring_overflows);
+#else
+    encoder_stats_t s;
+    Encoder_GetStats(&s);
+    printf("[ENC] period=%lu us (slow %lu / fast %lu / hold %lu us, edge kick %s)\n",
+           (unsigned long)s.period_us, (unsigned long)enc_cfg.slow_us, (unsigned long)enc_cfg.fast_us,
+           (unsigned long)enc_cfg.hold_us, enc_cfg.edge_kick ? "on" : "off");
+    printf("[ENC] samples=%lu edge_irqs=%lu transitions=%lu invalid=%lu fast=%lu overflows=%lu\n",
+           (unsigned long)s.samples, (unsigned long)s.edge_irqs, (unsigned long)s.transitions,
+           (unsigned long)s.invalid, (unsigned long)s.fast_entries, (unsigned long)enc_ring_overflows);
+    printf("[ENC] timer_irqs=%lu late avg=%lu max=%lu us\n", (unsigned long)s.timer_irqs,
+           (unsigned long)(s.timer_irqs ? s.late_total_us / s.timer_irqs : 0), (unsigned long)s.late_max_us);
+#endif
+}
+
+/**
+ * 读取一次事件：
+ *   - 按检测先后返回 key / cw / ccw（每次只消费一个）
+ *   - 否则返回 encoder_none
+ */
+uint8_t Encoder_ReadData(void) {
+    encoder_event_t ev;
+    return Encoder_ReadEvent(&ev) ? ev.type : encoder_none;
 }
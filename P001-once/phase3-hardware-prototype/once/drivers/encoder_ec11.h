@@ -1,14 +1,116 @@
 #pragma once
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "board.h"
+
+/* 一个事件：类型（board.h 里的 cw / ccw / key）+ 在中断里检测到的时刻 */
+typedef struct {
+    uint64_t t_us;
+    uint8_t  type;
+} encoder_event_t;
+
+/* 批量汇总：一批连续旋转的净格数和首末时间戳；遇到按键就在按键处截断 */
+typedef struct {
+    int32_t  net;        // 净格数：cw 记 +1，ccw 记 -1
+    uint32_t detents;    // 本批旋转总格数（不抵消）
+    uint64_t first_us;   // 第一格的时刻
+    uint64_t last_us;    // 最后一格的时刻
+    bool     pressed;    // 本批以一次按键结尾
+    uint64_t pressed_us; // 按键时刻
+} encoder_batch_t;
+
+/* 定时器采样方式的采样率设置（PIO 方式用不上）。slow_us == fast_us 就是固定采样率 */
+typedef struct {
+    uint32_t slow_us;     // A/B 稳定时的采样周期
+    uint32_t fast_us;     // 看到边沿以后的采样周期
+    uint32_t hold_us;     // 安静多久开始退回慢采（每次采样周期翻倍，直到 slow_us）
+    bool     edge_kick;   // 没在快采时 A/B 开边沿中断，第一条边沿就切快采，不等下一次慢采
+} encoder_sampling_t;
+
+/* 采样统计（定时器采样方式）：invalid 多说明采得太慢，两次采样之间 A/B 都变了 */
+typedef struct {
+    uint32_t samples;       // 定时器采样次数（= 采样中断次数）
+    uint32_t edge_irqs;     // A/B 边沿中断次数
+    uint32_t transitions;   // 合法的单步边沿
+    uint32_t invalid;       // A/B 同时翻转：中间漏了一步，方向不明，这一步丢掉
+    uint32_t fast_entries;  // 切到快采的次数
+    uint32_t period_us;     // 当前采样周期
+    uint32_t timer_irqs;    // 采样定时器回调次数
+    uint32_t late_max_us;   // 回调相对理论时刻的最大迟到（中断延迟 + SDK alarm 派发）
+    uint64_t late_total_us; // 累计迟到，配合 timer_irqs 求平均
+} encoder_stats_t;
 
 /**
- * 初始化 EC11：配置 GPIO、启动 1kHz 定时器、清零内部状态。
+ * 初始化 EC11：配置 GPIO、启动 PIO 解码（或自适应采样的定时器）、清零内部状态。
  */
 void Encoder_Init(void);
 
+/**
+ * 从 DORMANT 醒来后调用：睡着时 GPIO 中断不锁存边沿，叫醒芯片的那一下按键会漏掉，
+ * 这里按当前电平补一次（时间戳是醒来的时刻）；定时器采样方式下 A/B 也马上补采一次。
+ * PIO 方式不用管，状态机醒来后自己会看到新电平。
+ */
+void Encoder_Resync(void);
+
+/**
+ * 开始 / 停止录原始波形（drivers/enc_capture.h）：开始时清空缓冲，录着的时候 A/B/C 每条边沿都进一次中断。
+ * 实际开关在随后的中断上下文里做，返回时可能还没生效。ONCE_ENC_CAPTURE=0 时什么都不做。
+ */
+void Encoder_Capture(bool on);
+
 /**
  * 读取一次事件：
  *   返回 board.h 里的 cw / ccw / key / encoder_none
  *   每次调用只返回一个事件，不会吞并。
  */
 uint8_t Encoder_ReadData(void);
+
+/**
+ * 取一个带时间戳的事件，没有返回 false。无锁，只能在主循环（单消费者）里调用。
+ */
+bool Encoder_ReadEvent(encoder_event_t *ev);
+
+/**
+ * 一次取走最多 max 个待处理事件，按检测先后排列，返回实际个数。
+ */
+size_t Encoder_ReadEvents(encoder_event_t *out, size_t max);
+
+/**
+ * 一次取走连续的旋转事件，汇总成净格数 + 首末时间戳；
+ * 碰到按键就把它记进 out 并停下（按键之后的事件留给下一次）。
+ * 什么都没有返回 false。
+ */
+bool Encoder_ReadBatch(encoder_batch_t *out);
+
+/**
+ * 还有没取走的事件（主循环决定能不能睡之前先看一眼）。
+ */
+bool Encoder_HasEvent(void);
+
+/**
+ * 事件环满时被丢掉的事件数（主循环太久没取）。
+ */
+uint32_t Encoder_GetOverflows(void);
+
+/**
+ * 换采样率（默认是 board.h 的 ENCODER_SAMPLE_*），从慢采重新开始。Encoder_Init 之后调用。
+ */
+void Encoder_SetSampling(const encoder_sampling_t *cfg);
+
+void Encoder_GetStats(encoder_stats_t *out);
+
+/**
+ * 串口打印采样统计（'e' 命令）。
+ */
+void Encoder_DumpStats(void);
+
+#if ONCE_BENCH
+/**
+ * 基准用（bench/）：不经过中断，直接跑一次采样步骤（PIO 方式是一次 RX 中断处理）/
+ * 往事件环里塞一个事件。和真正的中断同时跑会乱，只在基准里调。
+ */
+void Encoder_BenchSample(void);
+void Encoder_BenchPush(uint8_t type, uint64_t t_us);
+#endif
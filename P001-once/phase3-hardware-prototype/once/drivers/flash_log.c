@@ -0,0 +1,225 @@
+// flash_log.c
+
+#include "drivers/flash_log.h"
+#include "drivers/trace.h"
+
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include "hardware/timer.h"
+
+#define FLOG_HDR_SIZE      16
+
+// 等另一个核让出 flash 的最长时间
+#define FLOG_LOCKOUT_TIMEOUT_MS  10
+
+// 事件日志里的操作编号
+#define FLOG_OP_PROGRAM    0
+#define FLOG_OP_ERASE      1
+
+typedef struct {
+    uint32_t magic;
+    uint32_t gen;          // 擦写代数，每擦一个扇区加 1；最大的是头扇区
+    uint32_t first_seq;    // 本扇区第 1 个记录槽的序号
+    uint32_t check;        // ~(magic ^ gen ^ first_seq)
+} flog_hdr_t;
+
+_Static_assert(sizeof(flog_hdr_t) == FLOG_HDR_SIZE, "sector header is 16 bytes");
+
+// 一次 flash 操作：data 为 NULL 时擦扇区，否则写一页
+typedef struct {
+    uint32_t       offs;
+    const uint8_t *data;
+} flog_op_t;
+
+// 写页用的缓冲：整页 0xff，只有要写的槽不是。NOR flash 编程只会把 1 变 0，已有内容原样保留
+static uint8_t flog_page[FLASH_PAGE_SIZE];
+
+static uint32_t slots_per_sector(const flash_log_t *log) {
+    return FLASH_SECTOR_SIZE / log->slot_size;   // 含第 0 个槽的扇区头
+}
+
+static uint32_t slot_offs(const flash_log_t *log, uint32_t sector, uint32_t slot) {
+    return log->base_offs + sector * FLASH_SECTOR_SIZE + slot * log->slot_size;
+}
+
+static const uint8_t *slot_xip(const flash_log_t *log, uint32_t sector, uint32_t slot) {
+    return (const uint8_t *)(XIP_BASE + slot_offs(log, sector, slot));
+}
+
+static uint32_t hdr_check(const flog_hdr_t *h) {
+    return ~(h->magic ^ h->gen ^ h->first_seq);
+}
+
+static bool read_hdr(const flash_log_t *log, uint32_t sector, flog_hdr_t *h) {
+    memcpy(h, slot_xip(log, sector, 0), sizeof(*h));
+    return h->magic == log->magic && h->check == hdr_check(h);
+}
+
+static bool slot_blank(const flash_log_t *log, uint32_t sector, uint32_t slot) {
+    const uint8_t *p = slot_xip(log, sector, slot);
+    for (uint32_t i = 0; i < log->slot_size; ++i) {
+        if (p[i] != 0xff) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 真正动 flash 的部分：XIP 关着，这个函数和它调的 SDK 函数都必须在 RAM 里
+static void __not_in_flash_func(flog_flash_op)(void *param) {
+    const flog_op_t *op = (const flog_op_t *)param;
+    if (op->data) {
+        flash_range_program(op->offs, op->data, FLASH_PAGE_SIZE);
+    } else {
+        flash_range_erase(op->offs, FLASH_SECTOR_SIZE);
+    }
+}
+
+// 关中断跑一次 flash 操作。计时包在 flash_safe_execute 外面（里面不能调 flash 里的函数），
+// 量到的是关中断窗口的上界：多出来的只是挡住 / 放开另一个核的握手
+static bool flog_run(flash_log_t *log, const flog_op_t *op) {
+    uint64_t t0 = time_us_64();
+    int rc = flash_safe_execute(flog_flash_op, (void *)op, FLOG_LOCKOUT_TIMEOUT_MS);
+    uint32_t us = (uint32_t)(time_us_64() - t0);
+
+    if (rc != PICO_OK) {
+        log->stats.failures++;
+        return false;
+    }
+    if (op->data) {
+        log->stats.programs++;
+        if (us > log->stats.max_program_us) log->stats.max_program_us = us;
+    } else {
+        log->stats.erases++;
+        if (us > log->stats.max_erase_us) log->stats.max_erase_us = us;
+    }
+    TRACE(FLASH, op->data ? FLOG_OP_PROGRAM : FLOG_OP_ERASE, us, op->offs / FLASH_SECTOR_SIZE);
+    return true;
+}
+
+void flash_log_init(flash_log_t *log, uint32_t base_offs, uint8_t n_sectors,
+                    uint16_t slot_size, uint32_t magic) {
+    memset(log, 0, sizeof(*log));
+    log->base_offs = base_offs;
+    log->n_sectors = n_sectors;
+    log->slot_size = slot_size;
+    log->magic     = magic;
+    log->next_seq  = 1;
+
+    for (uint32_t s = 0; s < n_sectors; ++s) {
+        flog_hdr_t h;
+        if (read_hdr(log, s, &h) && (!log->have_head || (int32_t)(h.gen - log->gen) > 0)) {
+            log->have_head = true;
+            log->head      = s;
+            log->gen       = h.gen;
+            log->first_seq = h.first_seq;
+        }
+    }
+    if (!log->have_head) {
+        return;   // 全新的 flash，第一次写的时候再擦
+    }
+
+    // 槽是按顺序写的，写过的（哪怕只写了一半）都排在空槽前面，二分就行
+    uint32_t lo = 1, hi = slots_per_sector(log);
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (slot_blank(log, log->head, mid)) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    log->next_slot = lo;
+    log->next_seq  = log->first_seq + (lo - 1);
+}
+
+// 头扇区满了（或者还没有）：擦下一个扇区当新的头。扇区头等到写记录时再写
+static bool start_sector(flash_log_t *log) {
+    uint32_t next = log->have_head ? (log->head + 1) % log->n_sectors : 0;
+    const flog_op_t op = { slot_offs(log, next, 0), NULL };
+    if (!flog_run(log, &op)) {
+        return false;
+    }
+    log->gen         = log->have_head ? log->gen + 1 : 1;
+    log->have_head   = true;
+    log->hdr_pending = true;
+    log->head        = next;
+    log->first_seq   = log->next_seq;
+    log->next_slot   = 1;
+    return true;
+}
+
+static void put_hdr(const flash_log_t *log) {
+    flog_hdr_t h = { log->magic, log->gen, log->first_seq, 0 };
+    h.check = hdr_check(&h);
+    memcpy(flog_page, &h, sizeof(h));
+}
+
+flash_log_result_t flash_log_write(flash_log_t *log, const void *rec) {
+    const uint32_t per_page = FLASH_PAGE_SIZE / log->slot_size;
+
+    if (!log->have_head || log->next_slot >= slots_per_sector(log)) {
+        // 擦完这一步就算，写记录留到下一圈，两个窗口分开
+        return start_sector(log) ? FLASH_LOG_AGAIN : FLASH_LOG_FAILED;
+    }
+
+    uint32_t page_slot = log->next_slot - log->next_slot % per_page;
+    memset(flog_page, 0xff, sizeof(flog_page));
+
+    if (log->hdr_pending && page_slot != 0) {
+        // 槽和一页一样大：扇区头单独占第 0 页，先写它
+        put_hdr(log);
+        const flog_op_t op = { slot_offs(log, log->head, 0), flog_page };
+        if (!flog_run(log, &op)) {
+            return FLASH_LOG_FAILED;
+        }
+        log->hdr_pending = false;
+        return FLASH_LOG_AGAIN;
+    }
+
+    memcpy(&flog_page[(log->next_slot - page_slot) * log->slot_size], rec, log->slot_size);
+    if (log->hdr_pending) {
+        // 扇区头和第 1 条记录同在第 0 页：一次写完，断电在擦完之后也只是这个扇区作废
+        put_hdr(log);
+    }
+
+    const flog_op_t op = { slot_offs(log, log->head, page_slot), flog_page };
+    if (!flog_run(log, &op)) {
+        return FLASH_LOG_FAILED;
+    }
+    log->hdr_pending = false;
+    log->next_slot++;
+    log->next_seq++;
+    return FLASH_LOG_DONE;
+}
+
+bool flash_log_read(const flash_log_t *log, uint32_t back, void *out) {
+    if (!log->have_head || back >= log->next_seq - 1) {
+        return false;
+    }
+    uint32_t seq = log->next_seq - 1 - back;
+
+    // 从头扇区往回找，代数必须一个个接上，断了说明更早的已经被擦掉
+    for (uint32_t j = 0; j < log->n_sectors; ++j) {
+        uint32_t s = (log->head + log->n_sectors - j) % log->n_sectors;
+        flog_hdr_t h;
+        if (j == 0 && log->hdr_pending) {
+            continue;   // 头扇区刚擦完，里面还什么都没有
+        }
+        if (!read_hdr(log, s, &h) || h.gen != log->gen - j) {
+            return false;
+        }
+        if (seq >= h.first_seq) {
+            uint32_t slot = seq - h.first_seq + 1;
+            if (slot >= slots_per_sector(log)) {
+                return false;
+            }
+            memcpy(out, slot_xip(log, s, slot), log->slot_size);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,78 @@
+// flash_log.h
+// flash 末尾几个扇区上的只追加日志：定长槽，扇区写满按轮转擦下一个，最旧的一扇区随之作废。
+//
+// 每个扇区第 0 个槽放扇区头（魔数 + 擦写代数 + 本扇区第一条记录的序号），代数最大的扇区就是头扇区；
+// 开机只读几个扇区头，再在头扇区里二分找第一个空槽，扫描次数有上限，和记录多少无关。
+// 一条记录的序号由它的位置决定，调用方在记录里自己存一份序号和校验，用来挡住写了一半的槽。
+//
+// 擦 / 写 flash 时 XIP 不能用，要关中断（双核时连另一个核一起挡住），窗口就是一次操作的时间：
+// 写一页约 0.5 ms，擦一个扇区约 45 ms。flash_log_write() 每次只做一步，每步的关中断时间都量出来，
+// 记到事件日志（FLASH）和统计里。计时中不要调。
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t programs;         // 写页次数
+    uint32_t erases;           // 擦扇区次数
+    uint32_t failures;         // flash_safe_execute 没拿到另一个核
+    uint32_t max_program_us;   // 写页时关中断的最长时间
+    uint32_t max_erase_us;     // 擦扇区时关中断的最长时间
+} flash_log_stats_t;
+
+typedef struct {
+    // 配置
+    uint32_t base_offs;     // flash 偏移，扇区对齐
+    uint32_t magic;
+    uint16_t slot_size;     // 16..256，能整除一页
+    uint8_t  n_sectors;     // 至少 2 个才能轮转
+
+    // 状态
+    bool     have_head;     // flash 里有没有有效的扇区
+    bool     hdr_pending;   // 头扇区刚擦完，扇区头还没写
+    uint32_t head;          // 头扇区
+    uint32_t gen;
+    uint32_t first_seq;
+    uint32_t next_slot;     // 头扇区里下一个空槽
+    uint32_t next_seq;      // 下一条记录的序号，从 1 起
+
+    flash_log_stats_t stats;
+} flash_log_t;
+
+typedef enum {
+    FLASH_LOG_DONE = 0,     // 记录写进去了
+    FLASH_LOG_AGAIN,        // 这一步只擦了扇区 / 写了扇区头，记录还没写，下一圈再调
+    FLASH_LOG_FAILED,       // 这一步没做成（没拿到另一个核），下一圈重试
+} flash_log_result_t;
+
+/**
+ * 开机扫描：读各扇区头找到头扇区和下一个空槽。只读 flash，不擦不写。
+ */
+void flash_log_init(flash_log_t *log, uint32_t base_offs, uint8_t n_sectors,
+                    uint16_t slot_size, uint32_t magic);
+
+// 下一条记录会拿到的序号（写之前填进记录里）
+static inline uint32_t flash_log_next_seq(const flash_log_t *log) {
+    return log->next_seq;
+}
+
+/**
+ * 写一条 slot_size 字节的记录，每次调用只做一步 flash 操作，期间关中断。
+ * 返回 FLASH_LOG_AGAIN / FLASH_LOG_FAILED 时记录没写，用同样的内容再调。
+ */
+flash_log_result_t flash_log_write(flash_log_t *log, const void *rec);
+
+/**
+ * 读倒数第 back 条（0 = 最新）的原始内容。已经被擦掉时返回 false；
+ * 写了一半的槽照样读出来，由调用方的校验挡。
+ */
+bool flash_log_read(const flash_log_t *log, uint32_t back, void *out);
+
+#ifdef __cplusplus
+}
+#endif
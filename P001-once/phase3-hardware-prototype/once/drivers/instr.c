@@ -0,0 +1,135 @@
+// instr.c
+
+#include "instr.h"
+
+#if ONCE_INSTR
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "hardware/clocks.h"
+
+#if !ONCE_HOST
+#include "hardware/structs/systick.h"
+#else
+#include <time.h>
+#endif
+
+#define INSTR_NAME_ENTRY(id, name) name,
+
+static const char *const INSTR_REGION_NAMES[INSTR_REGION_COUNT] = {
+    INSTR_REGION_LIST(INSTR_NAME_ENTRY)
+};
+
+static const char *const INSTR_COUNTER_NAMES[INSTR_COUNTER_COUNT] = {
+    INSTR_COUNTER_LIST(INSTR_NAME_ENTRY)
+};
+
+static instr_stat_t      instr_stats[INSTR_REGION_COUNT];
+static volatile uint32_t instr_counters[INSTR_COUNTER_COUNT];
+
+#define SYSTICK_MASK  0x00ffffffu
+
+void instr_init(void) {
+    instr_init_core();
+    instr_reset();
+}
+
+void instr_init_core(void) {
+#if !ONCE_HOST
+    // SysTick 自由运行：处理器时钟、不开中断、24 位满量程重装
+    systick_hw->csr = 0;
+    systick_hw->rvr = SYSTICK_MASK;
+    systick_hw->cvr = 0;
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+#endif
+}
+
+// 返回一个“向上走”的周期计数，只有低 24 位有效
+uint32_t ONCE_HOT_FUNC(instr_now)(void) {
+#if !ONCE_HOST
+    // SysTick 是递减计数器，取反后变成递增
+    return ~systick_hw->cvr & SYSTICK_MASK;
+#else
+    // 主机仿真：用真实的纳秒时钟凑数，只用来确认代码路径能跑
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)ts.tv_nsec & SYSTICK_MASK;
+#endif
+}
+
+void ONCE_HOT_FUNC(instr_record)(instr_region_t region, uint32_t t0) {
+    uint32_t dt = (instr_now() - t0) & SYSTICK_MASK;
+    instr_stat_t *s = &instr_stats[region];
+
+    if (s->count == 0 || dt < s->min) {
+        s->min = dt;
+    }
+    if (dt > s->max) {
+        s->max = dt;
+    }
+    s->count++;
+    s->sum += dt;
+
+    uint32_t b = (dt > 1) ? 31u - (uint32_t)__builtin_clz(dt) : 0u;
+    if (b >= INSTR_HIST_BUCKETS) {
+        b = INSTR_HIST_BUCKETS - 1;
+    }
+    s->hist[b]++;
+}
+
+void ONCE_HOT_FUNC(instr_count)(instr_counter_t counter) {
+    instr_counters[counter]++;
+}
+
+void instr_get(instr_region_t region, instr_stat_t *out) {
+    uint32_t irq = save_and_disable_interrupts();
+    *out = instr_stats[region];
+    restore_interrupts(irq);
+}
+
+void instr_reset(void) {
+    uint32_t irq = save_and_disable_interrupts();
+    for (int i = 0; i < INSTR_REGION_COUNT; ++i) {
+        instr_stats[i] = (instr_stat_t){0};
+    }
+    for (int i = 0; i < INSTR_COUNTER_COUNT; ++i) {
+        instr_counters[i] = 0;
+    }
+    restore_interrupts(irq);
+}
+
+void instr_dump(void) {
+    printf("[INSTR] unit=cycles  clk_sys=%lu Hz\n", (unsigned long)clock_get_hz(clk_sys));
+    printf("[INSTR] %-20s %8s %8s %8s %8s\n", "region", "count", "min", "mean", "max");
+
+    for (int i = 0; i < INSTR_REGION_COUNT; ++i) {
+        instr_stat_t s;
+        instr_get((instr_region_t)i, &s);
+        if (s.count == 0) {
+            continue;
+        }
+        printf("[INSTR] %-20s %8lu %8lu %8lu %8lu\n",
+               INSTR_REGION_NAMES[i],
+               (unsigned long)s.count,
+               (unsigned long)s.min,
+               (unsigned long)(s.sum / s.count),
+               (unsigned long)s.max);
+
+        // 直方图只打非空的格：2^b:次数
+        printf("[INSTR]   hist");
+        for (int b = 0; b < INSTR_HIST_BUCKETS; ++b) {
+            if (s.hist[b]) {
+                printf(" 2^%d:%lu", b, (unsigned long)s.hist[b]);
+            }
+        }
+        printf("\n");
+    }
+
+    for (int i = 0; i < INSTR_COUNTER_COUNT; ++i) {
+        printf("[INSTR] counter %-20s %lu\n", INSTR_COUNTER_NAMES[i], (unsigned long)instr_counters[i]);
+    }
+}
+
+#endif // ONCE_INSTR
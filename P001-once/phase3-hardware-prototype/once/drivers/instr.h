@@ -0,0 +1,96 @@
+// instr.h
+// 热点路径计时：给代码段起名字，进出各打一次时间戳，
+// 在固定大小的 RAM 里累计 次数 / 最小 / 最大 / 平均 和 log2 直方图，外加几个争用计数，
+// 通过 USB 串口按需打印（见 once.c：收到 'p' 打印，'r' 清零）。
+//
+// 时间源是 SysTick（处理器时钟，24 位，125 MHz 下单段最长约 134 ms），单位是 CPU 周期。
+// board.h 里 ONCE_INSTR 为 0 时所有宏展开为空，instr.c 也不编出任何代码。
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "board.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 计时段：X(名字, 打印用的名字)
+#define INSTR_REGION_LIST(X)                    \
+    X(MAIN_LOOP,     "main_loop")               \
+    X(LCD_SUBMIT,    "lcd_submit")              \
+    X(LCD_SHOW_MMSS, "lcd_show_time_mmss")      \
+    X(LCD_PUMP,      "lcd_pump")                \
+    X(ENC_SAMPLE,    "encoder_sample_step")     \
+    X(ENC_PIO_IRQ,   "encoder_pio_irq")         \
+    X(ENC_READ,      "Encoder_ReadEvents")      \
+    X(FSM_STEP,      "timer_fsm_step")          \
+    X(SCORE,         "score_run")               \
+    X(DEADLINE_CB,   "deadline_alarm_cb")       \
+    X(BL_WRAP,       "backlight_wrap_irq")
+
+// 计数器：原来的 spin lock 已经换成无锁队列，这里数的是还剩下的“抢不到 / 被顶掉”的地方
+#define INSTR_COUNTER_LIST(X)                   \
+    X(ENC_RING_FULL,     "enc_ring_full")       \
+    X(LCD_BUS_BUSY,      "lcd_bus_busy")        \
+    X(LCD_FRAME_REPLACED,"lcd_frame_replaced")  \
+    X(UI_RING_FULL,      "ui_ring_full")        \
+    X(ENC_INVALID,       "enc_invalid")
+
+#define INSTR_ENUM_ENTRY(id, name) INSTR_##id,
+
+typedef enum {
+    INSTR_REGION_LIST(INSTR_ENUM_ENTRY)
+    INSTR_REGION_COUNT
+} instr_region_t;
+
+typedef enum {
+    INSTR_COUNTER_LIST(INSTR_ENUM_ENTRY)
+    INSTR_COUNTER_COUNT
+} instr_counter_t;
+
+// 直方图第 i 格：耗时落在 [2^i, 2^(i+1)) 个周期，第 0 格含 0 和 1
+#define INSTR_HIST_BUCKETS  24
+
+#if ONCE_INSTR
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t hist[INSTR_HIST_BUCKETS];
+} instr_stat_t;
+
+void instr_init(void);
+// SysTick 每个核各有一个；另一个核上也要计时的话，在那个核上再调一次
+void instr_init_core(void);
+uint32_t instr_now(void);
+void instr_record(instr_region_t region, uint32_t t0);
+void instr_count(instr_counter_t counter);
+void instr_get(instr_region_t region, instr_stat_t *out);
+void instr_dump(void);
+void instr_reset(void);
+
+// 一个段只在一种上下文里记（要么主循环，要么某个中断），所以不加锁
+#define INSTR_BEGIN(id)   const uint32_t instr_t0_##id = instr_now()
+#define INSTR_END(id)     instr_record(INSTR_##id, instr_t0_##id)
+#define INSTR_COUNT(id)   instr_count(INSTR_##id)
+
+#else
+
+#define INSTR_BEGIN(id)   do { } while (0)
+#define INSTR_END(id)     do { } while (0)
+#define INSTR_COUNT(id)   do { } while (0)
+
+static inline void instr_init(void) {}
+static inline void instr_init_core(void) {}
+static inline void instr_dump(void) {}
+static inline void instr_reset(void) {}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,420 @@
+#include "lcd_bus.h"
+#include "board.h"
+#include "instr.h"
+#include "pico/stdlib.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+#if LCD_BUS_HAS_HW
+#include "hardware/i2c.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#include "lcd_pcf8576_i2c.pio.h"
+#endif
+
+// PCF8576 地址：原例程用的是 8bit 总线值 0x70，硬件 I2C 外设要 7bit 地址
+#define IC_ADDR        0x70
+#define IC_ADDR_7BIT   (IC_ADDR >> 1)
+
+static lcd_bus_kind_t bus_kind = LCD_BUS_BITBANG;
+static bool           bus_ready = false;
+static lcd_bus_stats_t bus_stats;
+
+// 异步发送：当前在途帧的状态
+static volatile bool              bus_busy     = false;
+static volatile lcd_bus_done_cb_t bus_done_cb  = NULL;
+static uint32_t                   frame_t0_us  = 0;
+static size_t                     frame_len    = 0;
+
+#if LCD_BUS_HAS_HW
+// PIO 资源：程序只装一次，状态机按需申请
+static int  pio_sm         = -1;
+static int  pio_offset     = -1;
+
+// DMA 通道和中断入口只申请 / 挂一次
+static int  bus_dma_ch        = -1;
+static bool bus_irq_installed = false;
+
+// DMA 源缓冲：硬件 I2C 每字节一个 32 位 DATA_CMD 字；
+// PIO 每字节一个 16 位 FIFO 字，另加 START/STOP 指令字
+static uint32_t i2c_cmd_buf[1 + LCD_BUS_MAX_FRAME];
+static uint16_t pio_tx_buf[3 + 1 + LCD_BUS_MAX_FRAME + 5];
+#endif
+
+static const char *const BUS_NAMES[LCD_BUS_COUNT] = {
+    "bitbang",
+    "hw_i2c",
+    "pio",
+};
+
+// ========== GPIO 位模拟 ==========
+
+static void ONCE_HOT_FUNC(iic_delay)(void) {
+    // I²C 低速足够，给个几微秒的空隙就行
+    sleep_us(4);
+}
+
+static void ONCE_HOT_FUNC(iic_start)(void) {
+    gpio_set_dir(LCD_SDA_PIN, GPIO_OUT);
+    gpio_put(LCD_SDA_PIN, 1);
+    gpio_put(LCD_SCL_PIN, 1);
+    iic_delay();
+    gpio_put(LCD_SDA_PIN, 0);
+    iic_delay();
+    gpio_put(LCD_SCL_PIN, 0);
+    iic_delay();
+}
+
+static void ONCE_HOT_FUNC(iic_stop)(void) {
+    gpio_set_dir(LCD_SDA_PIN, GPIO_OUT);
+    gpio_put(LCD_SDA_PIN, 0);
+    iic_delay();
+    gpio_put(LCD_SCL_PIN, 1);
+    iic_delay();
+    gpio_put(LCD_SDA_PIN, 1);
+    iic_delay();
+}
+
+// 发送 1 字节并简单处理 ACK
+static void ONCE_HOT_FUNC(iic_send_byte)(uint8_t data) {
+    for (int i = 0; i < 8; ++i) {
+        gpio_set_dir(LCD_SDA_PIN, GPIO_OUT);
+        gpio_put(LCD_SDA_PIN, (data & 0x80) != 0);
+        iic_delay();
+        gpio_put(LCD_SCL_PIN, 1);
+        iic_delay();
+        gpio_put(LCD_SCL_PIN, 0);
+        iic_delay();
+        data <<= 1;
+    }
+
+    // 释放 SDA，读 ACK（低有效），为了安全不 busy-wait
+    gpio_put(LCD_SDA_PIN, 1);
+    gpio_set_dir(LCD_SDA_PIN, GPIO_IN);
+    iic_delay();
+    gpio_put(LCD_SCL_PIN, 1);
+    iic_delay();
+    (void)gpio_get(LCD_SDA_PIN);  // 如需检查 ACK，可在此读
+    gpio_put(LCD_SCL_PIN, 0);
+    iic_delay();
+    gpio_set_dir(LCD_SDA_PIN, GPIO_OUT);
+}
+
+static void bitbang_setup(void) {
+    gpio_init(LCD_SDA_PIN);
+    gpio_init(LCD_SCL_PIN);
+    gpio_set_dir(LCD_SDA_PIN, GPIO_OUT);
+    gpio_set_dir(LCD_SCL_PIN, GPIO_OUT);
+    gpio_put(LCD_SDA_PIN, 1);
+    gpio_put(LCD_SCL_PIN, 1);
+}
+
+static void ONCE_HOT_FUNC(bitbang_write)(const uint8_t *data, size_t len) {
+    iic_start();
+    iic_send_byte(IC_ADDR);
+    for (size_t i = 0; i < len; ++i) {
+        iic_send_byte(data[i]);
+    }
+    iic_stop();
+}
+
+// ========== 帧完成 ==========
+
+// 在中断里调用：记录耗时，放开总线，再回调上层（上层可能马上提交下一帧）
+static void ONCE_HOT_FUNC(bus_frame_done)(void) {
+    uint32_t dt = time_us_32() - frame_t0_us;
+    bus_stats.frames++;
+    bus_stats.bytes    += (uint32_t)frame_len;
+    bus_stats.last_us   = dt;
+    bus_stats.total_us += dt;
+    if (dt > bus_stats.max_us) {
+        bus_stats.max_us = dt;
+    }
+
+    lcd_bus_done_cb_t cb = bus_done_cb;
+    bus_done_cb = NULL;
+    bus_busy    = false;
+    if (cb) {
+        cb();
+    }
+}
+
+#if LCD_BUS_HAS_HW
+
+// ========== RP2040 硬件 I2C ==========
+
+static void ONCE_HOT_FUNC(i2c_irq_handler)(void) {
+    i2c_hw_t *hw = i2c_get_hw(LCD_I2C_INST);
+    uint32_t st = hw->intr_stat;
+
+    if (st & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        // 被 NAK 之类打断：FIFO 已被硬件清空，剩下的 DMA 也不要再喂了
+        dma_channel_abort((uint)bus_dma_ch);
+        (void)hw->clr_tx_abrt;
+        bus_stats.aborts++;
+    }
+    if (st & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+        (void)hw->clr_stop_det;
+        if (bus_busy) {
+            bus_frame_done();
+        }
+    }
+}
+
+static void hw_i2c_setup(void) {
+    i2c_init(LCD_I2C_INST, LCD_I2C_BAUD);
+    gpio_set_function(LCD_SDA_PIN, GPIO_FUNC_I2C);
+    gpio_set_function(LCD_SCL_PIN, GPIO_FUNC_I2C);
+    gpio_pull_up(LCD_SDA_PIN);
+    gpio_pull_up(LCD_SCL_PIN);
+
+    // 目标地址只有一个，初始化时写死；STOP / 异常用中断通知
+    i2c_hw_t *hw = i2c_get_hw(LCD_I2C_INST);
+    hw->enable = 0;
+    hw->tar    = IC_ADDR_7BIT;
+    hw->enable = 1;
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS;
+    (void)hw->clr_intr;
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+    irq_set_enabled(LCD_I2C_IRQ, true);
+}
+
+static void ONCE_HOT_FUNC(hw_i2c_start)(const uint8_t *data, size_t len) {
+    // 每字节一个 DATA_CMD 字，最后一个字节带 STOP；START 由控制器在空闲后自动产生
+    for (size_t i = 0; i < len; ++i) {
+        i2c_cmd_buf[i] = data[i];
+    }
+    i2c_cmd_buf[len - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    dma_channel_config c = dma_channel_get_default_config((uint)bus_dma_ch);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(LCD_I2C_INST, true));
+    dma_channel_configure((uint)bus_dma_ch, &c,
+                          &i2c_get_hw(LCD_I2C_INST)->data_cmd,
+                          i2c_cmd_buf, (uint)len, true);
+}
+
+// ========== PIO I2C ==========
+
+static void ONCE_HOT_FUNC(pio_irq_handler)(void) {
+    // 帧尾注入的 irq 指令在 STOP 发完之后才执行，置位即表示整帧结束
+    if (pio_sm >= 0 && pio_interrupt_get(LCD_PIO_INST, (uint)pio_sm)) {
+        pio_interrupt_clear(LCD_PIO_INST, (uint)pio_sm);
+        if (bus_busy) {
+            bus_frame_done();
+        }
+    }
+}
+
+static bool pio_setup(void) {
+    if (pio_offset < 0) {
+        if (!pio_can_add_program(LCD_PIO_INST, &lcd_pcf8576_i2c_program)) {
+            return false;
+        }
+        pio_offset = (int)pio_add_program(LCD_PIO_INST, &lcd_pcf8576_i2c_program);
+    }
+    if (pio_sm < 0) {
+        pio_sm = pio_claim_unused_sm(LCD_PIO_INST, false);
+        if (pio_sm < 0) {
+            return false;
+        }
+    }
+    lcd_pcf8576_i2c_program_init(LCD_PIO_INST, (uint)pio_sm, (uint)pio_offset,
+                                 LCD_SDA_PIN, LCD_SCL_PIN, LCD_I2C_BAUD);
+
+    pio_interrupt_clear(LCD_PIO_INST, (uint)pio_sm);
+    pio_set_irq0_source_enabled(LCD_PIO_INST, pis_interrupt0 + pio_sm, true);
+    irq_set_enabled(LCD_PIO_IRQ, true);
+    return true;
+}
+
+// 往 pio_tx_buf 里追加一段注入指令：先是计数字，再是 n 条指令
+static size_t ONCE_HOT_FUNC(pio_put_instrs)(size_t w, const uint16_t *instr, uint8_t n) {
+    pio_tx_buf[w++] = (uint16_t)((n - 1u) << 10);
+    for (uint8_t i = 0; i < n; ++i) {
+        pio_tx_buf[w++] = instr[i];
+    }
+    return w;
+}
+
+static void ONCE_HOT_FUNC(pio_start)(const uint8_t *data, size_t len) {
+    const uint16_t *tab = lcd_pcf8576_i2c_set_scl_sda_program_instructions;
+    const uint16_t start[] = { tab[LCD_PIO_SC1_SD0], tab[LCD_PIO_SC0_SD0] };
+    const uint16_t stop[]  = {
+        tab[LCD_PIO_SC0_SD0], tab[LCD_PIO_SC1_SD0], tab[LCD_PIO_SC1_SD1],
+        (uint16_t)pio_encode_irq_set(true, 0),   // 置本状态机的 IRQ 标志，通知 CPU 整帧结束
+    };
+
+    // 数据字：Instr = 0，数据左移一位，ACK 位填 1（释放 SDA）
+    size_t w = pio_put_instrs(0, start, 2);
+    pio_tx_buf[w++] = (uint16_t)((IC_ADDR << 1) | 1u);
+    for (size_t i = 0; i < len; ++i) {
+        pio_tx_buf[w++] = (uint16_t)((data[i] << 1) | 1u);
+    }
+    w = pio_put_instrs(w, stop, 4);
+
+    // 16 位 DMA 写 FIFO，正好配合 16 位 autopull
+    dma_channel_config c = dma_channel_get_default_config((uint)bus_dma_ch);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(LCD_PIO_INST, (uint)pio_sm, true));
+    dma_channel_configure((uint)bus_dma_ch, &c,
+                          &LCD_PIO_INST->txf[pio_sm],
+                          pio_tx_buf, (uint)w, true);
+}
+
+#endif // LCD_BUS_HAS_HW
+
+// ========== 对外接口 ==========
+
+// 释放当前方式占用的外设，把两根线还给 SIO
+static void bus_teardown(void) {
+    if (!bus_ready) {
+        return;
+    }
+    lcd_bus_wait_idle();
+
+    switch (bus_kind) {
+#if LCD_BUS_HAS_HW
+    case LCD_BUS_HW_I2C:
+        irq_set_enabled(LCD_I2C_IRQ, false);
+        i2c_get_hw(LCD_I2C_INST)->intr_mask = 0;
+        i2c_deinit(LCD_I2C_INST);
+        break;
+    case LCD_BUS_PIO:
+        pio_set_irq0_source_enabled(LCD_PIO_INST, pis_interrupt0 + pio_sm, false);
+        pio_sm_set_enabled(LCD_PIO_INST, (uint)pio_sm, false);
+        gpio_set_oeover(LCD_SDA_PIN, GPIO_OVERRIDE_NORMAL);
+        gpio_set_oeover(LCD_SCL_PIN, GPIO_OVERRIDE_NORMAL);
+        break;
+#endif
+    default:
+        break;
+    }
+    bus_ready = false;
+}
+
+bool lcd_bus_init(lcd_bus_kind_t kind) {
+    bus_teardown();
+
+    bool ok = true;
+#if LCD_BUS_HAS_HW
+    if (bus_dma_ch < 0) {
+        bus_dma_ch = dma_claim_unused_channel(true);
+    }
+    if (!bus_irq_installed) {
+        irq_set_exclusive_handler(LCD_I2C_IRQ, i2c_irq_handler);
+        irq_add_shared_handler(LCD_PIO_IRQ, pio_irq_handler,
+                               PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        bus_irq_installed = true;
+    }
+
+    switch (kind) {
+    case LCD_BUS_HW_I2C:
+        hw_i2c_setup();
+        break;
+    case LCD_BUS_PIO:
+        ok = pio_setup();
+        break;
+    default:
+        kind = LCD_BUS_BITBANG;
+        break;
+    }
+#else
+    // 没有外设可用（主机仿真），只剩位模拟
+    ok = (kind == LCD_BUS_BITBANG);
+#endif
+
+    if (!ok) {
+        kind = LCD_BUS_BITBANG;
+    }
+    if (kind == LCD_BUS_BITBANG) {
+        bitbang_setup();
+    }
+
+    bus_kind  = kind;
+    bus_ready = true;
+    return ok;
+}
+
+lcd_bus_kind_t lcd_bus_kind(void) {
+    return bus_kind;
+}
+
+const char *lcd_bus_name(lcd_bus_kind_t kind) {
+    return (kind < LCD_BUS_COUNT) ? BUS_NAMES[kind] : "?";
+}
+
+bool ONCE_HOT_FUNC(lcd_bus_is_async)(void) {
+    return bus_kind != LCD_BUS_BITBANG;
+}
+
+bool ONCE_HOT_FUNC(lcd_bus_busy)(void) {
+    return bus_busy;
+}
+
+void lcd_bus_wait_idle(void) {
+    while (bus_busy) {
+        tight_loop_contents();
+    }
+}
+
+bool ONCE_HOT_FUNC(lcd_bus_write_async)(const uint8_t *data, size_t len, lcd_bus_done_cb_t done) {
+    if (len == 0 || len > LCD_BUS_MAX_FRAME) {
+        return false;
+    }
+
+    // 占总线要和中断里的 bus_frame_done 互斥
+    uint32_t irq = save_and_disable_interrupts();
+    if (bus_busy) {
+        restore_interrupts(irq);
+        INSTR_COUNT(LCD_BUS_BUSY);
+        return false;
+    }
+    bus_busy    = true;
+    bus_done_cb = done;
+    restore_interrupts(irq);
+
+    frame_t0_us = time_us_32();
+    frame_len   = len;
+
+    switch (bus_kind) {
+#if LCD_BUS_HAS_HW
+    case LCD_BUS_HW_I2C:
+        hw_i2c_start(data, len);
+        break;
+    case LCD_BUS_PIO:
+        pio_start(data, len);
+        break;
+#endif
+    default:
+        // 位模拟没有后台引擎，只能当场发完
+        bitbang_write(data, len);
+        bus_frame_done();
+        break;
+    }
+    return true;
+}
+
+void ONCE_HOT_FUNC(lcd_bus_write)(const uint8_t *data, size_t len) {
+    lcd_bus_wait_idle();
+    if (lcd_bus_write_async(data, len, NULL)) {
+        lcd_bus_wait_idle();
+    }
+}
+
+void lcd_bus_get_stats(lcd_bus_stats_t *out) {
+    *out = bus_stats;
+}
+
+void lcd_bus_reset_stats(void) {
+    bus_stats = (lcd_bus_stats_t){0};
+}
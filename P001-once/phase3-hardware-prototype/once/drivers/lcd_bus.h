@@ -0,0 +1,68 @@
+// lcd_bus.h
+// PCF8576 总线传输层：硬件 I2C / PIO I2C / GPIO 位模拟 三选一
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    LCD_BUS_BITBANG = 0,   // 原来的 gpio_put + sleep_us 位模拟，作为兜底
+    LCD_BUS_HW_I2C,        // RP2040 I2C 外设，400 kHz Fast-mode
+    LCD_BUS_PIO,           // PIO 状态机实现的只写 I2C
+    LCD_BUS_COUNT
+} lcd_bus_kind_t;
+
+// 单帧最多字节数（不含设备地址）：数据指针 + 4 个数字位，留点余量
+#define LCD_BUS_MAX_FRAME  8
+
+// 异步帧发完后的回调，在中断上下文里执行
+typedef void (*lcd_bus_done_cb_t)(void);
+
+// 每帧传输耗时统计（单位 us，从 START 到 STOP 发完）
+typedef struct {
+    uint32_t frames;       // 已发送帧数
+    uint32_t bytes;        // 已发送字节数（不含地址字节）
+    uint32_t last_us;      // 最近一帧耗时
+    uint32_t max_us;       // 最长一帧耗时
+    uint64_t total_us;     // 累计耗时，配合 frames 求平均
+    uint32_t aborts;       // 硬件 I2C 报 TX_ABRT（NAK 等）的次数
+} lcd_bus_stats_t;
+
+/**
+ * 切换 / 初始化传输方式。可以在运行时反复调用，会先释放当前占用的外设。
+ * 返回 false 表示该方式不可用（例如 PIO 没有空闲状态机），此时回退到位模拟。
+ */
+bool lcd_bus_init(lcd_bus_kind_t kind);
+
+lcd_bus_kind_t lcd_bus_kind(void);
+const char *lcd_bus_name(lcd_bus_kind_t kind);
+
+/**
+ * 发送一帧：START + 设备地址 + data[0..len) + STOP，阻塞到最后一位发完。
+ */
+void lcd_bus_write(const uint8_t *data, size_t len);
+
+/**
+ * 异步发送一帧：data 拷进内部缓冲后立刻返回，由 DMA 喂硬件 I2C / PIO，
+ * 发完（STOP 出去之后）在中断里调用 done（可以为 NULL）。
+ * 总线忙或帧太长时返回 false，什么都不发。
+ * 位模拟方式没有后台引擎，会当场同步发完再回调。
+ */
+bool lcd_bus_write_async(const uint8_t *data, size_t len, lcd_bus_done_cb_t done);
+
+// 当前方式是否真的能在后台发送（位模拟返回 false）
+bool lcd_bus_is_async(void);
+bool lcd_bus_busy(void);
+void lcd_bus_wait_idle(void);
+
+void lcd_bus_get_stats(lcd_bus_stats_t *out);
+void lcd_bus_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,13 +1,17 @@
 #include "lcd_pcf8576.h"
+#include "lcd_bus.h"
 #include "board.h"           // ← 就这一句，让它接管 PIN 定义
+#include "instr.h"
+#include "backlight.h"
 #include "pico/stdlib.h"
+#include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include "hardware/gpio.h"
+#include "hardware/sync.h"
 
 
-// 这里沿用原例程里的常量
-#define IC_ADDR        0x70      // 这里是 8bit 总线值，照搬原例程
+// 这里沿用原例程里的常量（设备地址见 lcd_bus.c）
 #define LCD_MODE_SET   0xC9      // 模式设置命令
 
 // 段码表：0~9 和 "-"
@@ -27,6 +31,7 @@ static const uint8_t LCD_Digit[11] = {
 
 #define DOT_ON   0x01
 #define COL_ON   0x01
+#define BLANK    0x00
 
 #define LCD_ON   0xff
 #define LCD_OFF  0x00
@@ -36,120 +41,335 @@ static const uint8_t LCD_Digit[11] = {
 #define ADDR_NUM3 0x10
 #define ADDR_NUM4 0x18
 
-// 内部函数声明
-static void iic_start(void);
-static void iic_stop(void);
-static void iic_delay(void);
-static void iic_send_byte(uint8_t data);
-
-// 对原 SendNBitToRAM 的等价实现
-static inline void SendNBitToRAM(uint8_t data) {
-    iic_send_byte(data);
-}
-
-static void iic_delay(void) {
-    // I²C 低速足够，给个几微秒的空隙就行
-    sleep_us(4);
-}
-
-static void iic_start(void) {
-    gpio_set_dir(LCD_SDA_PIN, GPIO_OUT);
-    gpio_put(LCD_SDA_PIN, 1);
-    gpio_put(LCD_SCL_PIN, 1);
-    iic_delay();
-    gpio_put(LCD_SDA_PIN, 0);
-    iic_delay();
-    gpio_put(LCD_SCL_PIN, 0);
-    iic_delay();
-}
-
-static void iic_stop(void) {
-    gpio_set_dir(LCD_SDA_PIN, GPIO_OUT);
-    gpio_put(LCD_SDA_PIN, 0);
-    iic_delay();
-    gpio_put(LCD_SCL_PIN, 1);
-    iic_delay();
-    gpio_put(LCD_SDA_PIN, 1);
-    iic_delay();
-}
-
-// 发送 1 字节并简单处理 ACK
-static void iic_send_byte(uint8_t data) {
-    for (int i = 0; i < 8; ++i) {
-        gpio_set_dir(LCD_SDA_PIN, GPIO_OUT);
-        gpio_put(LCD_SDA_PIN, (data & 0x80) != 0);
-        iic_delay();
-        gpio_put(LCD_SCL_PIN, 1);
-        iic_delay();
-        gpio_put(LCD_SCL_PIN, 0);
-        iic_delay();
-        data <<= 1;
+#define LCD_DIGITS        4
+#define LCD_DIGIT_STRIDE  (ADDR_NUM2 - ADDR_NUM1)   // 每个数字位占 8 个段地址
+
+// 两段脏位之间隔着不超过这么多个干净位时并成一帧：
+// 多写 1 个干净字节，比新开一帧（START + 地址 + 指针 + STOP）便宜
+#define LCD_MERGE_GAP     2
+
+// 显存影子：记录 PCF8576 里当前（含正在发送的帧）每个数字位的段码，只发有变化的位
+static uint8_t lcd_shadow[LCD_DIGITS];
+static bool    lcd_shadow_valid = false;
+static lcd_pcf8576_stats_t lcd_stats;
+
+// 异步队列：只留“最新想显示的内容”一份，还没发出去就被新内容覆盖
+static uint8_t       lcd_pending[LCD_DIGITS];
+static volatile bool lcd_pending_valid = false;
+
+// 把 next[] 和影子比对，取第一段连续（或间隔很小）的脏位拼成一帧自增地址写入，
+// 同时更新影子。返回帧长度，0 表示已经没有要发的
+static size_t ONCE_HOT_FUNC(lcd_next_frame)(const uint8_t next[LCD_DIGITS], uint8_t frame[1 + LCD_DIGITS]) {
+    int first = -1;
+    int last  = -1;
+    for (int j = 0; j < LCD_DIGITS; ++j) {
+        if (lcd_shadow_valid && lcd_shadow[j] == next[j]) {
+            continue;
+        }
+        if (first < 0) {
+            first = j;
+        } else if (j - last - 1 > LCD_MERGE_GAP) {
+            break;
+        }
+        last = j;
+    }
+    if (first < 0) {
+        return 0;
     }
 
-    // 释放 SDA，读 ACK（低有效），为了安全不 busy-wait
-    gpio_put(LCD_SDA_PIN, 1);
-    gpio_set_dir(LCD_SDA_PIN, GPIO_IN);
-    iic_delay();
-    gpio_put(LCD_SCL_PIN, 1);
-    iic_delay();
-    (void)gpio_get(LCD_SDA_PIN);  // 如需检查 ACK，可在此读
-    gpio_put(LCD_SCL_PIN, 0);
-    iic_delay();
-    gpio_set_dir(LCD_SDA_PIN, GPIO_OUT);
+    int n = last - first + 1;
+    frame[0] = (uint8_t)(first * LCD_DIGIT_STRIDE);
+    for (int k = 0; k < n; ++k) {
+        frame[1 + k]          = next[first + k];
+        lcd_shadow[first + k] = next[first + k];
+    }
+    // 影子无效时所有位都算脏，间隔为 0，一帧就覆盖了全部四位
+    lcd_shadow_valid = true;
+
+    lcd_stats.bytes_sent += (uint32_t)n + 2;   // 设备地址 + 数据指针 + 数据
+    lcd_stats.frames_sent++;
+    return (size_t)n + 1;
+}
+
+// 同步刷新：把所有脏位发完才返回
+// requested 是不做比对时原本要发的总线字节数，用来统计省了多少
+static void ONCE_HOT_FUNC(lcd_flush)(const uint8_t next[LCD_DIGITS], uint32_t requested) {
+    lcd_pcf8576_wait_idle();
+    lcd_stats.bytes_requested += requested;
+
+    uint8_t frame[1 + LCD_DIGITS];
+    size_t len = lcd_next_frame(next, frame);
+    if (len == 0) {
+        lcd_stats.frames_skipped++;
+        return;
+    }
+    do {
+        lcd_bus_write(frame, len);
+        len = lcd_next_frame(next, frame);
+    } while (len != 0);
+}
+
+static void lcd_pump(void);
+
+// 在中断（上一帧发完的回调）或关中断的线程上下文里调用：拿最新内容发下一帧
+static void ONCE_HOT_FUNC(lcd_pump_frame)(void) {
+    if (!lcd_pending_valid) {
+        return;
+    }
+
+    uint8_t frame[1 + LCD_DIGITS];
+    size_t len = lcd_next_frame(lcd_pending, frame);
+    if (len == 0) {
+        lcd_pending_valid = false;
+        return;
+    }
+
+    // 影子已经追上 pending，就不用再留着了；否则等这一帧发完再来
+    bool done = true;
+    for (int i = 0; i < LCD_DIGITS; ++i) {
+        if (lcd_shadow[i] != lcd_pending[i]) {
+            done = false;
+        }
+    }
+    if (done) {
+        lcd_pending_valid = false;
+    }
+
+    if (!lcd_bus_write_async(frame, len, lcd_pump)) {
+        // 理论上不会发生（只在总线空闲时调用，一帧最多 5 字节）。这一帧没发出去，
+        // 也就没有完成回调再来 pump：不能留着 pending，否则 wait_idle 会一直等。
+        // 影子失效，下一次 lcd_submit 整帧重写
+        lcd_shadow_valid  = false;
+        lcd_pending_valid = false;
+    }
+}
+
+static void ONCE_HOT_FUNC(lcd_pump)(void) {
+    INSTR_BEGIN(LCD_PUMP);
+    lcd_pump_frame();
+    INSTR_END(LCD_PUMP);
+}
+
+// 异步刷新：记下最新内容就返回，总线空闲时立刻启动第一帧
+static void ONCE_HOT_FUNC(lcd_submit)(const uint8_t next[LCD_DIGITS], uint32_t requested) {
+    if (!lcd_bus_is_async()) {
+        // 位模拟没有后台引擎，退化为同步刷新
+        lcd_flush(next, requested);
+        return;
+    }
+
+    INSTR_BEGIN(LCD_SUBMIT);
+    uint32_t irq = save_and_disable_interrupts();
+    lcd_stats.bytes_requested += requested;
+    if (lcd_pending_valid) {
+        lcd_stats.frames_replaced++;   // 上一份还没发出去，直接被新内容顶掉
+        INSTR_COUNT(LCD_FRAME_REPLACED);
+    }
+    for (int i = 0; i < LCD_DIGITS; ++i) {
+        lcd_pending[i] = next[i];
+    }
+    lcd_pending_valid = true;
+    if (!lcd_bus_busy()) {
+        lcd_pump();
+        if (!lcd_bus_busy()) {
+            // 内容和屏上一致，一个字节都不用发
+            lcd_stats.frames_skipped++;
+        }
+    }
+    restore_interrupts(irq);
+    INSTR_END(LCD_SUBMIT);
+}
+
+static void lcd_mmss_to_digits(uint8_t minutes, uint8_t seconds, uint8_t out[LCD_DIGITS]) {
+    if (minutes > 59) minutes = 59;
+    if (seconds > 59) seconds = 59;
+
+    // 你可以根据实物的实际段映射，决定哪些位要加 DOT/COL
+    out[0] = LCD_Digit[minutes / 10];                   // 第 1 位：分钟十位
+    out[1] = LCD_Digit[minutes % 10];                   // 第 2 位：分钟个位
+    out[2] = LCD_Digit[seconds / 10];                   // 第 3 位：秒钟十位
+    out[3] = (uint8_t)(LCD_Digit[seconds % 10] + COL_ON);  // 第 4 位：秒钟个位，同时点亮冒号
+}
+
+// M.SS.d：分钟一位、秒两位、0.1 s 一位，用小数点分开，冒号不亮
+static void lcd_mssd_to_digits(uint8_t minutes, uint8_t seconds, uint8_t tenths, uint8_t out[LCD_DIGITS]) {
+    if (minutes > 9) minutes = 9;
+    if (seconds > 59) seconds = 59;
+    if (tenths > 9) tenths = 9;
+
+    out[0] = (uint8_t)(LCD_Digit[minutes] + DOT_ON);
+    out[1] = LCD_Digit[seconds / 10];
+    out[2] = (uint8_t)(LCD_Digit[seconds % 10] + DOT_ON);
+    out[3] = LCD_Digit[tenths];
+}
+
+// H:MM：第 1 位空着，小时一位，冒号照常亮
+static void lcd_hmm_to_digits(uint8_t hours, uint8_t minutes, uint8_t out[LCD_DIGITS]) {
+    if (hours > 9) hours = 9;
+    if (minutes > 59) minutes = 59;
+
+    out[0] = BLANK;
+    out[1] = LCD_Digit[hours];
+    out[2] = LCD_Digit[minutes / 10];
+    out[3] = (uint8_t)(LCD_Digit[minutes % 10] + COL_ON);
 }
 
 // ========== 对外接口 ==========
 
 void lcd_pcf8576_init(void) {
-    // I2C 相关初始化
-    gpio_init(LCD_SDA_PIN);
-    gpio_init(LCD_SCL_PIN);
-    gpio_set_dir(LCD_SDA_PIN, GPIO_OUT);
-    gpio_set_dir(LCD_SCL_PIN, GPIO_OUT);
-    gpio_put(LCD_SDA_PIN, 1);
-    gpio_put(LCD_SCL_PIN, 1);
-
-    // 背光
+    // 总线初始化：默认方式由 board.h 的 LCD_BUS_DEFAULT 决定
+    lcd_bus_init(LCD_BUS_DEFAULT);
+
+    // 背光引脚先拉到灭：显存和模式都还没定，亮了只会照出一屏乱码
     lcd_backlight_init();
-    lcd_backlight_on();
 
-    iic_start();
-    SendNBitToRAM(IC_ADDR);
-    SendNBitToRAM(LCD_MODE_SET);
-    iic_stop();
+    const uint8_t frame[] = { LCD_MODE_SET };
+    lcd_bus_write(frame, sizeof(frame));
+
+    // 上电后显存内容未知，第一次刷新必须整帧写
+    lcd_shadow_valid = false;
 }
 
+bool lcd_pcf8576_set_bus(lcd_bus_kind_t kind) {
+    lcd_pcf8576_wait_idle();
+    bool ok = lcd_bus_init(kind);
 
-void lcd_pcf8576_display_all(uint8_t value) {
-    iic_start();
-    SendNBitToRAM(IC_ADDR);
-    SendNBitToRAM(0x00);          // 起始地址
-    for (int i = 0; i < 4; ++i) { // 四个“数字位”
-        SendNBitToRAM(value);
+    // 切换后重发一次模式设置，保证控制器状态一致
+    const uint8_t frame[] = { LCD_MODE_SET };
+    lcd_bus_write(frame, sizeof(frame));
+    return ok;
+}
+
+void lcd_pcf8576_invalidate(void) {
+    lcd_pcf8576_wait_idle();
+    lcd_shadow_valid = false;
+}
+
+bool lcd_pcf8576_busy(void) {
+    return lcd_pending_valid || lcd_bus_busy();
+}
+
+void lcd_pcf8576_wait_idle(void) {
+    while (lcd_pcf8576_busy()) {
+        tight_loop_contents();
     }
-    iic_stop();
+}
+
+void lcd_pcf8576_submit_mmss(uint8_t minutes, uint8_t seconds) {
+    uint8_t next[LCD_DIGITS];
+    lcd_mmss_to_digits(minutes, seconds, next);
+    lcd_submit(next, 12);
+}
+
+// 10 Hz 刷新时通常只有 0.1 s 那一位变，影子比对后只发 1 个字节
+void lcd_pcf8576_submit_mssd(uint8_t minutes, uint8_t seconds, uint8_t tenths) {
+    uint8_t next[LCD_DIGITS];
+    lcd_mssd_to_digits(minutes, seconds, tenths, next);
+    lcd_submit(next, 12);
+}
+
+void lcd_pcf8576_submit_hmm(uint8_t hours, uint8_t minutes) {
+    uint8_t next[LCD_DIGITS];
+    lcd_hmm_to_digits(hours, minutes, next);
+    lcd_submit(next, 12);
+}
+
+void lcd_pcf8576_submit_digits(uint8_t d1, uint8_t d2, uint8_t d3, uint8_t d4) {
+    const uint8_t next[LCD_DIGITS] = {
+        (uint8_t)(d1 + DOT_ON),
+        (uint8_t)(d2 + DOT_ON),
+        (uint8_t)(d3 + DOT_ON),
+        (uint8_t)(d4 + COL_ON),
+    };
+    lcd_submit(next, 6);
+}
+
+void lcd_pcf8576_get_stats(lcd_pcf8576_stats_t *out) {
+    *out = lcd_stats;
+}
+
+void lcd_pcf8576_reset_stats(void) {
+    lcd_stats = (lcd_pcf8576_stats_t){0};
+}
+
+void lcd_pcf8576_display_all(uint8_t value) {
+    const uint8_t next[LCD_DIGITS] = { value, value, value, value };
+    lcd_flush(next, 6);
 }
 
 void lcd_pcf8576_display_single(uint8_t addr, uint8_t value) {
-    iic_start();
-    SendNBitToRAM(IC_ADDR);
-    SendNBitToRAM(addr);
-    SendNBitToRAM(value);
-    iic_stop();
+    lcd_pcf8576_wait_idle();
+
+    uint8_t idx = addr / LCD_DIGIT_STRIDE;
+
+    // 不是数字位起始地址的写入绕过影子，直接发，并让影子失效
+    if ((addr % LCD_DIGIT_STRIDE) != 0 || idx >= LCD_DIGITS) {
+        const uint8_t frame[] = { addr, value };
+        lcd_bus_write(frame, sizeof(frame));
+        lcd_stats.bytes_requested += 3;
+        lcd_stats.bytes_sent      += 3;
+        lcd_stats.frames_sent++;
+        lcd_shadow_valid = false;
+        return;
+    }
+
+    uint8_t next[LCD_DIGITS];
+    for (int i = 0; i < LCD_DIGITS; ++i) {
+        next[i] = lcd_shadow[i];
+    }
+    next[idx] = value;
+
+    // 影子无效时只能老老实实发这一位，不能把未知的其他位也写出去
+    if (!lcd_shadow_valid) {
+        const uint8_t frame[] = { addr, value };
+        lcd_bus_write(frame, sizeof(frame));
+        lcd_stats.bytes_requested += 3;
+        lcd_stats.bytes_sent      += 3;
+        lcd_stats.frames_sent++;
+        return;
+    }
+    lcd_flush(next, 3);
 }
 
 void lcd_pcf8576_display_digits(uint8_t d1, uint8_t d2, uint8_t d3, uint8_t d4) {
-    iic_start();
-    SendNBitToRAM(IC_ADDR);
-    SendNBitToRAM(0x00);
-
     // 保持和原例程一致：前三位加小数点，最后一位加 COL
-    SendNBitToRAM(d1 + DOT_ON);
-    SendNBitToRAM(d2 + DOT_ON);
-    SendNBitToRAM(d3 + DOT_ON);
-    SendNBitToRAM(d4 + COL_ON);
+    const uint8_t next[LCD_DIGITS] = {
+        (uint8_t)(d1 + DOT_ON),
+        (uint8_t)(d2 + DOT_ON),
+        (uint8_t)(d3 + DOT_ON),
+        (uint8_t)(d4 + COL_ON),
+    };
+    lcd_flush(next, 6);
+}
 
-    iic_stop();
+// 依次用三种方式各写 LCD_BUS_REPORT_FRAMES 帧 "88:88"，打印每帧耗时，最后切回原方式
+#define LCD_BUS_REPORT_FRAMES  32
+
+void lcd_pcf8576_bus_report(void) {
+    lcd_bus_kind_t prev = lcd_bus_kind();
+
+    for (int k = 0; k < LCD_BUS_COUNT; ++k) {
+        if (!lcd_pcf8576_set_bus((lcd_bus_kind_t)k)) {
+            printf("[LCD] bus=%-8s unavailable\n", lcd_bus_name((lcd_bus_kind_t)k));
+            continue;
+        }
+        lcd_bus_reset_stats();
+        for (int i = 0; i < LCD_BUS_REPORT_FRAMES; ++i) {
+            lcd_pcf8576_invalidate();   // 绕过影子比对，保证每次都真的上总线
+            lcd_pcf8576_display_digits(LCD_Digit[8], LCD_Digit[8], LCD_Digit[8], LCD_Digit[8]);
+        }
+
+        lcd_bus_stats_t st;
+        lcd_bus_get_stats(&st);
+        printf("[LCD] bus=%-8s frame=5B  avg=%4lu us  max=%4lu us\n",
+               lcd_bus_name((lcd_bus_kind_t)k),
+               (unsigned long)(st.total_us / st.frames),
+               (unsigned long)st.max_us);
+    }
+
+    lcd_pcf8576_set_bus(prev);
+    lcd_bus_reset_stats();
+    lcd_pcf8576_reset_stats();
 }
 
 static int bl_step = 0;
@@ -233,6 +453,23 @@ void lcd_pcf8576_demo(void) {
     }
 }
 
+#if ONCE_BL_PWM
+
+// 挂在 PWM 上：开 / 关就是平时的亮度 / 0，闪烁之类的图案见 backlight.h
+void lcd_backlight_init(void) {
+    backlight_init();           // 默认关灯
+}
+
+void lcd_backlight_on(void) {
+    backlight_set(LCD_BL_LEVEL_ON);
+}
+
+void lcd_backlight_off(void) {
+    backlight_set(0);
+}
+
+#else
+
 void lcd_backlight_init(void) {
     gpio_init(LCD_BL_PIN);
     gpio_set_dir(LCD_BL_PIN, GPIO_OUT);
@@ -260,39 +497,15 @@ void lcd_backlight_off(void) {
 #endif
 }
 
-// 显示 MM:SS，分钟和秒都限定在 0~59
-void lcd_pcf8576_show_time_mmss(uint8_t minutes, uint8_t seconds) {
-    if (minutes > 59) minutes = 59;
-    if (seconds > 59) seconds = 59;
+#endif // ONCE_BL_PWM
 
-    uint8_t m_t = minutes / 10;
-    uint8_t m_u = minutes % 10;
-    uint8_t s_t = seconds / 10;
-    uint8_t s_u = seconds % 10;
+// 显示 MM:SS，分钟和秒都限定在 0~59；同步版本，发完才返回
+void lcd_pcf8576_show_time_mmss(uint8_t minutes, uint8_t seconds) {
+    INSTR_BEGIN(LCD_SHOW_MMSS);
+    uint8_t next[LCD_DIGITS];
+    lcd_mmss_to_digits(minutes, seconds, next);
 
-    // 这里用原来那套单独写寄存器的方式，保持灵活度
-    // 你可以根据实物的实际段映射，决定哪些位要加 DOT/COL
-    iic_start();
-    SendNBitToRAM(IC_ADDR);
-    SendNBitToRAM(ADDR_NUM1);
-    SendNBitToRAM(LCD_Digit[m_t]);             // 第 1 位：分钟十位
-    iic_stop();
-
-    iic_start();
-    SendNBitToRAM(IC_ADDR);
-    SendNBitToRAM(ADDR_NUM2);
-    SendNBitToRAM(LCD_Digit[m_u]);             // 第 2 位：分钟个位
-    iic_stop();
-
-    iic_start();
-    SendNBitToRAM(IC_ADDR);
-    SendNBitToRAM(ADDR_NUM3);
-    SendNBitToRAM(LCD_Digit[s_t]);             // 第 3 位：秒钟十位
-    iic_stop();
-
-    iic_start();
-    SendNBitToRAM(IC_ADDR);
-    SendNBitToRAM(ADDR_NUM4);
-    SendNBitToRAM(LCD_Digit[s_u] + COL_ON);    // 第 4 位：秒钟个位，同时点亮冒号
-    iic_stop();
+    // 原来是 4 帧各 3 字节；现在只发变化的位，通常只有秒个位 1 帧 3 字节
+    lcd_flush(next, 12);
+    INSTR_END(LCD_SHOW_MMSS);
 }
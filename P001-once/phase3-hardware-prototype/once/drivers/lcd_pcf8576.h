@@ -2,17 +2,51 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "lcd_bus.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// 显存影子统计：bytes_requested 是不做比对时本该上总线的字节数，
+// bytes_sent 是实际发出的字节数（都含设备地址和数据指针）
+typedef struct {
+    uint32_t bytes_requested;
+    uint32_t bytes_sent;
+    uint32_t frames_sent;
+    uint32_t frames_skipped;   // 内容完全没变、一个字节都没发的刷新次数
+    uint32_t frames_replaced;  // 异步提交时，还没发出去就被更新内容顶掉的次数
+} lcd_pcf8576_stats_t;
+
+// 总线 + 模式设置；背光保持灭，等第一帧写完由调用方打开
 void lcd_pcf8576_init(void);
 void lcd_pcf8576_display_all(uint8_t value);
 void lcd_pcf8576_display_single(uint8_t addr, uint8_t value);
 void lcd_pcf8576_display_digits(uint8_t d1, uint8_t d2, uint8_t d3, uint8_t d4);
 void lcd_pcf8576_show_time_mmss(uint8_t minutes, uint8_t seconds);
 
+// 异步版本：只记下最新内容就返回，由 DMA + 中断在后台把差异发出去；
+// 还没来得及发的旧内容会被新提交直接覆盖。位模拟方式下退化为同步
+void lcd_pcf8576_submit_mmss(uint8_t minutes, uint8_t seconds);
+void lcd_pcf8576_submit_digits(uint8_t d1, uint8_t d2, uint8_t d3, uint8_t d4);
+// 计时显示的另外两种格式：M.SS.d（不到 10 分钟，带 0.1 s）和 H:MM（1 小时以上）
+void lcd_pcf8576_submit_mssd(uint8_t minutes, uint8_t seconds, uint8_t tenths);
+void lcd_pcf8576_submit_hmm(uint8_t hours, uint8_t minutes);
+bool lcd_pcf8576_busy(void);          // 还有内容没发完（含在途帧）
+void lcd_pcf8576_wait_idle(void);
+
+// 让显存影子失效，下一次刷新整帧重写（例如怀疑 LCD 被干扰复位时）
+void lcd_pcf8576_invalidate(void);
+void lcd_pcf8576_get_stats(lcd_pcf8576_stats_t *out);
+void lcd_pcf8576_reset_stats(void);
+
+// 运行时切换总线传输方式（硬件 I2C / PIO / 位模拟），返回 false 表示已回退到位模拟
+bool lcd_pcf8576_set_bus(lcd_bus_kind_t kind);
+
+// 调试用：三种传输方式各写一批帧，打印每帧平均/最长耗时（会覆盖当前显示内容）
+void lcd_pcf8576_bus_report(void);
+
 
 // 背光相关
 void lcd_backlight_init(void);
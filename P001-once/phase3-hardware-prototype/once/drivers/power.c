@@ -0,0 +1,246 @@
+// power.c
+
+#include "drivers/power.h"
+#include "drivers/backlight.h"
+
+#if ONCE_POWER
+
+#include "drivers/encoder_ec11.h"
+#include "drivers/trace.h"
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/pll.h"
+#include "hardware/xosc.h"
+#include "hardware/gpio.h"
+#include "hardware/timer.h"
+
+#if LIB_PICO_STDIO_USB
+#include "pico/stdio_usb.h"
+#include "tusb.h"
+#endif
+
+// SDK 开机时（runtime_init_clocks）用的同一组数，老版本 SDK 头里没有就用这里的
+#ifndef XOSC_HZ
+#define XOSC_HZ                (12 * MHZ)
+#endif
+#ifndef PLL_COMMON_REFDIV
+#define PLL_COMMON_REFDIV      1
+#endif
+#ifndef PLL_SYS_VCO_FREQ_HZ
+#define PLL_SYS_VCO_FREQ_HZ    (1500 * MHZ)
+#define PLL_SYS_POSTDIV1       6
+#define PLL_SYS_POSTDIV2       2
+#endif
+#ifndef PLL_USB_VCO_FREQ_HZ
+#define PLL_USB_VCO_FREQ_HZ    (1200 * MHZ)
+#define PLL_USB_POSTDIV1       5
+#define PLL_USB_POSTDIV2       5
+#endif
+#ifndef SYS_CLK_HZ
+#define SYS_CLK_HZ             (125 * MHZ)
+#endif
+#ifndef USB_CLK_HZ
+#define USB_CLK_HZ             (48 * MHZ)
+#endif
+
+#define POWER_RTC_HZ           46875
+
+// 叫醒 DORMANT 的引脚和边沿：A/B 两个方向都算，按键只认按下
+#define POWER_WAKE_AB          (GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE)
+#define POWER_WAKE_C           GPIO_IRQ_EDGE_FALL
+
+typedef struct {
+    power_level_t level;
+    uint64_t      last_kick_us;
+    power_stats_t stats;
+} power_t;
+
+static power_t pwr;
+
+// ========== 时钟切换 ==========
+
+static void clk_sys_to_pll_sys(void) {
+    pll_init(pll_sys, PLL_COMMON_REFDIV, PLL_SYS_VCO_FREQ_HZ, PLL_SYS_POSTDIV1, PLL_SYS_POSTDIV2);
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                    CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS, SYS_CLK_HZ, SYS_CLK_HZ);
+}
+
+static void clk_sys_to_slow(void) {
+    // 先切走再关 pll_sys：clk_sys 是无毛刺切换的
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                    CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, USB_CLK_HZ,
+                    ONCE_POWER_SLOW_KHZ * KHZ);
+    pll_deinit(pll_sys);
+}
+
+// pll_usb 和挂在它上面的几个外设时钟，DORMANT 前停、醒来后原样恢复
+static void usb_side_start(void) {
+    pll_init(pll_usb, PLL_COMMON_REFDIV, PLL_USB_VCO_FREQ_HZ, PLL_USB_POSTDIV1, PLL_USB_POSTDIV2);
+    clock_configure(clk_usb, 0, CLOCKS_CLK_USB_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, USB_CLK_HZ, USB_CLK_HZ);
+    clock_configure(clk_adc, 0, CLOCKS_CLK_ADC_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, USB_CLK_HZ, USB_CLK_HZ);
+    clock_configure(clk_rtc, 0, CLOCKS_CLK_RTC_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, USB_CLK_HZ, POWER_RTC_HZ);
+    clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, USB_CLK_HZ, USB_CLK_HZ);
+}
+
+static void usb_side_stop(void) {
+    clock_stop(clk_usb);
+    clock_stop(clk_adc);
+    clock_stop(clk_rtc);
+    clock_stop(clk_peri);
+    pll_deinit(pll_usb);
+}
+
+static void wake_pins_enable(bool on) {
+    gpio_set_dormant_irq_enabled(ENCODER_EC11_PIN_A, POWER_WAKE_AB, on);
+    gpio_set_dormant_irq_enabled(ENCODER_EC11_PIN_B, POWER_WAKE_AB, on);
+    gpio_set_dormant_irq_enabled(ENCODER_EC11_PIN_C, POWER_WAKE_C, on);
+    if (!on) {
+        gpio_acknowledge_irq(ENCODER_EC11_PIN_A, POWER_WAKE_AB);
+        gpio_acknowledge_irq(ENCODER_EC11_PIN_B, POWER_WAKE_AB);
+        gpio_acknowledge_irq(ENCODER_EC11_PIN_C, POWER_WAKE_C);
+    }
+}
+
+// 插着 USB 就不睡：只看串口终端开没开（DTR）不够，枚举过的设备 pll_usb 一停，主机就当它死了。
+// 只有 VBUS 没枚举（充电器，或者主机还没来得及）也算，免得刚插上就睡过去
+static bool dormant_allowed(void) {
+#if ONCE_DUAL_CORE
+    return false;
+#elif LIB_PICO_STDIO_USB
+    if (tud_mounted() || stdio_usb_connected()) {
+        return false;
+    }
+#ifdef PICO_VBUS_PIN
+    if (gpio_get(PICO_VBUS_PIN)) {
+        return false;
+    }
+#endif
+    return true;
+#else
+    return true;
+#endif
+}
+
+static void note_us(uint32_t us, uint32_t *last, uint32_t *max) {
+    *last = us;
+    if (us > *max) {
+        *max = us;
+    }
+}
+
+// ========== 三级之间的切换 ==========
+
+static void go_full(void) {
+    if (pwr.level != POWER_SLOW) {
+        return;
+    }
+    uint32_t t0 = time_us_32();
+    clk_sys_to_pll_sys();
+    pwr.level = POWER_FULL;
+    note_us(time_us_32() - t0, &pwr.stats.last_resume_us, &pwr.stats.max_resume_us);
+    TRACE(POWER, POWER_FULL, pwr.stats.last_resume_us, 0);
+}
+
+static void go_slow(uint64_t now_us) {
+    clk_sys_to_slow();
+    pwr.level = POWER_SLOW;
+    pwr.stats.slow_entries++;
+    TRACE(POWER, POWER_SLOW, 0, (now_us - pwr.last_kick_us) / 1000);
+}
+
+static void go_dormant(uint64_t now_us) {
+    TRACE(POWER, POWER_DORMANT, 0, (now_us - pwr.last_kick_us) / 1000);
+    pwr.level = POWER_DORMANT;
+    pwr.stats.dormant_entries++;
+
+    // clk_ref / clk_sys 先退到晶振上，再停两个 PLL；唤醒引脚最后开，免得还没睡就被叫醒
+    clock_configure(clk_ref, CLOCKS_CLK_REF_CTRL_SRC_VALUE_XOSC_CLKSRC, 0, XOSC_HZ, XOSC_HZ);
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLK_REF, 0, XOSC_HZ, XOSC_HZ);
+    pll_deinit(pll_sys);
+    usb_side_stop();
+    backlight_suspend();   // PWM 跟着 clk_sys 停，背光脚先交给 SIO 按亮 / 灭输出
+    wake_pins_enable(true);
+
+    xosc_dormant();   // 停在这里；返回时晶振已经稳定，timer 接着走
+
+    uint32_t t0 = time_us_32();
+    wake_pins_enable(false);
+    usb_side_start();
+    clk_sys_to_pll_sys();
+    backlight_resume();
+    pwr.level = POWER_FULL;
+    note_us(time_us_32() - t0, &pwr.stats.last_wake_us, &pwr.stats.max_wake_us);
+
+    // 叫醒芯片的如果是按键，那条边沿 GPIO 中断没看到，按电平补上
+    Encoder_Resync();
+    TRACE(POWER, POWER_FULL, pwr.stats.last_wake_us, 0);
+}
+
+// ========== 对外接口 ==========
+
+void power_init(void) {
+    clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, USB_CLK_HZ, USB_CLK_HZ);
+#if LIB_PICO_STDIO_USB && defined(PICO_VBUS_PIN)
+    gpio_init(PICO_VBUS_PIN);   // 输入、不拉，板子上经分压接 VBUS
+#endif
+    pwr.level        = POWER_FULL;
+    pwr.last_kick_us = time_us_64();
+}
+
+void power_kick(uint64_t now_us) {
+    pwr.last_kick_us = now_us;
+    go_full();
+}
+
+bool power_idle(uint64_t now_us, bool quiet) {
+    uint64_t idle_us = now_us - pwr.last_kick_us;
+
+    if (pwr.level == POWER_FULL && idle_us >= (uint64_t)ONCE_POWER_SLOW_MS * 1000u) {
+        go_slow(now_us);
+    }
+    if (pwr.level == POWER_SLOW && quiet && dormant_allowed() &&
+        idle_us >= (uint64_t)ONCE_POWER_DORMANT_MS * 1000u) {
+        go_dormant(now_us);
+        pwr.last_kick_us = time_us_64();
+        return true;
+    }
+    return false;
+}
+
+uint64_t power_next_us(bool quiet) {
+    switch (pwr.level) {
+    case POWER_FULL:
+        return pwr.last_kick_us + (uint64_t)ONCE_POWER_SLOW_MS * 1000u;
+    case POWER_SLOW:
+        if (!quiet || !dormant_allowed()) {
+            return UINT64_MAX;
+        }
+        return pwr.last_kick_us + (uint64_t)ONCE_POWER_DORMANT_MS * 1000u;
+    default:
+        return UINT64_MAX;
+    }
+}
+
+power_level_t power_level(void) {
+    return pwr.level;
+}
+
+void power_get_stats(power_stats_t *out) {
+    *out = pwr.stats;
+}
+
+void power_dump(void) {
+    static const char *const LEVEL_NAMES[] = { "full", "slow", "dormant" };
+    printf("[PWR] level=%s clk_sys=%lu kHz idle=%lu ms\n", LEVEL_NAMES[pwr.level],
+           (unsigned long)(clock_get_hz(clk_sys) / KHZ),
+           (unsigned long)((time_us_64() - pwr.last_kick_us) / 1000));
+    printf("[PWR] slow=%lu dormant=%lu  resume last/max %lu/%lu us  wake last/max %lu/%lu us\n",
+           (unsigned long)pwr.stats.slow_entries, (unsigned long)pwr.stats.dormant_entries,
+           (unsigned long)pwr.stats.last_resume_us, (unsigned long)pwr.stats.max_resume_us,
+           (unsigned long)pwr.stats.last_wake_us, (unsigned long)pwr.stats.max_wake_us);
+}
+
+#endif // ONCE_POWER
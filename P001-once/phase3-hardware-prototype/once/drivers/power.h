@@ -0,0 +1,87 @@
+// power.h
+// 空闲省电：主循环告诉它“有人动了”和“准备睡了”，它按空闲时长分三级：
+//   FULL    ：clk_sys 125 MHz，挂在 pll_sys 上；
+//   SLOW    ：没人碰 ONCE_POWER_SLOW_MS，clk_sys 改从 pll_usb 分频（ONCE_POWER_SLOW_KHZ），
+//             pll_sys 关掉。timer / alarm 走 clk_ref，不受影响，DONE 的背光闪烁照常；
+//   DORMANT ：没人碰 ONCE_POWER_DORMANT_MS、又没有任何截止时间在跑（实际上就是 SET），
+//             两个 PLL 全停、晶振停振，编码器 A/B/C 任一边沿叫醒。
+// PCF8576 自己保持显存，屏上内容不变。PWM 背光在 DORMANT 里跟着 clk_sys 停，
+// 进去之前背光脚切回普通 GPIO 按亮 / 灭输出（暗一些的亮度也按亮），醒来再切回 PWM；
+// 背光正在播图案（渐亮、脉冲）时不进 DORMANT，闪烁本来就只在 DONE 里。
+//
+// clk_peri 开机时就改挂 pll_usb 48 MHz，之后 clk_sys 怎么变，硬件 I2C 的波特率都不变。
+// PIO（编码器解码、PIO 版 I2C）跟着 clk_sys 走，降频后只是采得慢 / 发得慢，结果不变。
+//
+// 不进 DORMANT 的情况：插着 USB（VBUS 有电或者主机枚举了，开没开串口终端都算；
+// pll_usb 一停主机那边就掉线），或者双核构建（core 1 可能正在 LCD 总线上）。这两种只降频。
+//
+// 醒来的代价：DORMANT 先等晶振起振（约 1 ms，这段 timer 也停着，量不到），
+// 再锁两个 PLL、切回时钟，这一段记在 power_stats_t 里；一格至少 4 个边沿，
+// 叫醒芯片的是第一条，醒来以后采样器 / PIO 看到的是新电平，这一格不会丢。
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "board.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    POWER_FULL = 0,
+    POWER_SLOW,
+    POWER_DORMANT,
+} power_level_t;
+
+typedef struct {
+    uint32_t slow_entries;
+    uint32_t dormant_entries;
+    uint32_t last_resume_us;   // SLOW -> FULL：锁 pll_sys + 切 clk_sys
+    uint32_t max_resume_us;
+    uint32_t last_wake_us;     // DORMANT 醒来（晶振已稳）-> 满速，不含晶振起振
+    uint32_t max_wake_us;
+} power_stats_t;
+
+#if ONCE_POWER
+
+/**
+ * 开机第一件事（在 LCD 总线初始化之前）：把 clk_peri 挪到 pll_usb 上。
+ */
+void power_init(void);
+
+/**
+ * 有人动了（编码器事件），或者当前状态不该省电（计时中、暂停）：马上回满速，重新计空闲。
+ */
+void power_kick(uint64_t now_us);
+
+/**
+ * 主循环准备睡之前调。空闲够久就降一级；quiet 表示没有任何截止时间在跑，可以进 DORMANT。
+ * 进了 DORMANT 并且已经醒来、回到满速时返回 true（叫醒它的那一格在编码器事件环里等着）。
+ */
+bool power_idle(uint64_t now_us, bool quiet);
+
+/**
+ * 下一次该降级的时刻，主循环睡觉时别睡过了；降不下去了返回 UINT64_MAX。quiet 同 power_idle()。
+ */
+uint64_t power_next_us(bool quiet);
+
+power_level_t power_level(void);
+void power_get_stats(power_stats_t *out);
+
+// 'w' 打印
+void power_dump(void);
+
+#else
+
+static inline void power_init(void) {}
+static inline void power_kick(uint64_t now_us) { (void)now_us; }
+static inline bool power_idle(uint64_t now_us, bool quiet) { (void)now_us; (void)quiet; return false; }
+static inline uint64_t power_next_us(bool quiet) { (void)quiet; return UINT64_MAX; }
+
+#endif // ONCE_POWER
+
+#ifdef __cplusplus
+}
+#endif
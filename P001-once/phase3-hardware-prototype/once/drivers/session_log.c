@@ -0,0 +1,233 @@
+// session_log.c
+
+#include "drivers/session_log.h"
+
+#if ONCE_SESSION_LOG
+
+#include "drivers/flash_log.h"
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+
+#define SLOG_OFFS          (PICO_FLASH_SIZE_BYTES - SESSION_LOG_SECTORS * FLASH_SECTOR_SIZE)
+#define SLOG_MAGIC         0x474f4c53u   // "SLOG"
+#define SCAL_OFFS          (SLOG_OFFS - SESSION_CALIB_SECTORS * FLASH_SECTOR_SIZE)
+#define SCAL_MAGIC         0x4c414353u   // "SCAL"
+
+// 统计快照：占一整页，前 16 字节是序号 / 长度 / 校验，没用到的尾巴填 0xff
+typedef struct {
+    uint32_t seq;
+    uint16_t len;          // sizeof(calib_t)，结构变了旧快照自然作废
+    uint8_t  reserved;
+    uint8_t  check;        // 整页其余 255 个字节求和取反
+    uint8_t  pad[8];
+    calib_t  calib;
+} scal_snapshot_t;
+
+typedef union {
+    scal_snapshot_t s;
+    uint8_t         page[FLASH_PAGE_SIZE];
+} scal_page_t;
+
+_Static_assert(sizeof(scal_snapshot_t) <= FLASH_PAGE_SIZE, "calibration snapshot must fit one page");
+
+typedef struct {
+    flash_log_t recs;
+    flash_log_t snaps;
+
+    // 等着写 flash 的记录：只有主循环读写，不用加锁
+    session_rec_t pending[SESSION_LOG_PENDING];
+    uint32_t      pend_head;
+    uint32_t      pend_tail;
+
+    calib_t calib;
+    bool    calib_dirty;   // RAM 里的统计比 flash 里最新的快照新
+
+    uint32_t dropped;
+    uint32_t snapshots;
+} slog_t;
+
+static slog_t slog;
+
+// 读写快照时用的整页缓冲
+static scal_page_t slog_snap;
+
+static uint8_t sum_check(const void *p, size_t len, size_t check_at) {
+    const uint8_t *b = (const uint8_t *)p;
+    uint8_t sum = 0;
+    for (size_t i = 0; i < len; ++i) {
+        if (i != check_at) {
+            sum += b[i];
+        }
+    }
+    return (uint8_t)~sum;
+}
+
+static uint8_t rec_check(const session_rec_t *r) {
+    return sum_check(r, offsetof(session_rec_t, check), SIZE_MAX);
+}
+
+static uint8_t snap_check(const scal_page_t *p) {
+    return sum_check(p->page, sizeof(p->page), offsetof(scal_snapshot_t, check));
+}
+
+// 最新的快照写了一半就退一份（少算一次停表），再不行就从零开始
+static void load_calib(void) {
+    for (uint32_t back = 0; back < 2; ++back) {
+        if (!flash_log_read(&slog.snaps, back, slog_snap.page)) {
+            break;
+        }
+        const scal_snapshot_t *s = &slog_snap.s;
+        if (s->seq == flash_log_next_seq(&slog.snaps) - 1 - back &&
+            s->len == sizeof(calib_t) && s->check == snap_check(&slog_snap)) {
+            slog.calib = s->calib;
+            return;
+        }
+    }
+    calib_init(&slog.calib);
+}
+
+void session_log_init(void) {
+    memset(&slog, 0, sizeof(slog));
+    flash_log_init(&slog.recs, SLOG_OFFS, SESSION_LOG_SECTORS, sizeof(session_rec_t), SLOG_MAGIC);
+    flash_log_init(&slog.snaps, SCAL_OFFS, SESSION_CALIB_SECTORS, FLASH_PAGE_SIZE, SCAL_MAGIC);
+    load_calib();
+}
+
+void session_log_append(uint16_t target_sec, uint64_t actual_us, uint8_t score) {
+    if (calib_update(&slog.calib, target_sec, actual_us)) {
+        slog.calib_dirty = true;
+    }
+
+    if (slog.pend_head - slog.pend_tail >= SESSION_LOG_PENDING) {
+        slog.dropped++;
+        return;
+    }
+    session_rec_t *r = &slog.pending[slog.pend_head % SESSION_LOG_PENDING];
+    r->actual_us  = actual_us;
+    r->seq        = 0;   // 写 flash 的时候才定
+    r->target_sec = target_sec;
+    r->score      = score;
+    r->check      = 0;
+    slog.pend_head++;
+}
+
+static void write_record(void) {
+    session_rec_t r = slog.pending[slog.pend_tail % SESSION_LOG_PENDING];
+    r.seq   = flash_log_next_seq(&slog.recs);
+    r.check = rec_check(&r);
+    if (flash_log_write(&slog.recs, &r) == FLASH_LOG_DONE) {
+        slog.pend_tail++;
+    }
+}
+
+static void write_snapshot(void) {
+    scal_snapshot_t *s = &slog_snap.s;
+    memset(slog_snap.page, 0xff, sizeof(slog_snap.page));
+    s->seq      = flash_log_next_seq(&slog.snaps);
+    s->len      = sizeof(calib_t);
+    s->reserved = 0;
+    s->calib    = slog.calib;
+    s->check    = snap_check(&slog_snap);
+    if (flash_log_write(&slog.snaps, slog_snap.page) == FLASH_LOG_DONE) {
+        slog.calib_dirty = false;
+        slog.snapshots++;
+    }
+}
+
+bool session_log_service(void) {
+    if (slog.pend_tail != slog.pend_head) {
+        write_record();
+    } else if (slog.calib_dirty) {
+        write_snapshot();
+    }
+    return slog.pend_tail != slog.pend_head || slog.calib_dirty;
+}
+
+bool session_log_read(uint32_t back, session_rec_t *out) {
+    if (!flash_log_read(&slog.recs, back, out)) {
+        return false;
+    }
+    return out->seq == flash_log_next_seq(&slog.recs) - 1 - back && out->check == rec_check(out);
+}
+
+void session_log_get_stats(session_log_stats_t *out) {
+    const flash_log_stats_t *a = &slog.recs.stats;
+    const flash_log_stats_t *b = &slog.snaps.stats;
+
+    out->records        = flash_log_next_seq(&slog.recs) - 1;
+    out->pending        = slog.pend_head - slog.pend_tail;
+    out->dropped        = slog.dropped;
+    out->snapshots      = slog.snapshots;
+    out->programs       = a->programs + b->programs;
+    out->erases         = a->erases + b->erases;
+    out->failures       = a->failures + b->failures;
+    out->max_program_us = a->max_program_us > b->max_program_us ? a->max_program_us : b->max_program_us;
+    out->max_erase_us   = a->max_erase_us > b->max_erase_us ? a->max_erase_us : b->max_erase_us;
+}
+
+const calib_t *session_log_calib(void) {
+    return &slog.calib;
+}
+
+void session_log_dump(uint32_t n) {
+    session_log_stats_t st;
+    session_log_get_stats(&st);
+    printf("[SLOG] records=%lu pending=%lu dropped=%lu snapshots=%lu programs=%lu erases=%lu failures=%lu\n",
+           (unsigned long)st.records, (unsigned long)st.pending, (unsigned long)st.dropped,
+           (unsigned long)st.snapshots, (unsigned long)st.programs, (unsigned long)st.erases,
+           (unsigned long)st.failures);
+    printf("[SLOG] irq-off max: program %lu us, erase %lu us\n",
+           (unsigned long)st.max_program_us, (unsigned long)st.max_erase_us);
+
+    for (uint32_t back = 0; back < n && back < st.records; ++back) {
+        session_rec_t r;
+        if (!session_log_read(back, &r)) {
+            printf("[SLOG] #%lu  (erased or torn)\n", (unsigned long)(st.records - back));
+            continue;
+        }
+        uint32_t ms = (uint32_t)(r.actual_us / 1000);
+        printf("[SLOG] #%lu  target=%us actual=%lu.%03lus score=",
+               (unsigned long)r.seq, r.target_sec, (unsigned long)(ms / 1000), (unsigned long)(ms % 1000));
+        if (r.score > 100) {
+            printf("-\n");
+        } else {
+            printf("%u\n", r.score);
+        }
+    }
+}
+
+// bp 打成百分数，例如 -1.25%；sign 为 false 时不带正号
+static void print_bp(const char *name, int32_t bp, bool sign) {
+    uint32_t a = (uint32_t)(bp < 0 ? -bp : bp);
+    printf(" %s=%s%lu.%02lu%%", name, bp < 0 ? "-" : (sign ? "+" : ""),
+           (unsigned long)(a / 100), (unsigned long)(a % 100));
+}
+
+void session_log_dump_calib(void) {
+    for (uint8_t i = 0; i < CALIB_BUCKETS; ++i) {
+        calib_summary_t s;
+        calib_summary(&slog.calib.b[i], &s);
+        if (i == CALIB_BUCKETS - 1) {
+            printf("[CAL] >%us", calib_bucket_max_sec(i - 1));
+        } else {
+            printf("[CAL] <=%us", calib_bucket_max_sec(i));
+        }
+        printf(" n=%lu", (unsigned long)s.n);
+        if (s.n > 0) {
+            print_bp("mean", s.mean_bp, true);
+            print_bp("sd", (int32_t)s.stddev_bp, false);
+            print_bp("ew", s.ew_bp, true);
+            print_bp("p10", s.p10_bp, true);
+            print_bp("p50", s.p50_bp, true);
+            print_bp("p90", s.p90_bp, true);
+        }
+        printf("\n");
+    }
+}
+
+#endif // ONCE_SESSION_LOG
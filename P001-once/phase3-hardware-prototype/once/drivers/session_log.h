@@ -0,0 +1,110 @@
+// session_log.h
+// 会话记录：每次停表（目标、实际 us、分数）写一条 16 字节的定长记录到 flash 最后几个扇区，
+// 断电不丢。只追加不改写，扇区写满了按轮转擦下一个（drivers/flash_log.h）。
+//
+// 同时维护按目标分档的校准统计（app/calib.h）：停表时在 RAM 里 O(1) 更新，
+// 整份统计（240 字节）作为一页快照追加到紧挨着的另外两个扇区，开机读最新一份，不用翻历史记录。
+//
+// 擦 / 写 flash 要关中断（写一页约 0.5 ms，擦一个扇区约 45 ms），所以 session_log_append() 只进 RAM，
+// 真正的 flash 操作由主循环在不计时的时候（SET / DONE，暂停也算计时中）调 session_log_service() 一次做一步，
+// 每步的关中断时间都量出来记到事件日志里（FLASH）。
+// USB 串口：'h' 打印最近几条记录和最长关中断时间，'c' 打印各档校准统计。
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "board.h"
+#include "app/calib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 占用 flash 最后几个扇区（每个 4 KB，255 条记录）；至少 2 个才能轮转
+#ifndef SESSION_LOG_SECTORS
+#define SESSION_LOG_SECTORS   4
+#endif
+
+// 校准统计快照紧挨在会话记录前面（每个扇区 15 份）
+#ifndef SESSION_CALIB_SECTORS
+#define SESSION_CALIB_SECTORS 2
+#endif
+
+// RAM 里等着写 flash 的记录数，满了丢最新的一条并计数
+#define SESSION_LOG_PENDING   4
+
+// 'h' 命令打印最近多少条
+#define SESSION_LOG_DUMP_LAST 10
+
+typedef struct {
+    uint64_t actual_us;    // 停表时的实际计时
+    uint32_t seq;          // 全局序号，从 1 起
+    uint16_t target_sec;   // 目标时间，0 = 秒表
+    uint8_t  score;        // 0..100，SCORE_NONE = 没有分数
+    uint8_t  check;        // 前 15 个字节求和取反，挡住写了一半的记录
+} session_rec_t;
+
+_Static_assert(sizeof(session_rec_t) == 16, "session record must stay 16 bytes");
+
+typedef struct {
+    uint32_t records;          // 写进过 flash 的记录总数（含已经被轮转擦掉的）
+    uint32_t pending;          // 还在 RAM 队列里的
+    uint32_t dropped;          // 队列满丢掉的
+    uint32_t snapshots;        // 写了几份校准统计快照
+    uint32_t programs;         // 写页次数（记录 + 快照，下同）
+    uint32_t erases;           // 擦扇区次数
+    uint32_t failures;         // flash_safe_execute 没拿到另一个核
+    uint32_t max_program_us;   // 写页时关中断的最长时间
+    uint32_t max_erase_us;     // 擦扇区时关中断的最长时间
+} session_log_stats_t;
+
+#if ONCE_SESSION_LOG
+
+/**
+ * 开机扫描：读各扇区头找到头扇区和下一个空槽，再读最新一份校准统计。只读 flash，不擦不写。
+ */
+void session_log_init(void);
+
+/**
+ * 记一条会话：拷进 RAM 队列、更新校准统计，马上返回，中断里不要调。
+ */
+void session_log_append(uint16_t target_sec, uint64_t actual_us, uint8_t score);
+
+/**
+ * 做一步 flash 操作（写一页或擦一个扇区），期间关中断。先写会话记录，再写统计快照。
+ * 返回 true 表示队列里还有没写完的，主循环先别睡。计时中不要调。
+ */
+bool session_log_service(void);
+
+/**
+ * 读倒数第 back 条（0 = 最新）。已经被擦掉、或者那条没写完整时返回 false。
+ */
+bool session_log_read(uint32_t back, session_rec_t *out);
+
+void session_log_get_stats(session_log_stats_t *out);
+
+// 当前的校准统计（RAM 里那份，和 flash 里最新的快照一致或者更新）
+const calib_t *session_log_calib(void);
+
+// 打印最近 n 条和统计（USB 串口 'h' 命令）
+void session_log_dump(uint32_t n);
+
+// 打印各档校准统计（USB 串口 'c' 命令）
+void session_log_dump_calib(void);
+
+#else
+
+static inline void session_log_init(void) {}
+static inline void session_log_append(uint16_t target_sec, uint64_t actual_us, uint8_t score) {
+    (void)target_sec;
+    (void)actual_us;
+    (void)score;
+}
+static inline bool session_log_service(void) { return false; }
+
+#endif // ONCE_SESSION_LOG
+
+#ifdef __cplusplus
+}
+#endif
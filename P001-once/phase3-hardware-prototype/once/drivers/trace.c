@@ -0,0 +1,153 @@
+// trace.c
+
+#include "trace.h"
+
+#if ONCE_TRACE
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+#define TRACE_RING_MASK    (TRACE_RING_SIZE - 1)
+#define TRACE_RINGS        (2 * 2)     // 2 个核 × （线程，中断）
+#define TRACE_PER_LINE     8           // 一行最多几条记录
+
+typedef struct {
+    trace_rec_t       rec[TRACE_RING_SIZE];
+    volatile uint32_t head;      // 只由生产者写
+    volatile uint32_t tail;      // 只由 drain 写
+    volatile uint32_t dropped;   // 只由生产者写
+    uint32_t          dropped_reported;
+} trace_ring_t;
+
+static trace_ring_t trace_rings[TRACE_RINGS];
+
+static inline uint8_t trace_src(void) {
+    uint8_t src = (__get_current_exception() != 0) ? 1u : 0u;
+    if (get_core_num() != 0) {
+        src |= 2u;
+    }
+    return src;
+}
+
+void trace_init(void) {
+    for (int i = 0; i < TRACE_RINGS; ++i) {
+        trace_rings[i].head = 0;
+        trace_rings[i].tail = 0;
+        trace_rings[i].dropped = 0;
+        trace_rings[i].dropped_reported = 0;
+    }
+}
+
+void ONCE_HOT_FUNC(trace_emit)(trace_event_t id, uint16_t a0, int32_t a1, int32_t a2) {
+    uint8_t src = trace_src();
+    trace_ring_t *r = &trace_rings[src];
+
+    uint32_t head = r->head;
+    if (head - r->tail >= TRACE_RING_SIZE) {
+        r->dropped++;
+        return;
+    }
+    trace_rec_t *rec = &r->rec[head & TRACE_RING_MASK];
+    rec->t_us = time_us_32();
+    rec->id   = (uint8_t)id;
+    rec->src  = src;
+    rec->a0   = a0;
+    rec->a1   = a1;
+    rec->a2   = a2;
+    __dmb();
+    r->head = head + 1;
+}
+
+bool trace_pending(void) {
+    for (int i = 0; i < TRACE_RINGS; ++i) {
+        const trace_ring_t *r = &trace_rings[i];
+        if (r->tail != r->head || r->dropped != r->dropped_reported) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void put_hex(char *out, const uint8_t *p, size_t n) {
+    static const char HEX[] = "0123456789abcdef";
+    for (size_t i = 0; i < n; ++i) {
+        out[2 * i]     = HEX[p[i] >> 4];
+        out[2 * i + 1] = HEX[p[i] & 0x0f];
+    }
+}
+
+uint32_t trace_drain(uint32_t max) {
+    char line[3 + TRACE_PER_LINE * 2 * sizeof(trace_rec_t) + 2];
+    size_t   w = 0;
+    uint32_t n = 0;
+
+    while (n < max) {
+        trace_rec_t rec;
+        int best = -1;
+
+        // 先补报丢失：丢了多少条算在 DROPPED 里，时间戳用 drain 的时刻
+        for (int i = 0; i < TRACE_RINGS && best < 0; ++i) {
+            trace_ring_t *r = &trace_rings[i];
+            uint32_t dropped = r->dropped;
+            if (dropped != r->dropped_reported) {
+                rec = (trace_rec_t){ time_us_32(), TRACE_DROPPED, trace_src(),
+                                     (uint16_t)i, (int32_t)(dropped - r->dropped_reported), 0 };
+                r->dropped_reported = dropped;
+                best = i;
+            }
+        }
+
+        // 再按时间戳从各个环里挑最早的一条
+        if (best < 0) {
+            uint32_t best_t = 0;
+            for (int i = 0; i < TRACE_RINGS; ++i) {
+                trace_ring_t *r = &trace_rings[i];
+                if (r->tail == r->head) {
+                    continue;
+                }
+                uint32_t t = r->rec[r->tail & TRACE_RING_MASK].t_us;
+                if (best < 0 || (int32_t)(t - best_t) < 0) {
+                    best   = i;
+                    best_t = t;
+                }
+            }
+            if (best < 0) {
+                break;
+            }
+            trace_ring_t *r = &trace_rings[best];
+            __dmb();
+            rec = r->rec[r->tail & TRACE_RING_MASK];
+            __dmb();
+            r->tail = r->tail + 1;
+        }
+
+        if (w == 0) {
+            line[w++] = '#';
+            line[w++] = 'T';
+            line[w++] = ' ';
+        }
+        put_hex(&line[w], (const uint8_t *)&rec, sizeof(rec));
+        w += 2 * sizeof(rec);
+        n++;
+
+        if ((n % TRACE_PER_LINE) == 0) {
+            line[w++] = '\n';
+            fwrite(line, 1, w, stdout);
+            w = 0;
+        }
+    }
+
+    if (w > 0) {
+        line[w++] = '\n';
+        fwrite(line, 1, w, stdout);
+    }
+    if (n > 0) {
+        fflush(stdout);
+    }
+    return n;
+}
+
+#endif // ONCE_TRACE
@@ -0,0 +1,91 @@
+// trace.h
+// 二进制追踪：热点路径上不再 printf，只往 RAM 环里写一条 16 字节的定长记录
+// （事件号 + us 时间戳 + 三个参数），主循环空闲时由 trace_drain() 成批发到 USB 串口。
+// 串口上每批是一行 "#T <十六进制记录...>"，和普通 printf 输出混在一起也能分开；
+// 主机上用 host/trace_decode 还原成可读日志。
+//
+// 每个（核，线程 / 中断）上下文一个单生产者环，写入不加锁也不关中断；
+// 同一个核上的中断彼此同优先级、不会嵌套，所以中断这一侧也只算一个生产者。
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "board.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 事件表：X(名字, 解码时的格式)。格式按顺序吃 a0 / a1 / a2，用不完的参数直接忽略
+#define TRACE_EVENT_LIST(X)                                                     \
+    X(BOOT,     "boot A=%ld B=%ld C=%ld")                                       \
+    X(DROPPED,  "dropped ring=%ld records=%ld")                                 \
+    X(KEY,      "key state=%ld elapsed_ms=%ld target=%ld")                      \
+    X(ENC,      "enc step=%ld before=%ld after=%ld")                            \
+    X(ENC_DROP, "enc_ring_full type=%ld overflows=%ld")                         \
+    X(TICK,     "tick irq_late_us=%ld elapsed_ms=%ld loop_late_us=%ld")         \
+    X(LOOP,     "loop state=%ld iter_per_s=%ld")                                \
+    X(CPU,      "cpu core=%ld busy_permille=%ld wakeups=%ld")                   \
+    X(UI_DROP,  "ui_ring_full msg=%ld")                                        \
+    X(SCORE,    "score points=%ld err_ms=%ld target=%ld")                       \
+    X(FLASH,    "flash op=%ld(0=program,1=erase) irq_off_us=%ld sector=%ld")    \
+    X(BOOT_PHASE, "boot_phase phase=%ld t_us=%ld")                              \
+    X(BOOT_SLOW,  "boot_slow phase=%ld t_us=%ld budget_us=%ld")                 \
+    X(POWER,    "power level=%ld(0=full,1=slow,2=dormant) wake_us=%ld idle_ms=%ld") \
+    X(TICK_NO_ALARM, "tick_no_alarm state=%ld first_in_us=%ld period_us=%ld")
+
+#define TRACE_ENUM_ENTRY(id, fmt) TRACE_##id,
+
+typedef enum {
+    TRACE_EVENT_LIST(TRACE_ENUM_ENTRY)
+    TRACE_EVENT_COUNT
+} trace_event_t;
+
+// 线上格式，小端，16 字节
+typedef struct {
+    uint32_t t_us;    // 低 32 位 us 时间戳（约 71 分钟回绕一次，解码时展开）
+    uint8_t  id;      // trace_event_t
+    uint8_t  src;     // bit0 = 中断上下文，bit1 = core 1
+    uint16_t a0;
+    int32_t  a1;
+    int32_t  a2;
+} trace_rec_t;
+
+_Static_assert(sizeof(trace_rec_t) == 16, "trace record must stay 16 bytes");
+
+// 每个环的记录数，必须是 2 的幂
+#define TRACE_RING_SIZE   64
+
+#if ONCE_TRACE
+
+void trace_init(void);
+
+// 写一条记录；环满就丢这一条并计数，下一次 drain 时补一条 DROPPED
+void trace_emit(trace_event_t id, uint16_t a0, int32_t a1, int32_t a2);
+
+/**
+ * 最多发出 max 条记录（按时间戳合并各个环），返回实际发出的条数。
+ * 在主循环空闲、不赶时间的时候调用。
+ */
+uint32_t trace_drain(uint32_t max);
+
+// 还有没发出去的记录（或者没补报的丢失）
+bool trace_pending(void);
+
+#define TRACE(id, a0, a1, a2)  trace_emit(TRACE_##id, (uint16_t)(a0), (int32_t)(a1), (int32_t)(a2))
+
+#else
+
+static inline void trace_init(void) {}
+static inline uint32_t trace_drain(uint32_t max) { (void)max; return 0; }
+static inline bool trace_pending(void) { return false; }
+
+// sizeof 不求值，只是让只给日志用的变量不报 unused
+#define TRACE(id, a0, a1, a2)  do { (void)sizeof(a0); (void)sizeof(a1); (void)sizeof(a2); } while (0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
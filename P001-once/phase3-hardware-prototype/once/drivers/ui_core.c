@@ -0,0 +1,336 @@
+// ui_core.c
+
+#include "drivers/ui_core.h"
+#include "drivers/board.h"
+#include "drivers/lcd_pcf8576.h"
+#include "drivers/instr.h"
+#include "drivers/trace.h"
+#include "drivers/cpu_load.h"
+#include "drivers/session_log.h"
+#include "drivers/boot_time.h"
+#include "drivers/power.h"
+#include "drivers/encoder_ec11.h"
+#include "drivers/enc_capture.h"
+#include "drivers/backlight.h"
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+#if ONCE_DUAL_CORE
+#include "pico/multicore.h"
+#endif
+
+// 每次最多往 USB 发多少条事件日志，剩下的留到下一圈
+#define UI_TRACE_BATCH   16
+
+// 开机第一步只要 LCD：总线 + 模式设置，背光还灭着
+static void ui_display_init(void) {
+    lcd_pcf8576_init();
+    boot_mark(BOOT_LCD_READY);
+}
+
+// 之前提交的显示都真正写到屏上了再开背光，第一眼看到的就是完整的一帧。
+// PWM 背光从很暗渐亮上来，第一步马上生效，开机时刻照样记在这里
+static void ui_display_first_frame(void) {
+    lcd_pcf8576_wait_idle();
+    boot_mark(BOOT_FIRST_FRAME);
+#if ONCE_BL_PWM
+    backlight_play(BACKLIGHT_FADE_IN, time_us_64());
+#else
+    lcd_backlight_on();
+#endif
+    boot_mark(BOOT_BACKLIGHT);
+}
+
+// USB 串口放在第一帧之后：枚举要等主机，本来也不该挡着显示。
+// 不再 sleep 等枚举，开机那几行日志在事件日志环里等着，开机时刻随时可以用 'b' 再要
+static void ui_io_start(void) {
+    stdio_init_all();
+    boot_mark(BOOT_STDIO);
+
+#if LCD_BUS_REPORT_AT_BOOT
+    lcd_pcf8576_bus_report();
+#endif
+
+    printf("ENC debug start.\r\n");
+}
+
+// USB 串口命令：p = 打印计时统计，r = 清零，h = 最近几条会话记录，c = 校准统计，b = 开机各阶段时刻，
+// w = 省电状态和唤醒耗时，e = 旋钮采样统计，x = 开始录旋钮波形 / 再按一次停下并打印，
+// l = 依次试播一个背光图案（闪烁会一直闪，再按到下一个）
+static void ui_poll_serial(void) {
+#if ONCE_ENC_CAPTURE
+    static bool capturing = false;
+#endif
+#if ONCE_BL_PWM
+    static uint8_t bl_try = 0;
+#endif
+    int cmd = getchar_timeout_us(0);
+    switch (cmd) {
+    case 'b':
+        boot_dump();
+        break;
+    case 'e':
+        Encoder_DumpStats();
+        break;
+#if ONCE_ENC_CAPTURE
+    case 'x':
+        capturing = !capturing;
+        Encoder_Capture(capturing);
+        if (capturing) {
+            printf("[CAP] recording, 'x' again to stop and dump\n");
+        } else {
+            enc_capture_dump();
+        }
+        break;
+#endif
+#if ONCE_BL_PWM
+    case 'l': {
+        backlight_stats_t bs;
+        backlight_get_stats(&bs);
+        printf("[BL] play %s, level %u, plays=%lu wrap_irqs=%lu writes=%lu\n",
+               backlight_pattern_name((backlight_pattern_t)bl_try), backlight_level(),
+               (unsigned long)bs.plays, (unsigned long)bs.wrap_irqs, (unsigned long)bs.level_writes);
+        backlight_play((backlight_pattern_t)bl_try, time_us_64());
+        bl_try = (uint8_t)((bl_try + 1) % BACKLIGHT_PATTERN_COUNT);
+        break;
+    }
+#endif
+#if ONCE_INSTR
+    case 'p':
+        instr_dump();
+        break;
+    case 'r':
+        instr_reset();
+        break;
+#endif
+#if ONCE_POWER
+    case 'w':
+        power_dump();
+        break;
+#endif
+#if ONCE_SESSION_LOG
+    case 'h':
+        session_log_dump(SESSION_LOG_DUMP_LAST);
+        break;
+    case 'c':
+        session_log_dump_calib();
+        break;
+#endif
+    default:
+        break;
+    }
+}
+
+#if ONCE_DUAL_CORE
+
+#define UI_RING_MASK     (UI_RING_SIZE - 1)
+#define UI_ARG_MASK      0x00ffffffu
+#define UI_CORE1_READY   0x55490001u   // "UI" + 1，core 1 初始化完通过 FIFO 发回来
+
+// core 0 的日志不会 SEV，core 1 没消息时最多睡这么久就起来发一次
+#define UI_IDLE_MAX_US   100000
+
+/*
+ * 消息环：生产者只有 core 0 的主循环，消费者只有 core 1。
+ * head 只由 core 0 写，tail 只由 core 1 写，__dmb() 保证先写消息后挪指针，
+ * 然后 SEV 叫醒在 WFE 里的 core 1。环满就丢这一条并计数，core 0 从不等。
+ */
+static uint32_t          ui_ring[UI_RING_SIZE];
+static volatile uint32_t ui_ring_head = 0;
+static volatile uint32_t ui_ring_tail = 0;
+static volatile uint32_t ui_ring_overflows = 0;
+
+// USB 串口起来之前不发日志，免得开机那几条白白丢掉；只有 core 1 读写
+static bool ui_io_up = false;
+
+static void ONCE_HOT_FUNC(ui_post)(ui_msg_kind_t kind, uint32_t arg) {
+    uint32_t head = ui_ring_head;
+    if (head - ui_ring_tail >= UI_RING_SIZE) {
+        ui_ring_overflows++;
+        INSTR_COUNT(UI_RING_FULL);
+        TRACE(UI_DROP, kind, 0, 0);
+        return;
+    }
+    ui_ring[head & UI_RING_MASK] = ((uint32_t)kind << 24) | (arg & UI_ARG_MASK);
+    __dmb();
+    ui_ring_head = head + 1;
+    __sev();
+}
+
+static bool ui_pop(uint32_t *msg) {
+    uint32_t tail = ui_ring_tail;
+    if (tail == ui_ring_head) {
+        return false;
+    }
+    __dmb();
+    *msg = ui_ring[tail & UI_RING_MASK];
+    __dmb();
+    ui_ring_tail = tail + 1;
+    return true;
+}
+
+static void ui_apply(uint32_t msg) {
+    uint32_t arg = msg & UI_ARG_MASK;
+    switch ((ui_msg_kind_t)(msg >> 24)) {
+    case UI_MSG_MMSS:
+        lcd_pcf8576_submit_mmss((uint8_t)(arg >> 8), (uint8_t)arg);
+        break;
+    case UI_MSG_MSSD:
+        lcd_pcf8576_submit_mssd((uint8_t)(arg >> 16), (uint8_t)(arg >> 8), (uint8_t)arg);
+        break;
+    case UI_MSG_HMM:
+        lcd_pcf8576_submit_hmm((uint8_t)(arg >> 8), (uint8_t)arg);
+        break;
+    case UI_MSG_BACKLIGHT:
+        if (arg) {
+            lcd_backlight_on();
+        } else {
+            lcd_backlight_off();
+        }
+        break;
+    case UI_MSG_BL_PATTERN:
+#if ONCE_BL_PWM
+        backlight_play((backlight_pattern_t)arg, time_us_64());
+#endif
+        break;
+    case UI_MSG_FIRST_FRAME:
+        ui_display_first_frame();
+        break;
+    case UI_MSG_START_IO:
+        ui_io_start();
+        ui_io_up = true;
+        break;
+    }
+}
+
+static void ui_core1_main(void) {
+    instr_init_core();
+#if ONCE_SESSION_LOG
+    // core 0 写 flash 时要把这个核挡在 RAM 里（flash_safe_execute）
+    multicore_lockout_victim_init();
+#endif
+    ui_display_init();
+    multicore_fifo_push_blocking(UI_CORE1_READY);
+
+    cpu_load_t load;
+    cpu_load_init(&load, 1);
+
+    while (true) {
+        uint32_t msg;
+        while (ui_pop(&msg)) {
+            ui_apply(msg);
+        }
+
+        if (ui_io_up) {
+            ui_poll_serial();
+            trace_drain(UI_TRACE_BATCH);
+        }
+        cpu_load_poll(&load, time_us_64());
+
+        if (ui_ring_tail == ui_ring_head && (!ui_io_up || !trace_pending())) {
+            cpu_load_idle_begin(&load);
+            best_effort_wfe_or_timeout(make_timeout_time_us(UI_IDLE_MAX_US));
+            cpu_load_idle_end(&load);
+        }
+    }
+}
+
+void ui_init(void) {
+    multicore_launch_core1(ui_core1_main);
+    (void)multicore_fifo_pop_blocking();
+}
+
+void ui_first_frame(void) {
+    ui_post(UI_MSG_FIRST_FRAME, 0);
+}
+
+void ui_start_io(void) {
+    ui_post(UI_MSG_START_IO, 0);
+}
+
+void ui_show_mmss(uint8_t minutes, uint8_t seconds) {
+    ui_post(UI_MSG_MMSS, ((uint32_t)minutes << 8) | seconds);
+}
+
+void ui_show_mssd(uint8_t minutes, uint8_t seconds, uint8_t tenths) {
+    ui_post(UI_MSG_MSSD, ((uint32_t)minutes << 16) | ((uint32_t)seconds << 8) | tenths);
+}
+
+void ui_show_hmm(uint8_t hours, uint8_t minutes) {
+    ui_post(UI_MSG_HMM, ((uint32_t)hours << 8) | minutes);
+}
+
+void ui_backlight(bool on) {
+    ui_post(UI_MSG_BACKLIGHT, on ? 1u : 0u);
+}
+
+#if ONCE_BL_PWM
+void ui_backlight_pattern(uint8_t pattern, uint64_t t_us) {
+    (void)t_us;
+    ui_post(UI_MSG_BL_PATTERN, pattern);
+}
+#endif
+
+bool ui_service(void) {
+    return false;
+}
+
+uint32_t ui_get_overflows(void) {
+    return ui_ring_overflows;
+}
+
+#else
+
+void ui_init(void) {
+    ui_display_init();
+}
+
+void ui_first_frame(void) {
+    ui_display_first_frame();
+}
+
+void ui_start_io(void) {
+    ui_io_start();
+}
+
+void ui_show_mmss(uint8_t minutes, uint8_t seconds) {
+    lcd_pcf8576_submit_mmss(minutes, seconds);
+}
+
+void ui_show_mssd(uint8_t minutes, uint8_t seconds, uint8_t tenths) {
+    lcd_pcf8576_submit_mssd(minutes, seconds, tenths);
+}
+
+void ui_show_hmm(uint8_t hours, uint8_t minutes) {
+    lcd_pcf8576_submit_hmm(hours, minutes);
+}
+
+void ui_backlight(bool on) {
+    if (on) {
+        lcd_backlight_on();
+    } else {
+        lcd_backlight_off();
+    }
+}
+
+#if ONCE_BL_PWM
+void ui_backlight_pattern(uint8_t pattern, uint64_t t_us) {
+    backlight_play((backlight_pattern_t)pattern, t_us);
+}
+#endif
+
+bool ui_service(void) {
+    ui_poll_serial();
+    trace_drain(UI_TRACE_BATCH);
+    return trace_pending();
+}
+
+uint32_t ui_get_overflows(void) {
+    return 0;
+}
+
+#endif // ONCE_DUAL_CORE
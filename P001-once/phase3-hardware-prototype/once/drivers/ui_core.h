@@ -0,0 +1,78 @@
+// ui_core.h
+// 显示、背光、USB 日志和串口命令这一侧。
+//
+// 单核（ONCE_DUAL_CORE=0）：这些函数直接调 LCD 驱动，日志在主循环空闲时由 ui_service() 发。
+// 双核（ONCE_DUAL_CORE=1）：ui_init() 把它们整个搬到 core 1。core 0 每次只往一个无锁消息环里
+// 写一个 32 位字、SEV 一下就走；LCD 总线、USB CDC 再慢也只拖 core 1，挡不住 core 0 的秒跳。
+// stdio 和 LCD 都在 core 1 上初始化，USB / I2C / DMA 中断也就都落在 core 1。
+//
+// 开机分三步，先让屏亮起来：ui_init() 只起 LCD -> 显示第一帧后 ui_first_frame() 开背光
+// -> 其余初始化做完再 ui_start_io() 起 USB 串口。
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "board.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 消息：高 8 位种类，低 24 位参数
+typedef enum {
+    UI_MSG_MMSS = 1,      // 参数 = 分 << 8 | 秒
+    UI_MSG_MSSD,          // 参数 = 分 << 16 | 秒 << 8 | 0.1 s
+    UI_MSG_HMM,           // 参数 = 时 << 8 | 分
+    UI_MSG_BACKLIGHT,     // 参数 = 1 亮 / 0 灭
+    UI_MSG_FIRST_FRAME,   // 等第一帧写完再开背光，参数不用
+    UI_MSG_START_IO,      // 起 USB 串口，参数不用
+    UI_MSG_BL_PATTERN,    // 参数 = 背光图案（backlight_pattern_t），从 core 1 收到的时刻起播
+} ui_msg_kind_t;
+
+// 消息环的容量，必须是 2 的幂
+#define UI_RING_SIZE   32
+
+/**
+ * LCD 总线和模式设置，背光先不开。
+ * 双核时先启动 core 1 在那边做，等它通过核间 FIFO 报告就绪再返回。
+ */
+void ui_init(void);
+
+/**
+ * 第一帧已经 ui_show_*() 过了：等它写到屏上，再开背光。
+ */
+void ui_first_frame(void);
+
+/**
+ * USB 串口初始化，打印开机信息。放在开机最后，之后才处理串口命令、发事件日志。
+ */
+void ui_start_io(void);
+
+void ui_show_mmss(uint8_t minutes, uint8_t seconds);
+void ui_show_mssd(uint8_t minutes, uint8_t seconds, uint8_t tenths);
+void ui_show_hmm(uint8_t hours, uint8_t minutes);
+void ui_backlight(bool on);
+
+#if ONCE_BL_PWM
+/**
+ * 播一个背光图案（backlight.h），t_us 是触发它的事件时刻。
+ * 双核时 core 1 收到消息才开始，起点用它自己的当前时刻（差的只是消息环的那一点延迟）。
+ */
+void ui_backlight_pattern(uint8_t pattern, uint64_t t_us);
+#endif
+
+/**
+ * 单核主循环空闲时调用：处理串口命令、发一批事件日志。
+ * 返回 true 表示还有活没干完（日志没发完），先别睡。双核时 core 1 自己干，直接返回 false。
+ */
+bool ui_service(void);
+
+/**
+ * 环满被丢掉的消息数（core 1 卡住太久）。
+ */
+uint32_t ui_get_overflows(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,167 @@
+// bench_accel.c
+// 旋钮加速回放：比较原来的六档阶梯和按转速查曲线的新算法，
+// 拧到一组目标时间各要多少格、刷新多少次显示、花多少时间。
+//
+// 用法：
+//   bench_accel                 用内置的“人手模型”闭环拧到每个目标
+//   bench_accel trace.txt       回放录下来的旋钮轨迹（每行 "<t_us> <+1|-1>"），报两种算法的最终目标
+//
+// 人手模型：离目标越远拧得越快（40 / 25 / 14 / 4 格每秒），
+// 换挡减速或者拧过头换向前先停 500 ms（手指离开旋钮再看一眼屏幕）。
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "app/accel.h"
+#include "app/timer_fsm.h"
+
+#define PAUSE_US     500000u
+#define MAX_DETENTS  5000
+
+typedef enum { ENGINE_LADDER = 0, ENGINE_VELOCITY } engine_t;
+
+typedef struct {
+    engine_t       kind;
+    accel_ladder_t ladder;
+    accel_t        accel;
+} engine_state_t;
+
+static void engine_reset(engine_state_t *e, engine_t kind) {
+    e->kind = kind;
+    accel_ladder_reset(&e->ladder);
+    accel_reset(&e->accel);
+}
+
+static int32_t engine_step(engine_state_t *e, int8_t dir, uint64_t t_us, uint16_t target) {
+    if (e->kind == ENGINE_LADDER) {
+        return accel_ladder_step(&e->ladder, dir, t_us);
+    }
+    return accel_step(&e->accel, &ACCEL_CURVE_DEFAULT, dir, t_us, target);
+}
+
+static uint16_t clamp_target(int32_t t) {
+    if (t < 0) return 0;
+    if (t > TIMER_FSM_MAX_SEC) return TIMER_FSM_MAX_SEC;
+    return (uint16_t)t;
+}
+
+// 离目标还有多远 -> 档位（0 最快）和每格间隔
+static int speed_class(int32_t remaining, uint32_t *interval_us) {
+    static const int32_t  FAR[]   = { 600, 120, 30, 0 };
+    static const uint32_t IVAL[]  = { 25000, 40000, 70000, 250000 };
+    for (int i = 0; i < 4; ++i) {
+        if (remaining > FAR[i]) {
+            *interval_us = IVAL[i];
+            return i;
+        }
+    }
+    *interval_us = IVAL[3];
+    return 3;
+}
+
+typedef struct {
+    uint32_t detents;
+    uint32_t writes;     // 目标时间真的变了、要刷新显示的次数
+    uint64_t t_us;
+    bool     reached;
+} dial_result_t;
+
+static dial_result_t dial_to(engine_t kind, uint16_t goal) {
+    engine_state_t e;
+    engine_reset(&e, kind);
+
+    dial_result_t r = {0};
+    uint16_t cur = 0;
+    int8_t   last_dir = 0;
+    int      last_cls = -1;
+    uint64_t t = 1000000;   // 从 1 s 开始，避开 last_us == 0 的特殊值
+
+    while (cur != goal && r.detents < MAX_DETENTS) {
+        int8_t  dir = (goal > cur) ? +1 : -1;
+        int32_t remaining = (dir > 0) ? (int32_t)goal - cur : (int32_t)cur - goal;
+        uint32_t ival;
+        int cls = speed_class(remaining, &ival);
+
+        if ((last_dir != 0 && dir != last_dir) || (last_cls >= 0 && cls > last_cls)) {
+            t += PAUSE_US;
+        }
+        last_dir = dir;
+        last_cls = cls;
+        t += ival;
+
+        uint16_t next = clamp_target((int32_t)cur + engine_step(&e, dir, t, cur));
+        if (next != cur) {
+            r.writes++;
+        }
+        cur = next;
+        r.detents++;
+    }
+    r.t_us    = t - 1000000;
+    r.reached = (cur == goal);
+    return r;
+}
+
+static int replay(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return 2;
+    }
+
+    engine_state_t e[2];
+    uint16_t cur[2] = { 0, 0 };
+    uint32_t writes[2] = { 0, 0 };
+    engine_reset(&e[0], ENGINE_LADDER);
+    engine_reset(&e[1], ENGINE_VELOCITY);
+
+    unsigned long long t;
+    int dir;
+    uint32_t detents = 0;
+    while (fscanf(f, "%llu %d", &t, &dir) == 2) {
+        for (int k = 0; k < 2; ++k) {
+            uint16_t next = clamp_target((int32_t)cur[k] + engine_step(&e[k], dir > 0 ? 1 : -1, t, cur[k]));
+            writes[k] += (next != cur[k]);
+            cur[k] = next;
+        }
+        detents++;
+    }
+    fclose(f);
+
+    printf("detents=%lu\n", (unsigned long)detents);
+    printf("ladder    target=%02u:%02u writes=%lu\n", cur[0] / 60, cur[0] % 60, (unsigned long)writes[0]);
+    printf("velocity  target=%02u:%02u writes=%lu\n", cur[1] / 60, cur[1] % 60, (unsigned long)writes[1]);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        return replay(argv[1]);
+    }
+
+    static const uint16_t GOALS[] = { 30, 60, 90, 300, 600, 754, 1500, 2700, 3599 };
+    const int n = sizeof(GOALS) / sizeof(GOALS[0]);
+    uint32_t sum_det[2] = { 0, 0 }, sum_wr[2] = { 0, 0 };
+    uint64_t sum_t[2] = { 0, 0 };
+
+    printf("%-7s | %-26s | %-26s\n", "target", "ladder  det  writes  time", "velocity det writes  time");
+    for (int i = 0; i < n; ++i) {
+        dial_result_t r[2] = { dial_to(ENGINE_LADDER, GOALS[i]), dial_to(ENGINE_VELOCITY, GOALS[i]) };
+        printf("%02u:%02u   |", GOALS[i] / 60, GOALS[i] % 60);
+        for (int k = 0; k < 2; ++k) {
+            printf("  %6lu %7lu %6.2fs%s |",
+                   (unsigned long)r[k].detents, (unsigned long)r[k].writes,
+                   (double)r[k].t_us / 1e6, r[k].reached ? " " : "!");
+            sum_det[k] += r[k].detents;
+            sum_wr[k]  += r[k].writes;
+            sum_t[k]   += r[k].t_us;
+        }
+        printf("\n");
+    }
+    printf("total   |  %6lu %7lu %6.2fs  |  %6lu %7lu %6.2fs  |\n",
+           (unsigned long)sum_det[0], (unsigned long)sum_wr[0], (double)sum_t[0] / 1e6,
+           (unsigned long)sum_det[1], (unsigned long)sum_wr[1], (double)sum_t[1] / 1e6);
+    printf("velocity vs ladder: detents %.0f%%  writes %.0f%%  time %.0f%%\n",
+           100.0 * sum_det[1] / sum_det[0], 100.0 * sum_wr[1] / sum_wr[0],
+           100.0 * (double)sum_t[1] / (double)sum_t[0]);
+    return 0;
+}
@@ -0,0 +1,171 @@
+// bench_calib.c
+// 校准统计：一组合成的停表误差（正态分布，可以中途换均值模拟“练习后偏差变了”）
+// 流式喂给 calib_bucket_add()，和双精度的参考值比：
+//   - 均值 / 标准差：两遍算法；
+//   - 指数加权偏差：同样 1/8 系数的浮点递推；
+//   - p10 / p50 / p90：按同样的权重（每条比上一条重 1/16）对全部样本求精确的加权分位数。
+// 均值、标准差、加权偏差差 1 bp 以上，或者分位数差超过一格直方图，返回 1。
+//
+// 用法：bench_calib [每组样本数]    默认 2000
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "app/calib.h"
+
+static uint64_t rng_state = 0x9e3779b97f4a7c15ull;
+
+static double rng_uniform(void) {
+    // xorshift64*
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (double)((rng_state * 0x2545f4914f6cdd1dull) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double rng_normal(void) {
+    double u = rng_uniform(), v = rng_uniform();
+    if (u < 1e-300) {
+        u = 1e-300;
+    }
+    return sqrt(-2.0 * log(u)) * cos(2.0 * 3.14159265358979323846 * v);
+}
+
+typedef struct {
+    const char *name;
+    double      mean0_bp, mean1_bp;   // 前一半 / 后一半的均值
+    double      sd_bp;
+} scenario_t;
+
+static const scenario_t SCENARIOS[] = {
+    { "steady, early",       -150, -150,  200 },
+    { "drift late -> early",  300, -100,  150 },
+    { "wide, hits tails",       0,    0,  800 },
+    { "tight",                 40,   40,   30 },
+};
+
+// 直方图最宽的一格（bp），分位数允许差这么多
+#define QUANTILE_TOL_BP  500
+
+static uint32_t failures = 0;
+
+typedef struct {
+    int32_t x;
+    double  w;
+} wsample_t;
+
+static int cmp_ws(const void *a, const void *b) {
+    int32_t x = ((const wsample_t *)a)->x, y = ((const wsample_t *)b)->x;
+    return (x > y) - (x < y);
+}
+
+// 和 calib_quantile_bp 同一个口径：累计权重第一次达到 q 的样本
+static double weighted_quantile(wsample_t *ws, long n, double q) {
+    qsort(ws, (size_t)n, sizeof(*ws), cmp_ws);
+    double total = 0;
+    for (long i = 0; i < n; ++i) {
+        total += ws[i].w;
+    }
+    double cum = 0;
+    for (long i = 0; i < n; ++i) {
+        cum += ws[i].w;
+        if (cum >= q * total) {
+            return ws[i].x;
+        }
+    }
+    return ws[n - 1].x;
+}
+
+static void report(const char *what, double ref, double got, double tol) {
+    double d = fabs(got - ref);
+    bool bad = d > tol;
+    printf("    %-5s ref=%9.2f  got=%7.0f  diff=%7.2f bp%s\n", what, ref, got, d, bad ? "  FAIL" : "");
+    if (bad) {
+        failures++;
+    }
+}
+
+int main(int argc, char **argv) {
+    long n = (argc > 1) ? atol(argv[1]) : 2000L;
+    if (n <= 1) {
+        n = 2000L;
+    }
+
+    int32_t   *xs = malloc((size_t)n * sizeof(*xs));
+    wsample_t *ws = malloc((size_t)n * sizeof(*ws));
+    if (!xs || !ws) {
+        return 1;
+    }
+
+    printf("[CAL] calib_bucket_t = %zu bytes, calib_t (%d buckets) = %zu bytes\n",
+           sizeof(calib_bucket_t), CALIB_BUCKETS, sizeof(calib_t));
+
+    for (size_t k = 0; k < sizeof(SCENARIOS) / sizeof(SCENARIOS[0]); ++k) {
+        const scenario_t *sc = &SCENARIOS[k];
+        calib_bucket_t b;
+        calib_t c;
+        calib_init(&c);
+        b = c.b[0];
+
+        double ew = 0;
+        for (long i = 0; i < n; ++i) {
+            double mu = (i < n / 2) ? sc->mean0_bp : sc->mean1_bp;
+            double x  = mu + sc->sd_bp * rng_normal();
+            if (x > CALIB_ERR_LIMIT_BP) x = CALIB_ERR_LIMIT_BP;
+            if (x < -CALIB_ERR_LIMIT_BP) x = -CALIB_ERR_LIMIT_BP;
+            xs[i] = (int32_t)lround(x);
+
+            calib_bucket_add(&b, xs[i]);
+            ew = (i == 0) ? xs[i] : ew + (xs[i] - ew) / (double)(1 << CALIB_EW_SHIFT);
+        }
+        // 权重从最新一条往回算（最新 = 1），样本再多也不会溢出
+        double w = 1;
+        for (long i = n - 1; i >= 0; --i) {
+            ws[i].x = xs[i];
+            ws[i].w = w;
+            w /= 1.0 + 1.0 / (double)(1 << CALIB_HIST_GROW_SHIFT);
+        }
+
+        double sum = 0;
+        for (long i = 0; i < n; ++i) {
+            sum += xs[i];
+        }
+        double mean = sum / (double)n, ss = 0;
+        for (long i = 0; i < n; ++i) {
+            ss += (xs[i] - mean) * (xs[i] - mean);
+        }
+        double sd = sqrt(ss / (double)(n - 1));
+
+        calib_summary_t s;
+        calib_summary(&b, &s);
+
+        printf("[CAL] %s (n=%ld, mean %+.0f -> %+.0f bp, sd %.0f bp)\n",
+               sc->name, n, sc->mean0_bp, sc->mean1_bp, sc->sd_bp);
+        report("mean", mean, s.mean_bp, 1.0);
+        report("sd",   sd,   s.stddev_bp, 1.0);
+        report("ew",   ew,   s.ew_bp, 1.0);
+        report("p10",  weighted_quantile(ws, n, 0.10), s.p10_bp, QUANTILE_TOL_BP);
+        report("p50",  weighted_quantile(ws, n, 0.50), s.p50_bp, QUANTILE_TOL_BP);
+        report("p90",  weighted_quantile(ws, n, 0.90), s.p90_bp, QUANTILE_TOL_BP);
+    }
+
+    // 耗时：每次停表一次更新
+    calib_t c;
+    calib_init(&c);
+    long m = 20000000L;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long i = 0; i < m; ++i) {
+        calib_update(&c, (uint16_t)(1 + i % 3000), 1000000ull * (uint64_t)(1 + i % 3000) + (uint64_t)(i % 997) * 1000u);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ns = ((double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec)) / (double)m;
+    printf("[CAL] calib_update: %.1f ns/session (host)\n", ns);
+
+    printf("[CAL] %s (%u failed checks)\n", failures ? "FAIL" : "OK", failures);
+    free(xs);
+    free(ws);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,137 @@
+// bench_compare.c
+// 比两次 once_bench 的输出（板子串口存下来的，或者 once_bench_host 的 stdout）：
+// 按内核名对上 #B 行，比 min_ns（最快一轮，受干扰最小）。
+// 新结果比基准慢了超过容差，或者基准里有的内核新结果里没了 / 变成 unavailable，返回 1。
+//
+// 板子上两次之间很稳，10 % 够用；主机上同一台机器两次之间也能差 30 % 以上（频率、调度），容差要放宽。
+//
+// 用法：bench_compare <基准> <新结果> [容差 %]    默认 10
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MAX_ROWS   64
+
+typedef struct {
+    char   name[32];
+    bool   available;
+    double min_ns;
+    double med_ns;
+} row_t;
+
+typedef struct {
+    char  header[128];
+    char  platform[16];
+    row_t rows[MAX_ROWS];
+    int   n;
+} result_t;
+
+static int load(const char *path, result_t *r) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    memset(r, 0, sizeof(*r));
+    strcpy(r->platform, "?");
+
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        const char *p = strstr(line, "platform=");
+        if (strncmp(line, "[BENCH] once_bench", 18) == 0 && p) {
+            sscanf(p, "platform=%15s", r->platform);
+            snprintf(r->header, sizeof(r->header), "%s", p);
+            r->header[strcspn(r->header, "\r\n")] = '\0';
+            continue;
+        }
+        if (strncmp(line, "#B ", 3) != 0 || r->n >= MAX_ROWS) {
+            continue;
+        }
+        row_t *row = &r->rows[r->n];
+        if (sscanf(line + 3, "%31s", row->name) != 1) {
+            continue;
+        }
+        const char *m = strstr(line, "min_ns=");
+        const char *d = strstr(line, "med_ns=");
+        row->available = m && d;
+        if (row->available) {
+            row->min_ns = atof(m + 7);
+            row->med_ns = atof(d + 7);
+        }
+        r->n++;
+    }
+    fclose(f);
+    if (r->n == 0) {
+        fprintf(stderr, "%s: no #B lines\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+static const row_t *find(const result_t *r, const char *name) {
+    for (int i = 0; i < r->n; ++i) {
+        if (strcmp(r->rows[i].name, name) == 0) {
+            return &r->rows[i];
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <base> <new> [tolerance %%]\n", argv[0]);
+        return 2;
+    }
+    double tol = (argc > 3) ? atof(argv[3]) : 10.0;
+
+    static result_t base, cur;
+    if (load(argv[1], &base) != 0 || load(argv[2], &cur) != 0) {
+        return 2;
+    }
+    if (strcmp(base.platform, cur.platform) != 0) {
+        fprintf(stderr, "warning: comparing platform=%s against platform=%s\n", base.platform, cur.platform);
+    }
+    // 构建配置（image / ram_hot）不同也照比，例如 ONCE_RAM_HOT=0 和 1 对比，两边都列出来
+    printf("base: %s\nnew:  %s\n", base.header, cur.header);
+
+    uint32_t failures = 0;
+    printf("%-20s %12s %12s %8s\n", "kernel", "base ns", "new ns", "ratio");
+    for (int i = 0; i < base.n; ++i) {
+        const row_t *b = &base.rows[i];
+        const row_t *c = find(&cur, b->name);
+        const char *verdict = "";
+        if (!c) {
+            printf("%-20s %12s %12s %8s  FAIL (missing)\n", b->name, "", "", "");
+            failures++;
+            continue;
+        }
+        if (!b->available) {
+            printf("%-20s %12s %12s %8s\n", b->name, "n/a", c->available ? "" : "n/a", "");
+            continue;
+        }
+        if (!c->available) {
+            printf("%-20s %12.1f %12s %8s  FAIL (unavailable)\n", b->name, b->min_ns, "n/a", "");
+            failures++;
+            continue;
+        }
+        double ratio = (b->min_ns > 0) ? c->min_ns / b->min_ns : 1.0;
+        if (ratio > 1.0 + tol / 100.0) {
+            verdict = "  FAIL";
+            failures++;
+        } else if (ratio < 1.0 - tol / 100.0) {
+            verdict = "  faster";
+        }
+        printf("%-20s %12.1f %12.1f %7.3fx%s\n", b->name, b->min_ns, c->min_ns, ratio, verdict);
+    }
+    for (int i = 0; i < cur.n; ++i) {
+        if (!find(&base, cur.rows[i].name)) {
+            printf("%-20s %12s %12.1f %8s  (new)\n", cur.rows[i].name, "", cur.rows[i].min_ns, "");
+        }
+    }
+
+    printf("[CMP] %s (%u regressions over %.0f%%)\n", failures ? "FAIL" : "OK", failures, tol);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,177 @@
+// bench_encoder.c
+// 旋钮采样率：在仿真里用同一组合成的旋转（从静止开始，每个相位的时长随机 ±30%）
+// 比较三种定时器采样设置：
+//   - fixed 1 kHz：原来的固定 1 ms 采样；
+//   - adaptive：100 Hz 慢采，看到边沿切 5 kHz，安静 50 ms 后逐步退回（只靠慢采发现开始转）；
+//   - adaptive+kick：同上，慢采时 A/B 开边沿中断，第一条边沿就切快采（board.h 的默认）。
+// 每档转速报：解出来的格数 / 真实格数、A/B 同时翻转（漏采）的次数、最长的检测延迟、
+// 转动时和静止时每秒的中断数（采样 alarm + GPIO 边沿）。
+// adaptive+kick 在 2 ms/格以内漏格、比 fixed 1 kHz 漏得多、或者静止时中断比慢采率多 10% 以上，返回 1。
+//
+// 用法：bench_encoder [每档格数]    默认 24
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sim.h"
+#include "drivers/board.h"
+#include "drivers/encoder_ec11.h"
+
+#define MAX_DETENTS   256
+#define SETTLE_US     1000000u    // 每次开始前静止这么久，采样率退回慢采
+#define IDLE_US       1000000u    // 静止时的中断数在这一段里量
+#define TAIL_US       100000u     // 转完再等这么久收事件
+
+typedef struct {
+    const char        *name;
+    encoder_sampling_t cfg;
+} config_t;
+
+static const config_t CONFIGS[] = {
+    { "fixed 1 kHz",   { 1000, 1000, 0, false } },
+    { "adaptive",      { ENCODER_SAMPLE_SLOW_US, ENCODER_SAMPLE_FAST_US, ENCODER_SAMPLE_HOLD_US, false } },
+    { "adaptive+kick", { ENCODER_SAMPLE_SLOW_US, ENCODER_SAMPLE_FAST_US, ENCODER_SAMPLE_HOLD_US, true } },
+};
+#define N_CONFIGS  (sizeof(CONFIGS) / sizeof(CONFIGS[0]))
+#define KICK       (N_CONFIGS - 1)
+
+// ms/格：从慢慢拧到甩一下
+static const uint32_t SPEEDS_MS[] = { 40, 20, 10, 6, 4, 2, 1 };
+#define N_SPEEDS   (sizeof(SPEEDS_MS) / sizeof(SPEEDS_MS[0]))
+
+typedef struct {
+    uint32_t decoded;       // 方向对的格数
+    uint32_t wrong;         // 方向反了的格数
+    uint32_t invalid;
+    uint32_t max_lat_us;    // 第 i 个事件 - 第 i 格最后一条边沿
+    double   spin_irq_s;
+    double   idle_irq_s;
+} result_t;
+
+static uint32_t rng_state = 0x1234567u;
+
+static uint32_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// 动作参数：低位 A、高位 B，1 = 触点接地
+static void drive_ab(void *ctx) {
+    uintptr_t v = (uintptr_t)ctx;
+    if (v & 1) {
+        sim_pin_drive(ENCODER_EC11_PIN_A, false);
+    } else {
+        sim_pin_release(ENCODER_EC11_PIN_A);
+    }
+    if (v & 2) {
+        sim_pin_drive(ENCODER_EC11_PIN_B, false);
+    } else {
+        sim_pin_release(ENCODER_EC11_PIN_B);
+    }
+}
+
+static uint64_t irq_count(void) {
+    sim_stats_t s;
+    sim_get_stats(&s);
+    return s.alarms_fired + s.gpio_irqs;
+}
+
+// 和 sim_main.c 的 cw 一样：A 先落下
+static uint64_t schedule_detents(uint64_t t_us, int detents, uint32_t ms_per_detent, uint64_t *done_us) {
+    static const uint8_t SEQ_CW[4] = { 1, 3, 2, 0 };
+    uint32_t step = ms_per_detent * 1000u / 4u;
+
+    for (int d = 0; d < detents; ++d) {
+        for (int k = 0; k < 4; ++k) {
+            sim_schedule(t_us, drive_ab, (void *)(uintptr_t)SEQ_CW[k]);
+            done_us[d] = t_us;
+            t_us += step * 7u / 10u + rng_next() % (step * 6u / 10u + 1u);
+        }
+    }
+    return t_us;
+}
+
+static result_t run_trial(const encoder_sampling_t *cfg, uint32_t ms_per_detent, int detents) {
+    result_t r = {0};
+    uint64_t done_us[MAX_DETENTS];
+
+    Encoder_Init();
+    Encoder_SetSampling(cfg);
+
+    uint64_t t = sim_now_us() + SETTLE_US;
+    sim_run_until(t);
+    uint64_t irq0 = irq_count();
+    sim_run_until(t + IDLE_US);
+    r.idle_irq_s = (double)(irq_count() - irq0) * 1e6 / IDLE_US;
+
+    // 起点和采样相位随便错开
+    encoder_stats_t s0, s1;
+    Encoder_GetStats(&s0);
+    uint64_t t_start = sim_now_us() + 1000u + rng_next() % cfg->slow_us;
+    uint64_t t_end   = schedule_detents(t_start, detents, ms_per_detent, done_us);
+    sim_run_until(t_start);
+    irq0 = irq_count();
+    sim_run_until(t_end);
+    r.spin_irq_s = (double)(irq_count() - irq0) * 1e6 / (double)(t_end - t_start);
+    sim_run_until(t_end + TAIL_US);
+    Encoder_GetStats(&s1);
+    r.invalid = s1.invalid - s0.invalid;
+
+    encoder_event_t ev;
+    uint32_t i = 0;
+    while (Encoder_ReadEvent(&ev)) {
+        if (ev.type == cw) {
+            if (i < (uint32_t)detents && ev.t_us >= done_us[i]) {
+                uint32_t lat = (uint32_t)(ev.t_us - done_us[i]);
+                if (lat > r.max_lat_us) {
+                    r.max_lat_us = lat;
+                }
+            }
+            r.decoded++;
+        } else if (ev.type == ccw) {
+            r.wrong++;
+        }
+        i++;
+    }
+    return r;
+}
+
+int main(int argc, char **argv) {
+    int detents = (argc > 1) ? atoi(argv[1]) : 24;
+    if (detents <= 0 || detents > MAX_DETENTS) {
+        detents = 24;
+    }
+
+    uint32_t failures = 0;
+    uint32_t missed[N_CONFIGS][N_SPEEDS];
+
+    for (size_t c = 0; c < N_CONFIGS; ++c) {
+        const encoder_sampling_t *cfg = &CONFIGS[c].cfg;
+        printf("[ENC] %s: slow %lu us, fast %lu us, hold %lu us, edge kick %s\n", CONFIGS[c].name,
+               (unsigned long)cfg->slow_us, (unsigned long)cfg->fast_us, (unsigned long)cfg->hold_us,
+               cfg->edge_kick ? "on" : "off");
+        for (size_t k = 0; k < N_SPEEDS; ++k) {
+            result_t r = run_trial(cfg, SPEEDS_MS[k], detents);
+            missed[c][k] = (uint32_t)detents - (r.decoded < (uint32_t)detents ? r.decoded : (uint32_t)detents);
+
+            bool bad = false;
+            if (c == KICK) {
+                bad = r.wrong > 0 || (SPEEDS_MS[k] >= 2 && missed[c][k] > 0) || missed[c][k] > missed[0][k] ||
+                      r.idle_irq_s > 1.1e6 / cfg->slow_us;
+            }
+            printf("    %2lu ms/detent  decoded %3lu/%d  wrong %lu  invalid %3lu  max latency %5lu us  "
+                   "irq/s spin %6.0f idle %5.0f%s\n",
+                   (unsigned long)SPEEDS_MS[k], (unsigned long)r.decoded, detents, (unsigned long)r.wrong,
+                   (unsigned long)r.invalid, (unsigned long)r.max_lat_us, r.spin_irq_s, r.idle_irq_s,
+                   bad ? "  FAIL" : "");
+            if (bad) {
+                failures++;
+            }
+        }
+    }
+
+    printf("[ENC] %s (%u failed checks)\n", failures ? "FAIL" : "OK", failures);
+    return failures ? 1 : 0;
+}
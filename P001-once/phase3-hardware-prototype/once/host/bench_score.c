@@ -0,0 +1,119 @@
+// bench_score.c
+// 打分：定点查表版 score_run() 对照网页原型 evaluate() 的浮点公式。
+//   1. 扫全误差范围（一组目标时间 × 提前 / 超时 0..25%，步长 1 us 量级），报和双精度参考的最大差值，
+//      超过 1 分就返回 1；
+//   2. 同一批输入分别跑定点版和 expf 版，报每次的平均耗时。
+// 注意主机有 FPU，这里的 expf 比 M0+ 上的软浮点快得多，耗时对比只能看个相对量级。
+//
+// 用法：bench_score [每个目标的采样点数]    默认 200,000
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#include "app/score.h"
+
+// evaluate() 原样：Math.round 是向上取整的四舍五入
+static int score_ref(double ms, double target_sec) {
+    double tgt = target_sec * 1000.0;
+    double r   = fabs(ms - tgt) / tgt;
+    double s   = 0.05;
+    return (int)floor(100.0 * exp(-0.5 * (r / s) * (r / s)) + 0.5);
+}
+
+// 直接移植到单精度浮点，固件里不用定点时大概就是这样
+static uint8_t score_expf(uint64_t elapsed_us, uint64_t target_us) {
+    float r = fabsf((float)elapsed_us - (float)target_us) / (float)target_us;
+    float x = r / 0.05f;
+    return (uint8_t)(100.0f * expf(-0.5f * x * x) + 0.5f);
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static const uint32_t TARGETS_SEC[] = { 1, 3, 10, 30, 60, 90, 300, 600, 1800, 2700, 5999 };
+#define N_TARGETS  (sizeof(TARGETS_SEC) / sizeof(TARGETS_SEC[0]))
+
+int main(int argc, char **argv) {
+    long n = (argc > 1) ? atol(argv[1]) : 200000L;
+    if (n <= 0) {
+        n = 200000L;
+    }
+
+    // ---------- 精度 ----------
+    int      worst = 0;
+    uint64_t worst_el = 0, worst_tgt = 0;
+    long     n_diff = 0, n_total = 0;
+    int      hist[3] = { 0, 0, 0 };   // |差| = 0 / 1 / >1
+
+    for (size_t t = 0; t < N_TARGETS; ++t) {
+        uint64_t tgt = (uint64_t)TARGETS_SEC[t] * 1000000u;
+        for (long i = -n; i <= n; ++i) {
+            // 误差从 -25% 到 +25%，x = r / sigma 一直扫到 5，覆盖截断点两边
+            uint64_t el = (uint64_t)((int64_t)tgt + (int64_t)tgt * i / 4 / n);
+            int ref = score_ref((double)el / 1000.0, (double)TARGETS_SEC[t]);
+            int got = score_run(el, tgt);
+            int d   = abs(got - ref);
+            hist[d > 1 ? 2 : d]++;
+            n_total++;
+            if (d) {
+                n_diff++;
+            }
+            if (d > worst) {
+                worst = d;
+                worst_el = el;
+                worst_tgt = tgt;
+            }
+        }
+    }
+
+    printf("[SCORE] %ld samples over %zu targets, r in [-25%%, +25%%]\n", n_total, N_TARGETS);
+    printf("[SCORE] |diff|=0: %d  =1: %d  >1: %d  (off by one on %.4f%% of samples)\n",
+           hist[0], hist[1], hist[2], 100.0 * (double)n_diff / (double)n_total);
+    if (worst > 0) {
+        printf("[SCORE] worst diff %d at elapsed=%llu us target=%llu us\n", worst,
+               (unsigned long long)worst_el, (unsigned long long)worst_tgt);
+    }
+    if (score_run(5000000u, 0) != SCORE_NONE) {
+        printf("[SCORE] target 0 should give no score\n");
+        return 1;
+    }
+
+    // ---------- 耗时 ----------
+    long m = 10000000L;
+    uint64_t *els = malloc((size_t)m * sizeof(*els));
+    if (!els) {
+        return 1;
+    }
+    uint32_t rng = 0x12345678u;
+    for (long i = 0; i < m; ++i) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        // 大多数落在 ±25% 以内，和真实使用差不多
+        els[i] = 60000000u - 15000000u + rng % 30000000u;
+    }
+
+    volatile uint32_t sink = 0;
+    double t0 = now_sec();
+    for (long i = 0; i < m; ++i) {
+        sink += score_run(els[i], 60000000u);
+    }
+    double t1 = now_sec();
+    for (long i = 0; i < m; ++i) {
+        sink += score_expf(els[i], 60000000u);
+    }
+    double t2 = now_sec();
+    free(els);
+
+    printf("[SCORE] fixed-point: %6.2f ns/call\n", (t1 - t0) * 1e9 / (double)m);
+    printf("[SCORE] expf:        %6.2f ns/call  (host FPU, not M0+ soft-float)\n",
+           (t2 - t1) * 1e9 / (double)m);
+
+    return worst > 1 ? 1 : 0;
+}
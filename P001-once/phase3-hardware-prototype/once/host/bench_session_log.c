@@ -0,0 +1,203 @@
+// bench_session_log.c
+// 会话记录：在仿真 flash 上反复追加，中途随机“重启”（重新 session_log_init，RAM 队列丢掉），
+// 每次重启后检查找到的头和读回来的记录跟实际写进去的一致；再模拟两种断电：
+//   1. 写记录写到一半：那一槽作废，后面接着写，读它返回 false，别的记录不受影响；
+//   2. 擦完新扇区、扇区头还没写：开机退回上一个扇区，下一条照常落盘。
+// 校准统计快照跟着每条记录写，每次重启后读回来的统计要和 RAM 里一路算下来的一模一样。
+// 最后报轮转擦了几次、写页 / 擦扇区时的最长关中断时间（仿真按 flash 手册的典型值走时钟）。
+//
+// 用法：bench_session_log [记录数]    默认 5000
+// 有检查失败时返回 1。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "drivers/session_log.h"
+#include "hardware/flash.h"
+
+#define SLOG_BASE   (PICO_FLASH_SIZE_BYTES - SESSION_LOG_SECTORS * FLASH_SECTOR_SIZE)
+#define SLOTS       (FLASH_SECTOR_SIZE / sizeof(session_rec_t))
+
+// flash 里最多能留住多少条：头扇区之外的扇区都是满的
+#define KEEP_MIN    ((SESSION_LOG_SECTORS - 1) * (SLOTS - 1))
+
+typedef struct {
+    uint16_t target_sec;
+    uint64_t actual_us;
+    uint8_t  score;
+    bool     torn;
+} shadow_t;
+
+static shadow_t *shadow;
+static uint32_t  n_written = 0;     // 已经落盘的（序号 = 下标 + 1）
+static uint32_t  failures  = 0;
+
+static calib_t   calib_shadow;      // 一路算下来的统计，和每次重启读回来的比
+
+static uint32_t rng_state = 0x2468aceu;
+
+static uint32_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+#define CHECK(cond, ...)                          \
+    do {                                          \
+        if (!(cond)) {                            \
+            failures++;                           \
+            fprintf(stderr, "[FAIL] " __VA_ARGS__); \
+            fprintf(stderr, "\n");                \
+        }                                         \
+    } while (0)
+
+static void flush(void) {
+    while (session_log_service()) {
+    }
+}
+
+static void append_one(void) {
+    shadow_t *s = &shadow[n_written];
+    s->target_sec = (uint16_t)(1 + rng_next() % 3600);
+    s->actual_us  = (uint64_t)s->target_sec * 1000000u - 500000u + rng_next() % 1000000u;
+    s->score      = (uint8_t)(rng_next() % 101);
+    s->torn       = false;
+    session_log_append(s->target_sec, s->actual_us, s->score);
+    calib_update(&calib_shadow, s->target_sec, s->actual_us);
+    flush();
+    n_written++;
+}
+
+// 读回最近的记录，和 shadow 对照；返回核对了几条
+static uint32_t verify(const char *when) {
+    session_log_stats_t st;
+    session_log_get_stats(&st);
+    CHECK(st.records == n_written, "%s: records=%u, expected %u", when, st.records, n_written);
+
+    uint32_t ok = 0;
+    uint32_t keep = n_written < KEEP_MIN ? n_written : KEEP_MIN;
+    for (uint32_t back = 0; back < keep; ++back) {
+        uint32_t idx = n_written - 1 - back;
+        session_rec_t r;
+        bool got = session_log_read(back, &r);
+        if (shadow[idx].torn) {
+            CHECK(!got, "%s: torn record #%u read back as valid", when, idx + 1);
+            continue;
+        }
+        CHECK(got, "%s: record #%u (back %u) missing", when, idx + 1, back);
+        if (!got) {
+            continue;
+        }
+        CHECK(r.seq == idx + 1 && r.target_sec == shadow[idx].target_sec &&
+              r.actual_us == shadow[idx].actual_us && r.score == shadow[idx].score,
+              "%s: record #%u mismatch", when, idx + 1);
+        ok++;
+    }
+    CHECK(memcmp(session_log_calib(), &calib_shadow, sizeof(calib_t)) == 0,
+          "%s: calibration stats differ from the streamed ones", when);
+    return ok;
+}
+
+// 头扇区里第一个空槽的 flash 偏移（照着 session_log.c 的布局从外面找）
+static uint32_t first_blank_slot_after_data(void) {
+    const uint8_t *base = (const uint8_t *)(XIP_BASE + SLOG_BASE);
+    uint32_t last_used = 0;
+    for (uint32_t off = 0; off < SESSION_LOG_SECTORS * FLASH_SECTOR_SIZE; off += sizeof(session_rec_t)) {
+        bool blank = true;
+        for (uint32_t i = 0; i < sizeof(session_rec_t); ++i) {
+            blank &= base[off + i] == 0xff;
+        }
+        if (!blank && off % FLASH_SECTOR_SIZE != 0) {
+            // 最新一条：序号最大的那个非空槽
+            uint32_t seq;
+            memcpy(&seq, &base[off + 8], sizeof(seq));
+            if (seq == n_written) {
+                last_used = off;
+            }
+        }
+    }
+    return SLOG_BASE + last_used + sizeof(session_rec_t);
+}
+
+// session_log_init() 会清掉统计，重启前先攒起来
+static uint32_t max_program_us = 0, max_erase_us = 0, erases = 0, reboots = 0;
+
+static void reboot(void) {
+    session_log_stats_t st;
+    session_log_get_stats(&st);
+    erases += st.erases;
+    if (st.max_program_us > max_program_us) max_program_us = st.max_program_us;
+    if (st.max_erase_us > max_erase_us) max_erase_us = st.max_erase_us;
+
+    session_log_init();
+    reboots++;
+}
+
+int main(int argc, char **argv) {
+    long n = (argc > 1) ? atol(argv[1]) : 5000L;
+    if (n <= 0) {
+        n = 5000L;
+    }
+    shadow = calloc((size_t)n + 2 * SLOTS, sizeof(*shadow));   // 后面两个断电场景还要再写不到两个扇区
+    if (!shadow) {
+        return 1;
+    }
+
+    calib_init(&calib_shadow);
+    session_log_init();
+    CHECK(!session_log_read(0, &(session_rec_t){ 0 }), "blank flash should have no records");
+
+    // ---------- 追加 + 随机重启 ----------
+    while (n_written < (uint32_t)n) {
+        append_one();
+        if (rng_next() % 40 == 0) {
+            reboot();
+            verify("reboot");
+        }
+    }
+    uint32_t kept = verify("final");
+
+    // ---------- 断电 1：记录写到一半 ----------
+    uint32_t torn_off = first_blank_slot_after_data();
+    if ((torn_off - SLOG_BASE) % FLASH_SECTOR_SIZE != 0) {
+        uint8_t page[FLASH_PAGE_SIZE];
+        memset(page, 0xff, sizeof(page));
+        uint32_t page_off = torn_off - torn_off % FLASH_PAGE_SIZE;
+        memset(&page[torn_off - page_off], 0x5a, sizeof(session_rec_t) / 2);
+        flash_range_program(page_off, page, FLASH_PAGE_SIZE);
+
+        shadow[n_written].torn = true;
+        n_written++;          // 这一槽的序号被占掉了
+        reboot();
+        append_one();
+        append_one();
+        verify("torn record");
+    }
+
+    // ---------- 断电 2：擦完新扇区，扇区头还没写 ----------
+    // 先写满当前头扇区，再排一条让它去擦下一个扇区，只走一步就“断电”
+    while (n_written % (SLOTS - 1) != 0) {
+        append_one();
+    }
+    session_log_append(60, 60000000u, 100);
+    session_log_service();              // 只擦，不写
+    reboot();                           // 断电重启，队列里那条丢了
+    verify("erase before header");
+    append_one();
+    verify("after erase before header");
+
+    reboot();
+
+    printf("[SLOG] %u records, %u sectors x %u slots, %u reboots, %u kept readable at the end\n",
+           n_written, (unsigned)SESSION_LOG_SECTORS, (unsigned)(SLOTS - 1), reboots, kept);
+    printf("[SLOG] sector erases: %u (records + calibration snapshots)\n", erases);
+    printf("[SLOG] irq-off max: program %u us, erase %u us\n", max_program_us, max_erase_us);
+    printf("[SLOG] boot scan: %u header reads + <= 8 slot probes\n", (unsigned)SESSION_LOG_SECTORS);
+    printf("[SLOG] %s (%u failed checks)\n", failures ? "FAIL" : "OK", failures);
+
+    free(shadow);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,79 @@
+// bench_timer_fsm.c
+// 单独测状态机：bench/fsm_script.h 的剧本（设定 / 计时 / 暂停 / 到点闪烁 / 回到设定）一圈圈喂给
+// timer_fsm_step，报每个事件的平均耗时、实际产生的副作用数（去重前后的差别）和各状态的事件数。
+// 有哪个状态、背光或者闪烁的副作用一次都没走到，返回 1。
+//
+// 用法：bench_timer_fsm [事件数]    默认 10,000,000
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "app/timer_fsm.h"
+#include "bench/fsm_script.h"
+
+int main(int argc, char **argv) {
+    long n = (argc > 1) ? atol(argv[1]) : 10000000L;
+    if (n <= 0) {
+        n = 10000000L;
+    }
+
+    // 事件先生成好，计时只算状态机本身
+    timer_event_t *evs = malloc((size_t)n * sizeof(*evs));
+    if (!evs) {
+        return 1;
+    }
+    uint64_t base_us = 0;
+    for (long i = 0; i < n; ++i) {
+        uint32_t k = (uint32_t)(i % (long)FSM_SCRIPT_LEN);
+        if (k == 0 && i > 0) {
+            base_us += (uint64_t)FSM_SCRIPT_SPAN_MS * 1000u;
+        }
+        evs[i] = fsm_script_event(k, base_us);
+    }
+
+    timer_fsm_t fsm;
+    timer_fsm_init(&fsm);
+    timer_fx_list_t fx;
+    unsigned long handled = 0, effects = 0, shows = 0, backlights = 0, blinks = 0;
+    unsigned long per_state[TIMER_STATE_COUNT] = {0};
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long i = 0; i < n; ++i) {
+        per_state[fsm.state]++;
+        if (timer_fsm_step(&fsm, &evs[i], &fsm, &fx)) {
+            handled++;
+        }
+        effects += fx.count;
+        for (uint8_t k = 0; k < fx.count; ++k) {
+            shows      += (fx.fx[k].kind == TIMER_FX_SHOW || fx.fx[k].kind == TIMER_FX_SHOW_ELAPSED);
+            backlights += (fx.fx[k].kind == TIMER_FX_BACKLIGHT);
+            blinks     += (fx.fx[k].kind == TIMER_FX_BLINK_START || fx.fx[k].kind == TIMER_FX_BLINK_STOP);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    double ns = (double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec);
+    printf("events=%ld handled=%lu ns_per_event=%.2f\n", n, handled, ns / (double)n);
+    printf("effects=%lu show=%lu backlight=%lu blink=%lu (per handled event %.3f)\n",
+           effects, shows, backlights, blinks, handled ? (double)effects / (double)handled : 0.0);
+
+    // 不到一圈的话走不全，不算失败
+    bool full = n >= (long)FSM_SCRIPT_LEN;
+    int failures = 0;
+    for (int s = 0; s < TIMER_STATE_COUNT; ++s) {
+        bool bad = full && per_state[s] == 0;
+        printf("state %-8s %lu%s\n", timer_fsm_state_name((timer_state_t)s), per_state[s],
+               bad ? "  FAIL (never reached)" : "");
+        failures += bad;
+    }
+    if (full && (backlights == 0 || blinks == 0)) {
+        printf("FAIL: backlight / blink effects never produced\n");
+        failures++;
+    }
+
+    free(evs);
+    return failures ? 1 : 0;
+}
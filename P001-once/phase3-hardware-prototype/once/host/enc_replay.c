@@ -0,0 +1,543 @@
+// enc_replay.c
+// 旋钮回放：把一段 A/B/C 波形按原来的时刻灌进仿真引脚，跑真正的驱动（定时器采样 + quad_table、
+// 按键锁定去抖），再把解出来的事件喂给加速（原来的六档阶梯 STEP_TAB 和现在的转速曲线），
+// 和同一段波形的“理想解码”比：
+//   - 旋转：每条边沿都看到、逐条查表，凑满一格的那条边沿就是这一格的真实时刻；
+//   - 按键：C 拉低并保持 PRESS_MIN_US 以上算一次，前面的抖动也算这一次，时刻取这一串的第一条下降沿。
+// 报解出来的格数 / 真实格数、漏的、多的、按键数，每个事件的检测延迟，两种加速最后拧到的目标时间。
+//
+// 用法：
+//   enc_replay capture.txt               板子上 'x' 录的串口输出（只认 "#E" 行，其余忽略；- 表示 stdin）
+//   enc_replay -s 4 -n 40 -b 3 -j 30     合成一段：每格 ms、格数、每条边沿抖几下、相位时长随机 ±%
+//              [-p 2] [-r]               外加几次按键（按键也抖 -b 下）、反着拧（默认往大拧）
+//   enc_replay                           内置一组合成波形：转速 × 抖动 × 相位抖动，都带两次抖动的按键
+// 其他选项：
+//   -c slow,fast,hold,kick   采样设置，默认 board.h 的 ENCODER_SAMPLE_*；1000,1000,0,0 就是原来的固定 1 kHz
+//   -v                       逐个事件打印 "#L <cw|ccw|key> <真实 us> <解出 us> <延迟 us>"，漏的解出时刻为 -
+//   -o                       只打印合成出来的波形（"#E" 格式，和板子录的一样），不回放
+// 每段一行 "[REPLAY] name key=value ..."。内置组合里不抖 2 ms/格、抖 4 ms/格以上漏格、多格、漏按键，
+// 或者阶梯算出来的目标时间对不上，返回 1（抖动吃掉了相位里的稳定段，2 ms/格带抖动时快采也会漏）。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "drivers/board.h"
+#include "drivers/encoder_ec11.h"
+#include "drivers/enc_capture.h"
+#include "app/accel.h"
+#include "app/timer_fsm.h"
+
+#define SETTLE_US       1000000u    // 每段开始前静止这么久：采样退回慢采、按键锁定期结束
+#define TAIL_US         200000u     // 最后一条边沿之后再等这么久收事件
+#define DRAIN_US        5000u       // 每隔这么久取一次事件，事件环不会满
+#define PRESS_MIN_US    5000u       // 理想解码：C 低 / 高要保持这么久才算稳定
+#define MATCH_US        50000u      // 解出的事件最多比真实时刻晚这么多还算对得上
+#define BOUNCE_US       40u         // 合成：A/B 每下抖动的宽度（相位太短时按比例缩）
+#define BTN_BOUNCE_US   300u        // 合成：按键每下抖动的宽度，和 sim_main.c 一样
+#define BTN_HOLD_US     80000u
+#define BTN_GAP_US      300000u
+
+typedef struct {
+    uint64_t t_us;
+    uint8_t  pins;      // ENC_CAPTURE_A / B / C，1 = 高
+} edge_t;
+
+typedef struct {
+    edge_t *e;
+    size_t  n, cap;
+} trace_t;
+
+typedef struct {
+    encoder_event_t *e;
+    size_t           n, cap;
+} events_t;
+
+typedef struct {
+    uint32_t ms_per_detent;
+    uint32_t detents;
+    uint32_t bounces;
+    uint32_t jitter_pct;
+    uint32_t presses;
+    bool     reverse;
+} synth_t;
+
+typedef struct {
+    uint32_t truth[4], decoded[4];   // 按事件种类（cw / ccw / key）
+    uint32_t missed, extra;
+    uint32_t matched;
+    uint64_t lat_sum_us;
+    uint32_t lat_max_us;
+    uint32_t ref_invalid;            // 录下来的波形里 A/B 同时变了（两条边沿挤在一次中断里）
+    uint32_t invalid;                // 驱动采样看到的
+    int32_t  ladder_true, ladder_dec;
+    int32_t  curve_true, curve_dec;
+} result_t;
+
+static bool verbose = false;
+
+static uint32_t rng_state = 0x7f4a7c15u;
+
+static uint32_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void *grow(void *p, size_t *cap, size_t n, size_t size) {
+    if (n < *cap) {
+        return p;
+    }
+    *cap = *cap ? *cap * 2 : 256;
+    p = realloc(p, *cap * size);
+    if (!p) {
+        abort();
+    }
+    return p;
+}
+
+static void trace_add(trace_t *tr, uint64_t t_us, uint8_t pins) {
+    tr->e = grow(tr->e, &tr->cap, tr->n, sizeof(*tr->e));
+    tr->e[tr->n++] = (edge_t){ t_us, pins };
+}
+
+static void events_add(events_t *ev, uint64_t t_us, uint8_t type) {
+    ev->e = grow(ev->e, &ev->cap, ev->n, sizeof(*ev->e));
+    ev->e[ev->n++] = (encoder_event_t){ t_us, type };
+}
+
+// ---------- 波形来源 ----------
+
+// "#E <t_us> <ABC>"，行里前面有别的东西（时间戳、日志前缀）也认
+static bool trace_load(FILE *f, trace_t *tr) {
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        const char *p = strstr(line, "#E ");
+        unsigned long long t;
+        char bits[4];
+        if (!p || sscanf(p + 3, "%llu %3s", &t, bits) != 2 || strlen(bits) != 3) {
+            continue;
+        }
+        uint8_t pins = (uint8_t)((bits[0] == '1' ? ENC_CAPTURE_A : 0u) | (bits[1] == '1' ? ENC_CAPTURE_B : 0u) |
+                                 (bits[2] == '1' ? ENC_CAPTURE_C : 0u));
+        trace_add(tr, (uint64_t)t, pins);
+    }
+    return tr->n > 0;
+}
+
+// 一条脚从 old 变到 new：先来回抖 bounces 下（每下 width us），最后停在 new
+static uint64_t synth_toggle(trace_t *tr, uint64_t t, uint8_t *pins, uint8_t bit, bool level,
+                             uint32_t bounces, uint32_t width) {
+    for (uint32_t k = 0; k < bounces; ++k) {
+        *pins = level ? (*pins | bit) : (*pins & ~bit);
+        trace_add(tr, t, *pins);
+        t += width;
+        *pins = level ? (*pins & ~bit) : (*pins | bit);
+        trace_add(tr, t, *pins);
+        t += width;
+    }
+    *pins = level ? (*pins | bit) : (*pins & ~bit);
+    trace_add(tr, t, *pins);
+    return t;
+}
+
+// 和 sim_main.c 一样：一格 4 个相位，cw 是 A 先落下；默认往大拧（驱动里的 ccw）
+static void synth_make(const synth_t *s, trace_t *tr) {
+    static const uint8_t SEQ_CW[4]  = { ENC_CAPTURE_B, 0, ENC_CAPTURE_A, ENC_CAPTURE_A | ENC_CAPTURE_B };
+    static const uint8_t SEQ_CCW[4] = { ENC_CAPTURE_A, 0, ENC_CAPTURE_B, ENC_CAPTURE_A | ENC_CAPTURE_B };
+    const uint8_t *seq = s->reverse ? SEQ_CW : SEQ_CCW;
+    const uint8_t  AB  = ENC_CAPTURE_A | ENC_CAPTURE_B;
+
+    uint8_t  pins = AB | ENC_CAPTURE_C;
+    uint64_t t    = 0;
+    trace_add(tr, t, pins);
+    t += 10000u;
+
+    uint32_t step = s->ms_per_detent * 1000u / 4u;
+    for (uint32_t d = 0; d < s->detents; ++d) {
+        for (int k = 0; k < 4; ++k) {
+            uint32_t span = step;
+            if (s->jitter_pct) {
+                uint32_t j = step * s->jitter_pct / 100u;
+                span = step - j + rng_next() % (2u * j + 1u);
+            }
+            uint8_t  changed = (uint8_t)((pins ^ seq[k]) & AB);
+            uint32_t width   = BOUNCE_US;
+            if (s->bounces && width * (2u * s->bounces + 2u) > span) {
+                width = span / (2u * s->bounces + 2u);
+            }
+            synth_toggle(tr, t, &pins, changed, (seq[k] & changed) != 0, s->bounces, width ? width : 1u);
+            t += span;
+        }
+    }
+
+    for (uint32_t p = 0; p < s->presses; ++p) {
+        t += BTN_GAP_US;
+        t = synth_toggle(tr, t, &pins, ENC_CAPTURE_C, false, s->bounces, BTN_BOUNCE_US);
+        t += BTN_HOLD_US;
+        t = synth_toggle(tr, t, &pins, ENC_CAPTURE_C, true, s->bounces, BTN_BOUNCE_US);
+    }
+}
+
+static void trace_print(const trace_t *tr) {
+    for (size_t i = 0; i < tr->n; ++i) {
+        uint8_t p = tr->e[i].pins;
+        printf("#E %llu %u%u%u\n", (unsigned long long)tr->e[i].t_us,
+               (p & ENC_CAPTURE_A) ? 1u : 0u, (p & ENC_CAPTURE_B) ? 1u : 0u, (p & ENC_CAPTURE_C) ? 1u : 0u);
+    }
+}
+
+// ---------- 理想解码 ----------
+
+// 和驱动里的 quad_table / STEPS_PER_NOTCH 一样：prev << 2 | curr，curr = B << 1 | A，4 步一格
+#define STEPS_PER_NOTCH  4
+
+static const int8_t QUAD[16] = {
+     0, +1, -1,  0,
+    -1,  0,  0, +1,
+    +1,  0,  0, -1,
+     0, -1, +1,  0,
+};
+
+static void decode_ideal(const trace_t *tr, events_t *out, uint32_t *invalid) {
+    uint8_t prev  = tr->e[0].pins & 3u;
+    int32_t accum = 0;
+    *invalid = 0;
+
+    // 按键：一串抖动的第一条下降沿，这一串里有一段低电平保持够久才算
+    bool     c_prev     = (tr->e[0].pins & ENC_CAPTURE_C) != 0;
+    bool     in_burst   = false, burst_ok = false;
+    uint64_t burst_t    = 0, low_since = 0, high_since = 0;
+
+    for (size_t i = 1; i < tr->n; ++i) {
+        uint64_t t  = tr->e[i].t_us;
+        uint8_t  ab = tr->e[i].pins & 3u;
+        if (ab != prev) {
+            if ((ab ^ prev) == 3u) {
+                (*invalid)++;
+            }
+            accum += QUAD[(prev << 2) | ab];
+            while (accum >= STEPS_PER_NOTCH) {
+                accum -= STEPS_PER_NOTCH;
+                events_add(out, t, cw);
+            }
+            while (accum <= -STEPS_PER_NOTCH) {
+                accum += STEPS_PER_NOTCH;
+                events_add(out, t, ccw);
+            }
+            prev = ab;
+        }
+
+        bool c = (tr->e[i].pins & ENC_CAPTURE_C) != 0;
+        if (c == c_prev) {
+            continue;
+        }
+        if (!c) {
+            if (in_burst && t - high_since >= PRESS_MIN_US) {
+                if (burst_ok) {
+                    events_add(out, burst_t, key);
+                }
+                in_burst = false;
+            }
+            if (!in_burst) {
+                in_burst = true;
+                burst_ok = false;
+                burst_t  = t;
+            }
+            low_since = t;
+        } else {
+            if (t - low_since >= PRESS_MIN_US) {
+                burst_ok = true;
+            }
+            high_since = t;
+        }
+        c_prev = c;
+    }
+    if (in_burst && (burst_ok || (!c_prev && tr->e[tr->n - 1].t_us + TAIL_US - low_since >= PRESS_MIN_US))) {
+        events_add(out, burst_t, key);
+    }
+
+    // 按键和旋转分开追加的，按时刻排一下（稳定插入，量不大）
+    for (size_t i = 1; i < out->n; ++i) {
+        encoder_event_t x = out->e[i];
+        size_t j = i;
+        while (j > 0 && out->e[j - 1].t_us > x.t_us) {
+            out->e[j] = out->e[j - 1];
+            j--;
+        }
+        out->e[j] = x;
+    }
+}
+
+// ---------- 真驱动 ----------
+
+static void drive_pins(void *ctx) {
+    uint8_t pins = (uint8_t)(uintptr_t)ctx;
+    static const struct { uint8_t bit; uint pin; } MAP[3] = {
+        { ENC_CAPTURE_A, ENCODER_EC11_PIN_A },
+        { ENC_CAPTURE_B, ENCODER_EC11_PIN_B },
+        { ENC_CAPTURE_C, ENCODER_EC11_PIN_C },
+    };
+    for (int i = 0; i < 3; ++i) {
+        if (pins & MAP[i].bit) {
+            sim_pin_release(MAP[i].pin);   // 上拉
+        } else {
+            sim_pin_drive(MAP[i].pin, false);
+        }
+    }
+}
+
+static void decode_driver(const trace_t *tr, const encoder_sampling_t *cfg, events_t *out, uint32_t *invalid) {
+    drive_pins((void *)(uintptr_t)tr->e[0].pins);
+    Encoder_Init();
+    Encoder_SetSampling(cfg);
+    sim_run_until(sim_now_us() + SETTLE_US);
+
+    encoder_stats_t s0, s1;
+    Encoder_GetStats(&s0);
+
+    // 波形的时间轴平移到仿真时钟上
+    uint64_t base = sim_now_us() + 1000u - tr->e[0].t_us;
+    for (size_t i = 1; i < tr->n; ++i) {
+        sim_schedule(tr->e[i].t_us + base, drive_pins, (void *)(uintptr_t)tr->e[i].pins);
+    }
+
+    uint64_t end = tr->e[tr->n - 1].t_us + base + TAIL_US;
+    encoder_event_t ev;
+    for (uint64_t t = sim_now_us(); t < end;) {
+        t = (t + DRAIN_US < end) ? t + DRAIN_US : end;
+        sim_run_until(t);
+        while (Encoder_ReadEvent(&ev)) {
+            events_add(out, ev.t_us - base, ev.type);
+        }
+    }
+
+    Encoder_GetStats(&s1);
+    *invalid = s1.invalid - s0.invalid;
+}
+
+// ---------- 比较 ----------
+
+static const char *type_name(uint8_t type) {
+    return type == cw ? "cw" : (type == ccw ? "ccw" : "key");
+}
+
+// 同一种事件按先后配对：解出的比真实的早（容一点）或者晚太多就算对不上
+static void match_type(const events_t *ref, const events_t *dec, uint8_t type, result_t *r) {
+    size_t i = 0, j = 0;
+    for (;;) {
+        while (i < ref->n && ref->e[i].type != type) i++;
+        while (j < dec->n && dec->e[j].type != type) j++;
+        if (i >= ref->n || j >= dec->n) {
+            break;
+        }
+        uint64_t tr = ref->e[i].t_us, td = dec->e[j].t_us;
+        if (td + 1000u < tr) {
+            r->extra++;
+            j++;
+        } else if (td > tr + MATCH_US) {
+            r->missed++;
+            if (verbose) {
+                printf("#L %s %llu - -\n", type_name(type), (unsigned long long)tr);
+            }
+            i++;
+        } else {
+            uint32_t lat = (td > tr) ? (uint32_t)(td - tr) : 0;
+            r->matched++;
+            r->lat_sum_us += lat;
+            if (lat > r->lat_max_us) {
+                r->lat_max_us = lat;
+            }
+            if (verbose) {
+                printf("#L %s %llu %llu %lu\n", type_name(type), (unsigned long long)tr,
+                       (unsigned long long)td, (unsigned long)lat);
+            }
+            i++;
+            j++;
+        }
+    }
+    for (; i < ref->n; ++i) {
+        if (ref->e[i].type == type) {
+            r->missed++;
+            if (verbose) {
+                printf("#L %s %llu - -\n", type_name(type), (unsigned long long)ref->e[i].t_us);
+            }
+        }
+    }
+    for (; j < dec->n; ++j) {
+        if (dec->e[j].type == type) {
+            r->extra++;
+        }
+    }
+}
+
+// 和 once.c 一样：ccw 往大，目标从 0 开始，夹在 0 .. TIMER_FSM_MAX_SEC
+static void run_accel(const events_t *ev, int32_t *ladder_sec, int32_t *curve_sec) {
+    accel_ladder_t l;
+    accel_t        a;
+    accel_ladder_reset(&l);
+    accel_reset(&a);
+    int32_t tl = 0, tc = 0;
+    for (size_t i = 0; i < ev->n; ++i) {
+        if (ev->e[i].type != cw && ev->e[i].type != ccw) {
+            continue;
+        }
+        int8_t dir = (ev->e[i].type == ccw) ? +1 : -1;
+        tl += accel_ladder_step(&l, dir, ev->e[i].t_us);
+        tc += accel_step(&a, &ACCEL_CURVE_DEFAULT, dir, ev->e[i].t_us, (uint16_t)tc);
+        tl = tl < 0 ? 0 : (tl > TIMER_FSM_MAX_SEC ? TIMER_FSM_MAX_SEC : tl);
+        tc = tc < 0 ? 0 : (tc > TIMER_FSM_MAX_SEC ? TIMER_FSM_MAX_SEC : tc);
+    }
+    *ladder_sec = tl;
+    *curve_sec  = tc;
+}
+
+static result_t replay(const char *name, const trace_t *tr, const encoder_sampling_t *cfg) {
+    result_t r;
+    memset(&r, 0, sizeof(r));
+    events_t ref = {0}, dec = {0};
+
+    decode_ideal(tr, &ref, &r.ref_invalid);
+    decode_driver(tr, cfg, &dec, &r.invalid);
+    for (size_t i = 0; i < ref.n; ++i) r.truth[ref.e[i].type]++;
+    for (size_t i = 0; i < dec.n; ++i) r.decoded[dec.e[i].type]++;
+
+    match_type(&ref, &dec, cw, &r);
+    match_type(&ref, &dec, ccw, &r);
+    match_type(&ref, &dec, key, &r);
+    run_accel(&ref, &r.ladder_true, &r.curve_true);
+    run_accel(&dec, &r.ladder_dec, &r.curve_dec);
+
+    printf("[REPLAY] %s edges=%lu true=%lu/%lu decoded=%lu/%lu missed=%lu extra=%lu keys=%lu/%lu "
+           "lat_avg_us=%lu lat_max_us=%lu invalid=%lu ref_invalid=%lu ladder_s=%ld/%ld curve_s=%ld/%ld\n",
+           name, (unsigned long)(tr->n - 1),
+           (unsigned long)r.truth[cw], (unsigned long)r.truth[ccw],
+           (unsigned long)r.decoded[cw], (unsigned long)r.decoded[ccw],
+           (unsigned long)r.missed, (unsigned long)r.extra,
+           (unsigned long)r.decoded[key], (unsigned long)r.truth[key],
+           (unsigned long)(r.matched ? r.lat_sum_us / r.matched : 0), (unsigned long)r.lat_max_us,
+           (unsigned long)r.invalid, (unsigned long)r.ref_invalid,
+           (long)r.ladder_dec, (long)r.ladder_true, (long)r.curve_dec, (long)r.curve_true);
+
+    free(ref.e);
+    free(dec.e);
+    return r;
+}
+
+// ---------- 命令行 ----------
+
+static const uint32_t SUITE_MS[]       = { 20, 8, 4, 2, 1 };
+static const uint32_t SUITE_BOUNCES[]  = { 0, 3 };
+static const uint32_t SUITE_JITTER[]   = { 0, 30 };
+
+static int run_suite(const encoder_sampling_t *cfg) {
+    uint32_t failures = 0;
+    for (size_t a = 0; a < sizeof(SUITE_MS) / sizeof(SUITE_MS[0]); ++a) {
+        for (size_t b = 0; b < sizeof(SUITE_BOUNCES) / sizeof(SUITE_BOUNCES[0]); ++b) {
+            for (size_t c = 0; c < sizeof(SUITE_JITTER) / sizeof(SUITE_JITTER[0]); ++c) {
+                synth_t s = { SUITE_MS[a], 40, SUITE_BOUNCES[b], SUITE_JITTER[c], 2, (a & 1) != 0 };
+                char name[64];
+                snprintf(name, sizeof(name), "synth_%lums_b%lu_j%lu", (unsigned long)s.ms_per_detent,
+                         (unsigned long)s.bounces, (unsigned long)s.jitter_pct);
+                trace_t tr = {0};
+                synth_make(&s, &tr);
+                result_t r = replay(name, &tr, cfg);
+                free(tr.e);
+
+                bool bad = r.truth[cw] + r.truth[ccw] != s.detents || r.truth[key] != s.presses;
+                if (s.ms_per_detent >= (s.bounces ? 4u : 2u)) {
+                    bad = bad || r.missed > 0 || r.extra > 0 || r.ladder_dec != r.ladder_true;
+                }
+                if (bad) {
+                    printf("[REPLAY] ^ FAIL\n");
+                    failures++;
+                }
+            }
+        }
+    }
+    printf("[REPLAY] %s (%u failed)\n", failures ? "FAIL" : "OK", failures);
+    return failures ? 1 : 0;
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: enc_replay [-v] [-c slow,fast,hold,kick] [capture.txt | -]\n"
+                    "       enc_replay [-v] [-o] [-c ...] -s ms/detent [-n detents] [-b bounces] [-j jitter%%] "
+                    "[-p presses] [-r]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    encoder_sampling_t cfg = {
+        ENCODER_SAMPLE_SLOW_US, ENCODER_SAMPLE_FAST_US, ENCODER_SAMPLE_HOLD_US, ENCODER_SAMPLE_EDGE_KICK != 0
+    };
+    synth_t     s      = { 0, 40, 0, 0, 0, false };
+    bool        synth  = false, only_print = false;
+    const char *path   = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        bool has_val = (i + 1 < argc);
+        if (strcmp(a, "-v") == 0) {
+            verbose = true;
+        } else if (strcmp(a, "-o") == 0) {
+            only_print = true;
+        } else if (strcmp(a, "-r") == 0) {
+            s.reverse = true;
+        } else if (strcmp(a, "-c") == 0 && has_val) {
+            unsigned long v[4];
+            if (sscanf(argv[++i], "%lu,%lu,%lu,%lu", &v[0], &v[1], &v[2], &v[3]) != 4 || !v[0] || !v[1]) {
+                usage();
+            }
+            cfg = (encoder_sampling_t){ (uint32_t)v[0], (uint32_t)v[1], (uint32_t)v[2], v[3] != 0 };
+        } else if (a[0] == '-' && a[1] && a[2] == '\0' && strchr("snbjp", a[1]) && has_val) {
+            uint32_t v = (uint32_t)strtoul(argv[++i], NULL, 10);
+            switch (a[1]) {
+            case 's': s.ms_per_detent = v; break;
+            case 'n': s.detents = v;       break;
+            case 'b': s.bounces = v;       break;
+            case 'j': s.jitter_pct = v;    break;
+            case 'p': s.presses = v;       break;
+            }
+            synth = true;
+        } else if (!path && (a[0] != '-' || a[1] == '\0')) {
+            path = a;
+        } else {
+            usage();
+        }
+    }
+
+    if (!synth && !path) {
+        return run_suite(&cfg);
+    }
+
+    trace_t tr = {0};
+    char name[64];
+    if (synth) {
+        if (s.ms_per_detent == 0) {
+            usage();
+        }
+        synth_make(&s, &tr);
+        snprintf(name, sizeof(name), "synth_%lums_b%lu_j%lu", (unsigned long)s.ms_per_detent,
+                 (unsigned long)s.bounces, (unsigned long)s.jitter_pct);
+        if (only_print) {
+            trace_print(&tr);
+            return 0;
+        }
+    } else {
+        FILE *f = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+        if (!f || !trace_load(f, &tr)) {
+            fprintf(stderr, "[REPLAY] no \"#E\" lines in %s\n", path);
+            return 2;
+        }
+        if (f != stdin) {
+            fclose(f);
+        }
+        snprintf(name, sizeof(name), "%s", path);
+    }
+
+    replay(name, &tr, &cfg);
+    free(tr.e);
+    return 0;
+}
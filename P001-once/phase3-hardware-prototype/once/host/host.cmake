@@ -0,0 +1,201 @@
+# host.cmake
+# 主机仿真目标 once_host：固件源码原样编译，只把 SDK 头换成 host/sdk。
+# 仿真里没有 PIO / DMA / I2C 外设，也只有一个核：编码器走定时器采样，LCD 走位模拟
+# （正好让仿真 PCF8576 从引脚上把帧解出来）。PWM 只有背光用的那点：比较值、极性和回绕中断。
+
+set(ONCE_DIR ${CMAKE_CURRENT_LIST_DIR}/..)
+
+add_executable(once_host
+        ${ONCE_DIR}/once.c
+        ${ONCE_DIR}/drivers/lcd_pcf8576.c
+        ${ONCE_DIR}/drivers/lcd_bus.c
+        ${ONCE_DIR}/drivers/encoder_ec11.c
+        ${ONCE_DIR}/drivers/enc_capture.c
+        ${ONCE_DIR}/drivers/deadline.c
+        ${ONCE_DIR}/drivers/instr.c
+        ${ONCE_DIR}/drivers/trace.c
+        ${ONCE_DIR}/drivers/ui_core.c
+        ${ONCE_DIR}/drivers/cpu_load.c
+        ${ONCE_DIR}/drivers/session_log.c
+        ${ONCE_DIR}/drivers/flash_log.c
+        ${ONCE_DIR}/drivers/boot_time.c
+        ${ONCE_DIR}/drivers/power.c
+        ${ONCE_DIR}/drivers/backlight.c
+        ${ONCE_DIR}/app/timer_fsm.c
+        ${ONCE_DIR}/app/accel.c
+        ${ONCE_DIR}/app/score.c
+        ${ONCE_DIR}/app/calib.c
+        ${ONCE_DIR}/host/sim.c
+        ${ONCE_DIR}/host/sim_flash.c
+        ${ONCE_DIR}/host/mock_pcf8576.c
+        ${ONCE_DIR}/host/sim_main.c
+)
+
+target_include_directories(once_host PRIVATE
+        ${ONCE_DIR}/host/sdk
+        ${ONCE_DIR}/host
+        ${ONCE_DIR}
+        ${ONCE_DIR}/drivers
+)
+
+target_compile_definitions(once_host PRIVATE
+        ONCE_HOST=1
+        LIB_PICO_STDIO_USB=1
+        ENCODER_USE_PIO=0
+        LCD_BUS_HAS_HW=0
+        LCD_BUS_DEFAULT=LCD_BUS_BITBANG
+        ONCE_DUAL_CORE=0
+)
+
+# once.c 的 main 交给仿真入口去调
+set_source_files_properties(${ONCE_DIR}/once.c PROPERTIES COMPILE_DEFINITIONS main=once_main)
+
+target_compile_options(once_host PRIVATE -Wall -Wextra)
+
+# 状态机单独的基准：不带仿真，只链接 timer_fsm.c
+add_executable(bench_timer_fsm
+        ${ONCE_DIR}/host/bench_timer_fsm.c
+        ${ONCE_DIR}/app/timer_fsm.c
+)
+target_include_directories(bench_timer_fsm PRIVATE ${ONCE_DIR})
+target_compile_options(bench_timer_fsm PRIVATE -Wall -Wextra -O2)
+
+# 旋钮加速回放：六档阶梯 vs 转速曲线
+add_executable(bench_accel
+        ${ONCE_DIR}/host/bench_accel.c
+        ${ONCE_DIR}/app/accel.c
+)
+target_include_directories(bench_accel PRIVATE ${ONCE_DIR})
+target_compile_options(bench_accel PRIVATE -Wall -Wextra -O2)
+
+# 打分：定点查表 vs 浮点参考，精度和耗时
+add_executable(bench_score
+        ${ONCE_DIR}/host/bench_score.c
+        ${ONCE_DIR}/app/score.c
+)
+target_include_directories(bench_score PRIVATE ${ONCE_DIR})
+target_compile_options(bench_score PRIVATE -Wall -Wextra -O2)
+target_link_libraries(bench_score PRIVATE m)
+
+# 校准统计：定点流式统计 vs 双精度两遍算法 / 精确分位数
+add_executable(bench_calib
+        ${ONCE_DIR}/host/bench_calib.c
+        ${ONCE_DIR}/app/calib.c
+)
+target_include_directories(bench_calib PRIVATE ${ONCE_DIR})
+target_compile_options(bench_calib PRIVATE -Wall -Wextra -O2)
+target_link_libraries(bench_calib PRIVATE m)
+
+# 会话记录：反复追加 + 模拟重启 / 断电，检查开机找头、轮转擦除和关中断窗口
+add_executable(bench_session_log
+        ${ONCE_DIR}/host/bench_session_log.c
+        ${ONCE_DIR}/drivers/session_log.c
+        ${ONCE_DIR}/drivers/flash_log.c
+        ${ONCE_DIR}/app/calib.c
+        ${ONCE_DIR}/drivers/trace.c
+        ${ONCE_DIR}/host/sim.c
+        ${ONCE_DIR}/host/sim_flash.c
+)
+target_include_directories(bench_session_log PRIVATE
+        ${ONCE_DIR}/host/sdk
+        ${ONCE_DIR}/host
+        ${ONCE_DIR}
+        ${ONCE_DIR}/drivers
+)
+target_compile_definitions(bench_session_log PRIVATE ONCE_HOST=1)
+target_compile_options(bench_session_log PRIVATE -Wall -Wextra -O2)
+
+# 事件日志解码：once_host 或者板子的串口输出接到它的 stdin
+add_executable(trace_decode
+        ${ONCE_DIR}/host/trace_decode.c
+)
+target_include_directories(trace_decode PRIVATE ${ONCE_DIR} ${ONCE_DIR}/drivers)
+target_compile_options(trace_decode PRIVATE -Wall -Wextra -O2)
+
+# 旋钮采样率：固定 1 kHz vs 自适应（有 / 没有边沿中断）的漏格、延迟和中断数
+add_executable(bench_encoder
+        ${ONCE_DIR}/host/bench_encoder.c
+        ${ONCE_DIR}/drivers/encoder_ec11.c
+        ${ONCE_DIR}/drivers/enc_capture.c
+        ${ONCE_DIR}/drivers/instr.c
+        ${ONCE_DIR}/drivers/trace.c
+        ${ONCE_DIR}/host/sim.c
+        ${ONCE_DIR}/host/sim_flash.c
+)
+target_include_directories(bench_encoder PRIVATE
+        ${ONCE_DIR}/host/sdk
+        ${ONCE_DIR}/host
+        ${ONCE_DIR}
+        ${ONCE_DIR}/drivers
+)
+target_compile_definitions(bench_encoder PRIVATE ONCE_HOST=1 ENCODER_USE_PIO=0)
+target_compile_options(bench_encoder PRIVATE -Wall -Wextra -O2)
+
+# 旋钮回放：板子上录的 / 合成的 A/B/C 波形过一遍真驱动和加速，和理想解码比
+add_executable(enc_replay
+        ${ONCE_DIR}/host/enc_replay.c
+        ${ONCE_DIR}/drivers/encoder_ec11.c
+        ${ONCE_DIR}/drivers/enc_capture.c
+        ${ONCE_DIR}/drivers/instr.c
+        ${ONCE_DIR}/drivers/trace.c
+        ${ONCE_DIR}/app/accel.c
+        ${ONCE_DIR}/host/sim.c
+        ${ONCE_DIR}/host/sim_flash.c
+)
+target_include_directories(enc_replay PRIVATE
+        ${ONCE_DIR}/host/sdk
+        ${ONCE_DIR}/host
+        ${ONCE_DIR}
+        ${ONCE_DIR}/drivers
+)
+target_compile_definitions(enc_replay PRIVATE ONCE_HOST=1 ENCODER_USE_PIO=0)
+target_compile_options(enc_replay PRIVATE -Wall -Wextra -O2)
+
+# 微基准：bench/ 里和板子上 once_bench.uf2 同一份内核，原生编译；输出给 bench_compare 比
+add_executable(once_bench_host
+        ${ONCE_DIR}/bench/once_bench.c
+        ${ONCE_DIR}/bench/bench_kernels.c
+        ${ONCE_DIR}/drivers/lcd_pcf8576.c
+        ${ONCE_DIR}/drivers/lcd_bus.c
+        ${ONCE_DIR}/drivers/backlight.c
+        ${ONCE_DIR}/drivers/encoder_ec11.c
+        ${ONCE_DIR}/drivers/enc_capture.c
+        ${ONCE_DIR}/drivers/instr.c
+        ${ONCE_DIR}/drivers/trace.c
+        ${ONCE_DIR}/app/timer_fsm.c
+        ${ONCE_DIR}/app/accel.c
+        ${ONCE_DIR}/app/score.c
+        ${ONCE_DIR}/app/calib.c
+        ${ONCE_DIR}/host/sim.c
+        ${ONCE_DIR}/host/sim_flash.c
+        ${ONCE_DIR}/host/mock_pcf8576.c
+        ${ONCE_DIR}/host/once_bench_host.c
+)
+target_include_directories(once_bench_host PRIVATE
+        ${ONCE_DIR}/host/sdk
+        ${ONCE_DIR}/host
+        ${ONCE_DIR}
+        ${ONCE_DIR}/drivers
+)
+target_compile_definitions(once_bench_host PRIVATE
+        ONCE_HOST=1
+        ONCE_BENCH=1
+        ENCODER_USE_PIO=0
+        LCD_BUS_HAS_HW=0
+        LCD_BUS_DEFAULT=LCD_BUS_BITBANG
+        ONCE_DUAL_CORE=0
+)
+set_source_files_properties(${ONCE_DIR}/bench/once_bench.c PROPERTIES COMPILE_DEFINITIONS main=once_bench_main)
+target_compile_options(once_bench_host PRIVATE -Wall -Wextra -O2)
+
+# 比两次 once_bench 的结果，慢了超过容差返回 1
+add_executable(bench_compare
+        ${ONCE_DIR}/host/bench_compare.c
+)
+target_compile_options(bench_compare PRIVATE -Wall -Wextra -O2)
+
+# 固件 map 文件的存储占用：各区用量、放进 SRAM 的热函数，两个 map 时报差（ONCE_RAM_HOT / ONCE_COPY_TO_RAM 的代价）
+add_executable(map_ram
+        ${ONCE_DIR}/host/map_ram.c
+)
+target_compile_options(map_ram PRIVATE -Wall -Wextra -O2)
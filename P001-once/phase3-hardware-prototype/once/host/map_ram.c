@@ -0,0 +1,232 @@
+// map_ram.c
+// 读固件链接出来的 map 文件（build/once.elf.map，pico_add_extra_outputs 会生成），报每块存储用了多少：
+//   - Memory Configuration 里的每个区（FLASH / RAM / SCRATCH_X / SCRATCH_Y），按输出段的地址归进去；
+//   - .time_critical.* 输入段逐个列出（ONCE_RAM_HOT 放进 SRAM 的函数），这就是热路径的 RAM 代价。
+// 给两个 map（比如 ONCE_RAM_HOT=0 / 1，或者 ONCE_COPY_TO_RAM=ON）时再报每个区的差。
+//
+// 用法：map_ram <once.elf.map> [另一个 map]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MAX_REGIONS   8
+#define MAX_SECTIONS  128
+#define MAX_HOT       128
+
+typedef struct {
+    char     name[24];
+    uint64_t origin;
+    uint64_t length;
+    uint64_t used;
+} region_t;
+
+typedef struct {
+    char     name[40];
+    uint64_t addr;
+    uint64_t size;
+    uint64_t load;     // 开机从 flash 拷过来的段（.data 之类）的镜像地址，0 = 没有
+} section_t;
+
+typedef struct {
+    region_t  regions[MAX_REGIONS];
+    int       n_regions;
+    section_t sections[MAX_SECTIONS];   // 输出段
+    int       n_sections;
+    section_t hot[MAX_HOT];             // .time_critical.* 输入段
+    int       n_hot;
+    uint64_t  hot_bytes;
+} map_t;
+
+// 段名后面跟的 "地址 大小"；名字太长时 ld 把它们放到下一行
+static bool parse_addr_size(const char *s, uint64_t *addr, uint64_t *size) {
+    char *end;
+    *addr = strtoull(s, &end, 16);
+    if (end == s) {
+        return false;
+    }
+    const char *p = end;
+    *size = strtoull(p, &end, 16);
+    return end != p;
+}
+
+static void add_section(section_t *tab, int *n, int max, const char *name, uint64_t addr, uint64_t size,
+                        const char *line) {
+    if (*n >= max) {
+        return;
+    }
+    const char *load = strstr(line, "load address");
+    snprintf(tab[*n].name, sizeof(tab[*n].name), "%s", name);
+    tab[*n].addr = addr;
+    tab[*n].size = size;
+    tab[*n].load = load ? strtoull(load + 12, NULL, 16) : 0;
+    (*n)++;
+}
+
+static region_t *region_of(map_t *m, uint64_t addr) {
+    for (int k = 0; k < m->n_regions; ++k) {
+        region_t *r = &m->regions[k];
+        if (addr >= r->origin && addr < r->origin + r->length) {
+            return r;
+        }
+    }
+    return NULL;
+}
+
+static int load(const char *path, map_t *m) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    memset(m, 0, sizeof(*m));
+
+    enum { HEAD, MEMORY, LAYOUT } part = HEAD;
+    char line[512];
+    char pending[64] = "";      // 上一行只有段名，地址和大小在这一行
+    bool pending_hot = false;
+
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "Memory Configuration", 20) == 0) {
+            part = MEMORY;
+            continue;
+        }
+        if (strncmp(line, "Linker script and memory map", 28) == 0) {
+            part = LAYOUT;
+            continue;
+        }
+
+        if (part == MEMORY) {
+            region_t r = {0};
+            if (m->n_regions < MAX_REGIONS &&
+                sscanf(line, "%23s %llx %llx", r.name, (unsigned long long *)&r.origin,
+                       (unsigned long long *)&r.length) == 3 &&
+                strcmp(r.name, "*default*") != 0) {
+                m->regions[m->n_regions++] = r;
+            }
+            continue;
+        }
+        if (part != LAYOUT) {
+            continue;
+        }
+
+        uint64_t addr, size;
+        char name[64];
+        if (pending[0]) {
+            if (parse_addr_size(line, &addr, &size)) {
+                if (pending_hot) {
+                    add_section(m->hot, &m->n_hot, MAX_HOT, pending + 15, addr, size, line);
+                    m->hot_bytes += size;
+                } else {
+                    add_section(m->sections, &m->n_sections, MAX_SECTIONS, pending, addr, size, line);
+                }
+            }
+            pending[0] = '\0';
+            continue;
+        }
+
+        if (line[0] == '.') {
+            // 输出段：".data  0x20000000  0x2c4 load address 0x10005c40"
+            if (sscanf(line, "%63s", name) != 1) {
+                continue;
+            }
+            if (parse_addr_size(line + strlen(name), &addr, &size)) {
+                add_section(m->sections, &m->n_sections, MAX_SECTIONS, name, addr, size, line);
+            } else {
+                snprintf(pending, sizeof(pending), "%s", name);
+                pending_hot = false;
+            }
+        } else if (strncmp(line, " .time_critical.", 16) == 0) {
+            // 输入段：" .time_critical.encoder_timer_callback  0x20000110  0x1c  xxx.obj"
+            if (sscanf(line + 1, "%63s", name) != 1) {
+                continue;
+            }
+            if (parse_addr_size(line + 1 + strlen(name), &addr, &size)) {
+                add_section(m->hot, &m->n_hot, MAX_HOT, name + 15, addr, size, line);
+                m->hot_bytes += size;
+            } else {
+                snprintf(pending, sizeof(pending), "%s", name);
+                pending_hot = true;
+            }
+        }
+    }
+    fclose(f);
+
+    if (m->n_regions == 0) {
+        fprintf(stderr, "%s: no Memory Configuration (not a GNU ld map?)\n", path);
+        return -1;
+    }
+    // 地址 0 上的是调试信息段，不占存储；拷进 RAM 的段在 flash 里还有一份镜像
+    for (int i = 0; i < m->n_sections; ++i) {
+        const section_t *s = &m->sections[i];
+        region_t *r = region_of(m, s->addr);
+        if (s->size && r) {
+            r->used += s->size;
+            region_t *l = s->load ? region_of(m, s->load) : NULL;
+            if (l && l != r) {
+                l->used += s->size;
+            }
+        }
+    }
+    return 0;
+}
+
+static void report(const char *path, const map_t *m) {
+    printf("[MAP] %s\n", path);
+    for (int k = 0; k < m->n_regions; ++k) {
+        const region_t *r = &m->regions[k];
+        printf("[MAP] %-10s %8llu / %8llu bytes\n", r->name, (unsigned long long)r->used,
+               (unsigned long long)r->length);
+        for (int i = 0; i < m->n_sections; ++i) {
+            const section_t *s = &m->sections[i];
+            if (s->size && s->addr >= r->origin && s->addr < r->origin + r->length) {
+                printf("        %-20s 0x%08llx %8llu\n", s->name, (unsigned long long)s->addr,
+                       (unsigned long long)s->size);
+            } else if (s->size && s->load >= r->origin && s->load < r->origin + r->length) {
+                printf("        %-20s 0x%08llx %8llu  (load image)\n", s->name, (unsigned long long)s->load,
+                       (unsigned long long)s->size);
+            }
+        }
+    }
+    printf("[MAP] hot code (.time_critical.*): %d functions, %llu bytes\n", m->n_hot,
+           (unsigned long long)m->hot_bytes);
+    for (int i = 0; i < m->n_hot; ++i) {
+        printf("        %-36s %6llu\n", m->hot[i].name, (unsigned long long)m->hot[i].size);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <map> [other map]\n", argv[0]);
+        return 2;
+    }
+
+    static map_t a, b;
+    if (load(argv[1], &a) != 0) {
+        return 2;
+    }
+    report(argv[1], &a);
+    if (argc < 3) {
+        return 0;
+    }
+
+    if (load(argv[2], &b) != 0) {
+        return 2;
+    }
+    report(argv[2], &b);
+    printf("[MAP] diff (second - first)\n");
+    for (int k = 0; k < b.n_regions; ++k) {
+        const region_t *r = &b.regions[k];
+        int64_t used_a = 0;
+        for (int j = 0; j < a.n_regions; ++j) {
+            if (strcmp(a.regions[j].name, r->name) == 0) {
+                used_a = (int64_t)a.regions[j].used;
+            }
+        }
+        printf("[MAP] %-10s %+8lld bytes\n", r->name, (long long)((int64_t)r->used - used_a));
+    }
+    printf("[MAP] hot code   %+8lld bytes\n", (long long)((int64_t)b.hot_bytes - (int64_t)a.hot_bytes));
+    return 0;
+}
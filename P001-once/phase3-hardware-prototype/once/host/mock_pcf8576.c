@@ -0,0 +1,204 @@
+// mock_pcf8576.c
+// 只实现固件用到的那部分协议：START / 地址 / 命令字（C 位串联）/ 数据 / STOP，
+// 静态驱动模式下每个数据字节占 8 个显存地址，数据指针自增 8。
+
+#include "mock_pcf8576.h"
+#include "sim.h"
+
+#include <string.h>
+
+#define MOCK_RAM_BITS   40
+#define MOCK_DIGITS     4
+
+// 和 lcd_pcf8576.c 的 LCD_Digit 一致；最低位是小数点 / 冒号，比对时去掉
+static const uint8_t MOCK_FONT[11] = {
+    0x7e, 0x12, 0xbc, 0xb6, 0xd2, 0xe6, 0xee, 0x32, 0xfe, 0xf6, 0x80
+};
+static const char MOCK_FONT_CHARS[11] = "0123456789-";
+
+typedef enum {
+    BUS_IDLE = 0,
+    BUS_ADDR,       // 等地址字节
+    BUS_CMD,        // 命令字
+    BUS_DATA,       // 显存数据
+    BUS_IGNORE,     // 不是发给本器件的，等 STOP
+} mock_bus_state_t;
+
+static uint    mock_sda, mock_scl;
+static uint8_t mock_addr;
+
+static mock_bus_state_t bus_state = BUS_IDLE;
+static uint8_t          bus_byte  = 0;
+static int              bus_bits  = 0;     // 当前字节已收到的位数；8 = 正在 ACK
+static bool             bus_ack   = false; // 本字节要不要应答
+static bool             bit_latched = false;
+static bool             bit_pending = false;
+static bool             sda_level = true;
+static bool             scl_level = true;
+
+static uint8_t mock_ram[MOCK_RAM_BITS];
+static uint8_t mock_ptr     = 0;
+static uint8_t mock_mode    = 0;     // 最近一次模式设置命令
+static char    mock_text[16];
+static mock_pcf8576_stats_t mock_stats;
+
+static void mock_byte_done(uint8_t b) {
+    mock_stats.bytes++;
+
+    switch (bus_state) {
+    case BUS_ADDR:
+        if (b == mock_addr) {
+            bus_state = BUS_CMD;
+            bus_ack   = true;
+        } else {
+            bus_state = BUS_IGNORE;
+            bus_ack   = false;
+            mock_stats.nacks++;
+        }
+        break;
+    case BUS_CMD:
+        if ((b & 0x40) == 0) {
+            mock_ptr = b & 0x3f;               // 装载数据指针
+        } else if ((b & 0x60) == 0x40) {
+            mock_mode = b;                     // 模式设置
+        }
+        // 器件选择 / 显存 bank / 闪烁命令这里用不到，收下就行
+        if ((b & 0x80) == 0) {
+            bus_state = BUS_DATA;              // C = 0：后面全是数据
+        }
+        bus_ack = true;
+        break;
+    case BUS_DATA:
+        for (int i = 0; i < 8; ++i) {
+            mock_ram[(mock_ptr + i) % MOCK_RAM_BITS] = (uint8_t)((b >> (7 - i)) & 1u);
+        }
+        mock_ptr = (uint8_t)((mock_ptr + 8) % MOCK_RAM_BITS);
+        bus_ack = true;
+        break;
+    default:
+        bus_ack = false;
+        break;
+    }
+}
+
+static void mock_on_pin(uint pin, bool level) {
+    if (pin == mock_sda) {
+        bool was = sda_level;
+        sda_level = level;
+        if (!scl_level) {
+            return;                            // SCL 低时 SDA 变化是正常的数据准备
+        }
+        bit_pending = false;                   // SCL 高时 SDA 变了：不是数据位，是 START / STOP
+        if (was && !level) {                   // START（含重复 START）
+            if (bus_state != BUS_IDLE && bus_bits != 0) {
+                mock_stats.bad_frames++;
+            }
+            bus_state = BUS_ADDR;
+            bus_bits  = 0;
+            bus_byte  = 0;
+        } else if (!was && level) {            // STOP
+            if (bus_state == BUS_CMD || bus_state == BUS_DATA) {
+                if (bus_bits == 0) {
+                    mock_stats.frames++;
+                } else {
+                    mock_stats.bad_frames++;
+                }
+            }
+            bus_state = BUS_IDLE;
+            bus_bits  = 0;
+        }
+        return;
+    }
+    if (pin != mock_scl) {
+        return;
+    }
+
+    scl_level = level;
+    if (bus_state == BUS_IDLE) {
+        return;
+    }
+
+    if (level) {
+        // 上升沿先锁存；要等下降沿才算数，因为 STOP 前面也有一个 SCL 上升沿
+        bit_latched = sda_level;
+        bit_pending = true;
+        return;
+    }
+    if (!bit_pending) {
+        return;
+    }
+    bit_pending = false;
+
+    if (bus_bits < 8) {
+        bus_byte = (uint8_t)((bus_byte << 1) | (bit_latched ? 1u : 0u));
+        if (++bus_bits == 8) {
+            mock_byte_done(bus_byte);
+            if (bus_ack) {
+                sim_pin_drive(mock_sda, false);   // 第 9 个时钟期间拉低 SDA 应答
+            }
+        }
+    } else {
+        // ACK 时钟结束，放开 SDA
+        sim_pin_release(mock_sda);
+        bus_bits = 0;
+        bus_byte = 0;
+    }
+}
+
+void mock_pcf8576_attach(uint sda, uint scl, uint8_t addr8) {
+    mock_sda  = sda;
+    mock_scl  = scl;
+    mock_addr = addr8;
+    sda_level = sim_pin_level(sda);
+    scl_level = sim_pin_level(scl);
+    memset(mock_ram, 0, sizeof(mock_ram));
+    sim_set_pin_watch(mock_on_pin);
+}
+
+uint8_t mock_pcf8576_digit_raw(int idx) {
+    uint8_t b = 0;
+    for (int i = 0; i < 8; ++i) {
+        b = (uint8_t)((b << 1) | mock_ram[(idx * 8 + i) % MOCK_RAM_BITS]);
+    }
+    return b;
+}
+
+static char mock_glyph(uint8_t raw) {
+    uint8_t seg = raw & 0xfe;
+    if (seg == 0) {
+        return ' ';
+    }
+    for (int i = 0; i < 11; ++i) {
+        if (MOCK_FONT[i] == seg) {
+            return MOCK_FONT_CHARS[i];
+        }
+    }
+    return '?';
+}
+
+const char *mock_pcf8576_text(void) {
+    // 模式设置里 E 位（bit 3）为 0 表示显示关闭
+    if ((mock_mode & 0x08) == 0) {
+        strcpy(mock_text, "(off)");
+        return mock_text;
+    }
+
+    size_t n = 0;
+    for (int d = 0; d < MOCK_DIGITS; ++d) {
+        uint8_t raw = mock_pcf8576_digit_raw(d);
+        mock_text[n++] = mock_glyph(raw);
+        if (d < 3 && (raw & 0x01)) {
+            mock_text[n++] = '.';
+        }
+        if (d == 1) {
+            // 冒号的段挂在第 4 位的最低位上
+            mock_text[n++] = (mock_pcf8576_digit_raw(3) & 0x01) ? ':' : ' ';
+        }
+    }
+    mock_text[n] = '\0';
+    return mock_text;
+}
+
+void mock_pcf8576_get_stats(mock_pcf8576_stats_t *out) {
+    *out = mock_stats;
+}
@@ -0,0 +1,41 @@
+// mock_pcf8576.h
+// 仿真 PCF8576：盯着 SDA/SCL 两根仿真引脚解码位模拟出来的 I2C，
+// 按命令字维护 40 位显存，再按固件的段码表反解成屏上的字符
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t frames;      // 收到 STOP 的完整帧数（发给本器件的）
+    uint32_t bytes;       // 收到的字节数（含地址）
+    uint32_t nacks;       // 地址不是本器件、没有应答的帧数
+    uint32_t bad_frames;  // STOP 出现在字节中间之类的不完整帧
+} mock_pcf8576_stats_t;
+
+/**
+ * 接到 sda / scl 引脚上，addr8 是 8 位写地址（原例程的 0x70）。
+ */
+void mock_pcf8576_attach(uint sda, uint scl, uint8_t addr8);
+
+/**
+ * 屏上当前内容，例如 "12:34"；冒号没亮时是 "12 34"，小数点跟在数字后面。
+ * 认不出的段组合显示 '?'，显示关闭时返回 "(off)"。
+ */
+const char *mock_pcf8576_text(void);
+
+// 第 idx 个数字位（0..3）显存里的原始段码
+uint8_t mock_pcf8576_digit_raw(int idx);
+
+void mock_pcf8576_get_stats(mock_pcf8576_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
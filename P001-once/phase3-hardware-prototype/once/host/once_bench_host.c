@@ -0,0 +1,19 @@
+// once_bench_host.c
+// 主机上跑 bench/once_bench.c：同一份内核，原生编译。
+// LCD 那几行量的是仿真里位模拟 I2C 的开销（引脚回调 + 仿真 PCF8576 解帧），
+// 不是真总线的时间；硬件 I2C / PIO 仿真里没有，报 unavailable。
+//
+// 用法：once_bench_host > new.txt; bench_compare base.txt new.txt
+
+#include "sim.h"
+#include "mock_pcf8576.h"
+#include "drivers/board.h"
+
+int once_bench_main(void);   // once_bench.c 的 main，主机构建时改了名
+
+#define LCD_ADDR_8BIT   0x70
+
+int main(void) {
+    mock_pcf8576_attach(LCD_SDA_PIN, LCD_SCL_PIN, LCD_ADDR_8BIT);
+    return once_bench_main();
+}
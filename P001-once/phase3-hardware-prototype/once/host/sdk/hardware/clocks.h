@@ -0,0 +1,37 @@
+// hardware/clocks.h（主机仿真版）
+// 只记每个时钟配成了多少 Hz（clock_get_hz 照实返回），没有真的分频器；
+// 源 / 辅助源的编号只用来分辨“挂在哪个 PLL 上”，值和真 SDK 的寄存器定义一致
+#pragma once
+
+#include "pico.h"
+
+#define KHZ 1000
+#define MHZ 1000000
+
+enum clock_index {
+    clk_gpout0 = 0,
+    clk_gpout1,
+    clk_gpout2,
+    clk_gpout3,
+    clk_ref,
+    clk_sys,
+    clk_peri,
+    clk_usb,
+    clk_adc,
+    clk_rtc,
+    CLK_COUNT
+};
+
+#define CLOCKS_CLK_REF_CTRL_SRC_VALUE_XOSC_CLKSRC          0x2u
+#define CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLK_REF              0x0u
+#define CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX   0x1u
+#define CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS    0x0u
+#define CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB    0x1u
+#define CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB   0x2u
+#define CLOCKS_CLK_USB_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB    0x0u
+#define CLOCKS_CLK_ADC_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB    0x0u
+#define CLOCKS_CLK_RTC_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB    0x0u
+
+bool clock_configure(enum clock_index clk_index, uint32_t src, uint32_t auxsrc, uint32_t src_freq, uint32_t freq);
+void clock_stop(enum clock_index clk_index);
+uint32_t clock_get_hz(enum clock_index clk_index);
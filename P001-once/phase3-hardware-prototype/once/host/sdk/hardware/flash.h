@@ -0,0 +1,21 @@
+// hardware/flash.h（主机仿真版）
+// 一块 2 MB 的仿真 NOR flash（host/sim_flash.c）：擦除置 0xff，编程只能把 1 写成 0，
+// 擦 / 写按典型时间推进虚拟时钟。XIP 读就是直接读这块数组。
+#pragma once
+
+#include "pico.h"
+
+#define FLASH_PAGE_SIZE         (1u << 8)
+#define FLASH_SECTOR_SIZE       (1u << 12)
+
+#ifndef PICO_FLASH_SIZE_BYTES
+#define PICO_FLASH_SIZE_BYTES   (2 * 1024 * 1024)
+#endif
+
+extern uint8_t sim_flash[PICO_FLASH_SIZE_BYTES];
+
+#define XIP_BASE                ((uintptr_t)sim_flash)
+
+// 偏移、长度必须按扇区 / 页对齐，否则直接 abort（真 SDK 里是 invalid_params_if）
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
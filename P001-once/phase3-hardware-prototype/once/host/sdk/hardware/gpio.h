@@ -0,0 +1,47 @@
+// hardware/gpio.h（主机仿真版）
+// 引脚电平 = 输出时取输出值；输入时取外部驱动（编码器 / 仿真 LCD 的 ACK），没人驱动就看上下拉
+#pragma once
+
+#include "pico.h"
+
+#define NUM_BANK0_GPIOS  30
+
+enum gpio_dir {
+    GPIO_IN  = 0,
+    GPIO_OUT = 1,
+};
+
+// 仿真里只分 SIO（按 gpio_put / 方向算电平）和 PWM（见 hardware/pwm.h），其余功能当 SIO
+enum gpio_function {
+    GPIO_FUNC_I2C  = 3,
+    GPIO_FUNC_PWM  = 4,
+    GPIO_FUNC_SIO  = 5,
+    GPIO_FUNC_PIO0 = 6,
+    GPIO_FUNC_NULL = 0x1f,
+};
+
+enum gpio_irq_level {
+    GPIO_IRQ_LEVEL_LOW  = 0x1u,
+    GPIO_IRQ_LEVEL_HIGH = 0x2u,
+    GPIO_IRQ_EDGE_FALL  = 0x4u,
+    GPIO_IRQ_EDGE_RISE  = 0x8u,
+};
+
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+
+void gpio_init(uint gpio);
+void gpio_set_function(uint gpio, enum gpio_function fn);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_put(uint gpio, bool value);
+bool gpio_get(uint gpio);
+void gpio_pull_up(uint gpio);
+void gpio_pull_down(uint gpio);
+void gpio_disable_pulls(uint gpio);
+
+// 只支持边沿中断；回调在虚拟时钟的“中断上下文”里执行
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled);
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback);
+
+// DORMANT 唤醒：只认边沿；芯片睡着时普通 GPIO 中断不锁存边沿（没有 clk_sys），醒来以后也补不上
+void gpio_set_dormant_irq_enabled(uint gpio, uint32_t event_mask, bool enabled);
+void gpio_acknowledge_irq(uint gpio, uint32_t event_mask);
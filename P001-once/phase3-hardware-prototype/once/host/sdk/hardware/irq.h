@@ -0,0 +1,12 @@
+// hardware/irq.h（主机仿真版）
+// 只有 PWM 回绕中断是真派发的（见 sim.c），别的外设中断号仿真里用不到
+#pragma once
+
+#include "pico.h"
+
+#define PWM_IRQ_WRAP   4
+
+typedef void (*irq_handler_t)(void);
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+void irq_set_enabled(uint num, bool enabled);
@@ -0,0 +1,15 @@
+// hardware/pll.h（主机仿真版）：只记开没开，锁定不花时间
+#pragma once
+
+#include "pico.h"
+
+typedef enum {
+    pll_sys = 0,
+    pll_usb = 1,
+} PLL;
+
+void pll_init(PLL pll, uint ref_div, uint vco_freq, uint post_div1, uint post_div2);
+void pll_deinit(PLL pll);
+
+// 仿真统计用：这个 PLL 现在开着吗
+bool sim_pll_running(PLL pll);
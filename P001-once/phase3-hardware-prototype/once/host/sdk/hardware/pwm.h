@@ -0,0 +1,54 @@
+// hardware/pwm.h（主机仿真版）
+// 每个 slice 记计数上限、分频、比较值、极性和回绕中断使能。不逐个周期翻引脚：
+// 引脚电平看比较值是不是 0（再按极性反相），占空比由 sim_pin_duty() 报；
+// 开了回绕中断的 slice 才按 (TOP + 1) * 分频 / clk_sys 排回绕事件
+#pragma once
+
+#include "pico.h"
+
+#define NUM_PWM_SLICES  8
+
+enum pwm_chan {
+    PWM_CHAN_A = 0,
+    PWM_CHAN_B = 1,
+};
+
+typedef struct {
+    uint32_t csr;   // 只用到两个反相位
+    uint32_t div;   // 8.4 定点
+    uint32_t top;
+} pwm_config;
+
+#define PWM_CH0_CSR_A_INV_BITS  0x4u
+#define PWM_CH0_CSR_B_INV_BITS  0x8u
+
+static inline uint pwm_gpio_to_slice_num(uint gpio) {
+    return (gpio >> 1u) & 7u;
+}
+
+static inline uint pwm_gpio_to_channel(uint gpio) {
+    return gpio & 1u;
+}
+
+static inline pwm_config pwm_get_default_config(void) {
+    pwm_config c = { 0, 1u << 4, 0xffffu };
+    return c;
+}
+
+static inline void pwm_config_set_wrap(pwm_config *c, uint16_t wrap) {
+    c->top = wrap;
+}
+
+static inline void pwm_config_set_clkdiv_int(pwm_config *c, uint div) {
+    c->div = div << 4;
+}
+
+static inline void pwm_config_set_output_polarity(pwm_config *c, bool a, bool b) {
+    c->csr = (a ? PWM_CH0_CSR_A_INV_BITS : 0u) | (b ? PWM_CH0_CSR_B_INV_BITS : 0u);
+}
+
+void pwm_init(uint slice_num, pwm_config *c, bool start);
+void pwm_set_enabled(uint slice_num, bool enabled);
+void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level);
+void pwm_set_irq_enabled(uint slice_num, bool enabled);
+void pwm_clear_irq(uint slice_num);
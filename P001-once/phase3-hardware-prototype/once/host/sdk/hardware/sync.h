@@ -0,0 +1,20 @@
+// hardware/sync.h（主机仿真版）
+// 单线程仿真：关中断只是让虚拟时钟暂缓派发回调；WFE 直接把时钟拨到下一个事件
+#pragma once
+
+#include "pico.h"
+
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+static inline void __dmb(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __dsb(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void __sev(void);
+void __wfe(void);
+void __wfi(void);
@@ -0,0 +1,10 @@
+// hardware/timer.h（主机仿真版）：读的是虚拟时钟
+#pragma once
+
+#include "pico.h"
+
+uint64_t time_us_64(void);
+
+static inline uint32_t time_us_32(void) {
+    return (uint32_t)time_us_64();
+}
@@ -0,0 +1,9 @@
+// hardware/xosc.h（主机仿真版）
+// xosc_dormant()：停在这里，alarm 全部冻住（真片子上 timer 也跟着晶振停了），只有场景脚本的外部
+// 动作照常推进；使能了 dormant 唤醒的引脚一有边沿就再等一段晶振起振时间，然后返回
+#pragma once
+
+#include "pico.h"
+
+void xosc_init(void);
+void xosc_dormant(void);
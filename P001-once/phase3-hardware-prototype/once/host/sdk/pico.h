@@ -0,0 +1,32 @@
+// pico.h（主机仿真版）
+// host/sdk 下是 Pico SDK 里固件实际用到的那一小块接口，主机构建时顶替真 SDK：
+// 时间、alarm、GPIO、关中断 / WFE 全部接到 host/sim.c 的虚拟时钟和仿真引脚上。
+// 固件源码一行不改，换掉的只是这层。
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+#define PICO_OK                 0
+#define PICO_ERROR_GENERIC     -1
+#define PICO_ERROR_TIMEOUT     -2
+
+// 主机上没有 SRAM / Flash 之分
+#define __not_in_flash_func(func_name) func_name
+#define __time_critical_func(func_name) func_name
+
+// 板子定义（真 SDK 里是 boards/pico.h）：VBUS 经分压接到 GPIO24，插着 USB 线读 1
+#define PICO_VBUS_PIN           24
+
+// 忙等循环里调用：虚拟时钟往前走 1 us，顺带派发到点的中断
+void tight_loop_contents(void);
+
+// 仿真只有一个核；正在派发 alarm / GPIO 回调时返回非 0，相当于处在中断里
+static inline uint get_core_num(void) {
+    return 0;
+}
+
+uint __get_current_exception(void);
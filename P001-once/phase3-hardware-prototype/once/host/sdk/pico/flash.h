@@ -0,0 +1,6 @@
+// pico/flash.h（主机仿真版）：只有一个核，关中断跑完 func 就返回
+#pragma once
+
+#include "pico.h"
+
+int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms);
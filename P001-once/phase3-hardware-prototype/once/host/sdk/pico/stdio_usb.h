@@ -0,0 +1,7 @@
+// pico/stdio_usb.h（主机仿真版）
+// stdio_usb_connected()：串口终端开着（DTR），由场景脚本的 usb 动作决定（见 sim.h）
+#pragma once
+
+#include "pico.h"
+
+bool stdio_usb_connected(void);
@@ -0,0 +1,13 @@
+// pico/stdlib.h（主机仿真版）
+#pragma once
+
+#include "pico.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+
+// printf 直接走主机 stdout
+bool stdio_init_all(void);
+
+// 串口输入来自场景脚本的 send 动作，没有就返回 PICO_ERROR_TIMEOUT（不会真的等）
+int getchar_timeout_us(uint32_t timeout_us);
@@ -0,0 +1,7 @@
+// tusb.h（主机仿真版）
+// 只有 tud_mounted()：主机枚举了这个设备就是 true，由场景脚本的 usb 动作决定（见 sim.h）
+#pragma once
+
+#include "pico.h"
+
+bool tud_mounted(void);
@@ -0,0 +1,772 @@
+// sim.c
+// 主机仿真内核 + host/sdk 里声明的 SDK 接口实现。
+// 整个仿真是单线程的：“中断”就是虚拟时钟走到点时直接调回调，
+// 固件一 WFE / sleep，时钟就跳到下一个事件，所以几小时的计时几毫秒就能跑完。
+
+#include "sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "hardware/clocks.h"
+#include "hardware/pll.h"
+#include "hardware/xosc.h"
+#include "tusb.h"
+
+#define SIM_MAX_ALARMS  16
+
+// DORMANT 醒来时晶振的起振时间（SDK 默认的 startup delay，约 1 ms）
+#define SIM_XOSC_STARTUP_US  1000
+
+static uint64_t sim_now        = 0;
+static uint32_t sim_irq_off    = 0;      // save_and_disable_interrupts 嵌套层数
+static bool     sim_event_flag = false;  // WFE 的事件寄存器
+static uint32_t sim_in_irq     = 0;      // 正在派发的“中断”回调层数
+static bool     sim_dormant    = false;  // xosc_dormant() 里：alarm 冻住，普通 GPIO 中断不锁存
+static bool     sim_dormant_woken = false;
+static sim_stats_t sim_stats;
+
+static void sim_default_idle_forever(void) {
+    fprintf(stderr, "[SIM] t=%llu us: nothing left to wake the firmware, stopping\n",
+            (unsigned long long)sim_now);
+    exit(0);
+}
+
+static sim_pin_watch_fn sim_pin_watch = NULL;
+static void (*sim_idle_forever)(void) = sim_default_idle_forever;
+
+// ========== 外部事件：按 (时刻, 加入顺序) 排的小根堆 ==========
+
+typedef struct {
+    uint64_t      t_us;
+    uint64_t      seq;
+    sim_action_fn fn;
+    void         *ctx;
+} sim_action_t;
+
+static sim_action_t *act_heap  = NULL;
+static size_t        act_count = 0;
+static size_t        act_cap   = 0;
+static uint64_t      act_seq   = 0;
+
+static bool act_before(const sim_action_t *a, const sim_action_t *b) {
+    return (a->t_us != b->t_us) ? (a->t_us < b->t_us) : (a->seq < b->seq);
+}
+
+void sim_schedule(uint64_t t_us, sim_action_fn fn, void *ctx) {
+    if (act_count == act_cap) {
+        act_cap  = act_cap ? act_cap * 2 : 64;
+        act_heap = realloc(act_heap, act_cap * sizeof(*act_heap));
+        if (!act_heap) {
+            abort();
+        }
+    }
+    size_t i = act_count++;
+    act_heap[i] = (sim_action_t){ t_us, act_seq++, fn, ctx };
+    while (i > 0) {
+        size_t p = (i - 1) / 2;
+        if (!act_before(&act_heap[i], &act_heap[p])) {
+            break;
+        }
+        sim_action_t tmp = act_heap[i];
+        act_heap[i] = act_heap[p];
+        act_heap[p] = tmp;
+        i = p;
+    }
+}
+
+static sim_action_t act_pop(void) {
+    sim_action_t top = act_heap[0];
+    act_heap[0] = act_heap[--act_count];
+    size_t i = 0;
+    for (;;) {
+        size_t l = 2 * i + 1, r = l + 1, m = i;
+        if (l < act_count && act_before(&act_heap[l], &act_heap[m])) m = l;
+        if (r < act_count && act_before(&act_heap[r], &act_heap[m])) m = r;
+        if (m == i) {
+            break;
+        }
+        sim_action_t tmp = act_heap[i];
+        act_heap[i] = act_heap[m];
+        act_heap[m] = tmp;
+        i = m;
+    }
+    return top;
+}
+
+// ========== alarm：对应 SDK 的默认 alarm 池 ==========
+
+typedef struct {
+    bool             used;
+    alarm_id_t       id;
+    uint64_t         due_us;
+    alarm_callback_t cb;
+    void            *user_data;
+} sim_alarm_t;
+
+static sim_alarm_t sim_alarms[SIM_MAX_ALARMS];
+static alarm_id_t  sim_next_alarm_id = 1;
+
+static sim_alarm_t *alarm_next_due(void) {
+    sim_alarm_t *best = NULL;
+    for (int i = 0; i < SIM_MAX_ALARMS; ++i) {
+        sim_alarm_t *a = &sim_alarms[i];
+        if (a->used && (!best || a->due_us < best->due_us ||
+                        (a->due_us == best->due_us && a->id < best->id))) {
+            best = a;
+        }
+    }
+    return best;
+}
+
+static void alarm_fire(sim_alarm_t *a) {
+    alarm_id_t id  = a->id;
+    uint64_t   due = a->due_us;
+
+    sim_stats.alarms_fired++;
+    sim_event_flag = true;
+    sim_in_irq++;
+    int64_t ret = a->cb(id, a->user_data);
+    sim_in_irq--;
+
+    // 回调里可能把自己取消了
+    if (!a->used || a->id != id) {
+        return;
+    }
+    if (ret < 0) {
+        a->due_us = due + (uint64_t)(-ret);
+    } else if (ret > 0) {
+        a->due_us = sim_now + (uint64_t)ret;
+    } else {
+        a->used = false;
+    }
+}
+
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    uint64_t t = to_us_since_boot(time);
+    if (t <= sim_now && !fire_if_past) {
+        return 0;
+    }
+    for (int i = 0; i < SIM_MAX_ALARMS; ++i) {
+        sim_alarm_t *a = &sim_alarms[i];
+        if (!a->used) {
+            *a = (sim_alarm_t){ true, sim_next_alarm_id++, t, callback, user_data };
+            return a->id;
+        }
+    }
+    return -1;   // 和 SDK 一样：池满返回负数
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return add_alarm_at(sim_now + us, callback, user_data, fire_if_past);
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return add_alarm_at(sim_now + (uint64_t)ms * 1000u, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t alarm_id) {
+    for (int i = 0; i < SIM_MAX_ALARMS; ++i) {
+        if (sim_alarms[i].used && sim_alarms[i].id == alarm_id) {
+            sim_alarms[i].used = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int64_t repeating_timer_trampoline(alarm_id_t id, void *user_data) {
+    (void)id;
+    repeating_timer_t *rt = (repeating_timer_t *)user_data;
+    if (!rt->callback(rt)) {
+        return 0;
+    }
+    // 和 SDK 一样按回调返回后的 delay_us 排下一次（回调里可以改周期）；
+    // 仿真里回调不耗时，“两次开始之间”和“上次结束到下次开始”是一回事
+    int64_t period = rt->delay_us < 0 ? -rt->delay_us : rt->delay_us;
+    return -(period ? period : 1);
+}
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out) {
+    int64_t period = delay_us < 0 ? -delay_us : delay_us;
+    if (period == 0) {
+        period = 1;
+    }
+    out->delay_us  = delay_us;
+    out->callback  = callback;
+    out->user_data = user_data;
+    out->alarm_id  = add_alarm_at(sim_now + (uint64_t)period, repeating_timer_trampoline, out, true);
+    return out->alarm_id > 0;
+}
+
+bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out) {
+    return add_repeating_timer_us((int64_t)delay_ms * 1000, callback, user_data, out);
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer) {
+    bool ok = (timer->alarm_id > 0) && cancel_alarm(timer->alarm_id);
+    timer->alarm_id = 0;
+    return ok;
+}
+
+// ========== 仿真引脚 ==========
+
+typedef struct {
+    uint8_t  func;         // GPIO_FUNC_PWM 时电平由 PWM 决定，其余按 SIO 算
+    bool     out;          // 方向
+    bool     out_value;    // 输出寄存器
+    bool     ext_on;       // 有外部驱动
+    bool     ext_level;
+    bool     pull_up;      // 都不拉时浮空，读成 0
+    bool     pull_down;
+    bool     level;        // 当前电平
+    uint32_t irq_mask;     // 使能的边沿中断
+    uint32_t irq_pending;  // 关中断期间攒下的边沿
+    uint32_t dormant_mask; // 使能的 DORMANT 唤醒边沿
+} sim_pin_t;
+
+static sim_pin_t           sim_pins[NUM_BANK0_GPIOS];
+static gpio_irq_callback_t sim_gpio_cb = NULL;
+
+static void pin_dispatch_irqs(void);
+static bool pwm_pin_level(uint pin);
+
+static void pin_update(uint pin) {
+    sim_pin_t *p = &sim_pins[pin];
+    bool level;
+    if (p->func == GPIO_FUNC_PWM) {
+        level = pwm_pin_level(pin);
+    } else if (p->out) {
+        level = p->out_value;
+    } else if (p->ext_on) {
+        level = p->ext_level;
+    } else {
+        level = p->pull_up;
+    }
+    if (level == p->level) {
+        return;
+    }
+    p->level = level;
+
+    uint32_t edge = level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+    if (sim_dormant) {
+        if (p->dormant_mask & edge) {
+            sim_dormant_woken = true;
+        }
+    } else if (p->irq_mask & edge) {
+        p->irq_pending |= edge;
+    }
+    if (sim_pin_watch) {
+        sim_pin_watch(pin, level);
+    }
+    pin_dispatch_irqs();
+}
+
+static void pin_dispatch_irqs(void) {
+    if (sim_irq_off || !sim_gpio_cb) {
+        return;
+    }
+    for (uint i = 0; i < NUM_BANK0_GPIOS; ++i) {
+        uint32_t ev = sim_pins[i].irq_pending;
+        if (ev) {
+            sim_pins[i].irq_pending = 0;
+            sim_stats.gpio_irqs++;
+            sim_event_flag = true;
+            sim_in_irq++;
+            sim_gpio_cb(i, ev);
+            sim_in_irq--;
+        }
+    }
+}
+
+void sim_pin_drive(uint pin, bool level) {
+    sim_pins[pin].ext_on    = true;
+    sim_pins[pin].ext_level = level;
+    pin_update(pin);
+}
+
+void sim_pin_release(uint pin) {
+    sim_pins[pin].ext_on = false;
+    pin_update(pin);
+}
+
+bool sim_pin_level(uint pin) {
+    return sim_pins[pin].level;
+}
+
+void sim_set_pin_watch(sim_pin_watch_fn fn) {
+    sim_pin_watch = fn;
+}
+
+void gpio_init(uint gpio) {
+    sim_pin_t *p = &sim_pins[gpio];
+    p->func      = GPIO_FUNC_SIO;
+    p->out       = false;
+    p->out_value = false;
+    p->irq_mask  = 0;
+    pin_update(gpio);
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    sim_pins[gpio].func = (uint8_t)fn;
+    pin_update(gpio);
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    sim_pins[gpio].out = out;
+    pin_update(gpio);
+}
+
+void gpio_put(uint gpio, bool value) {
+    sim_pins[gpio].out_value = value;
+    pin_update(gpio);
+}
+
+bool gpio_get(uint gpio) {
+    return sim_pins[gpio].level;
+}
+
+void gpio_pull_up(uint gpio) {
+    sim_pins[gpio].pull_up   = true;
+    sim_pins[gpio].pull_down = false;
+    pin_update(gpio);
+}
+
+void gpio_pull_down(uint gpio) {
+    sim_pins[gpio].pull_up   = false;
+    sim_pins[gpio].pull_down = true;
+    pin_update(gpio);
+}
+
+void gpio_disable_pulls(uint gpio) {
+    sim_pins[gpio].pull_up   = false;
+    sim_pins[gpio].pull_down = false;
+    pin_update(gpio);
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled) {
+    event_mask &= GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE;
+    if (enabled) {
+        sim_pins[gpio].irq_mask |= event_mask;
+    } else {
+        sim_pins[gpio].irq_mask    &= ~event_mask;
+        sim_pins[gpio].irq_pending &= ~event_mask;
+    }
+}
+
+void gpio_set_dormant_irq_enabled(uint gpio, uint32_t event_mask, bool enabled) {
+    event_mask &= GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE;
+    if (enabled) {
+        sim_pins[gpio].dormant_mask |= event_mask;
+    } else {
+        sim_pins[gpio].dormant_mask &= ~event_mask;
+    }
+}
+
+void gpio_acknowledge_irq(uint gpio, uint32_t event_mask) {
+    sim_pins[gpio].irq_pending &= ~event_mask;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback) {
+    sim_gpio_cb = callback;
+    gpio_set_irq_enabled(gpio, event_mask, enabled);
+}
+
+// ========== PWM ==========
+// 不逐个周期翻引脚：比较值非 0 就算“高”（再按极性反相），占空比另外报。
+// 回绕事件只给开了回绕中断的 slice 排，和 alarm 一样关中断时等着；DORMANT 里 clk_sys 停，也不来
+
+typedef struct {
+    bool     en;
+    bool     irq_en;
+    uint32_t csr;
+    uint32_t div;          // 8.4 定点
+    uint32_t top;
+    uint16_t cc[2];
+    uint64_t next_wrap_us;
+} sim_pwm_t;
+
+static sim_pwm_t     sim_pwm[NUM_PWM_SLICES];
+static irq_handler_t sim_pwm_handler = NULL;
+static bool          sim_pwm_irq_on  = false;
+
+static uint64_t pwm_period_us(const sim_pwm_t *s) {
+    uint64_t hz = clock_get_hz(clk_sys);
+    if (hz == 0) {
+        return UINT64_MAX / 2;
+    }
+    uint64_t us = ((uint64_t)s->top + 1u) * s->div * 1000000u / 16u / hz;
+    return us ? us : 1;
+}
+
+static bool pwm_pin_level(uint pin) {
+    const sim_pwm_t *s = &sim_pwm[pwm_gpio_to_slice_num(pin)];
+    uint ch  = pwm_gpio_to_channel(pin);
+    bool inv = (s->csr & (ch ? PWM_CH0_CSR_B_INV_BITS : PWM_CH0_CSR_A_INV_BITS)) != 0;
+    return (s->en && s->cc[ch] > 0) != inv;
+}
+
+static void pwm_update_pins(uint slice_num) {
+    for (uint i = 0; i < NUM_BANK0_GPIOS; ++i) {
+        if (sim_pins[i].func == GPIO_FUNC_PWM && pwm_gpio_to_slice_num(i) == slice_num) {
+            pin_update(i);
+        }
+    }
+}
+
+static sim_pwm_t *pwm_next_wrap(void) {
+    if (!sim_pwm_irq_on || !sim_pwm_handler) {
+        return NULL;
+    }
+    sim_pwm_t *best = NULL;
+    for (uint i = 0; i < NUM_PWM_SLICES; ++i) {
+        sim_pwm_t *s = &sim_pwm[i];
+        if (s->en && s->irq_en && (!best || s->next_wrap_us < best->next_wrap_us)) {
+            best = s;
+        }
+    }
+    return best;
+}
+
+static void pwm_fire(sim_pwm_t *s) {
+    s->next_wrap_us += pwm_period_us(s);
+    if (s->next_wrap_us <= sim_now) {
+        s->next_wrap_us = sim_now + pwm_period_us(s);   // 关中断太久，错过的回绕只算一次
+    }
+    sim_stats.pwm_irqs++;
+    sim_event_flag = true;
+    sim_in_irq++;
+    sim_pwm_handler();
+    sim_in_irq--;
+}
+
+void pwm_init(uint slice_num, pwm_config *c, bool start) {
+    sim_pwm_t *s = &sim_pwm[slice_num];
+    s->csr   = c->csr;
+    s->div   = c->div;
+    s->top   = c->top;
+    s->cc[0] = 0;
+    s->cc[1] = 0;
+    pwm_set_enabled(slice_num, start);
+}
+
+void pwm_set_enabled(uint slice_num, bool enabled) {
+    sim_pwm_t *s = &sim_pwm[slice_num];
+    s->en = enabled;
+    s->next_wrap_us = sim_now + pwm_period_us(s);
+    pwm_update_pins(slice_num);
+}
+
+void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level) {
+    sim_pwm[slice_num].cc[chan] = level;
+    pwm_update_pins(slice_num);
+}
+
+void pwm_set_irq_enabled(uint slice_num, bool enabled) {
+    sim_pwm_t *s = &sim_pwm[slice_num];
+    if (enabled && !s->irq_en && s->next_wrap_us <= sim_now) {
+        s->next_wrap_us = sim_now + pwm_period_us(s);
+    }
+    s->irq_en = enabled;
+}
+
+void pwm_clear_irq(uint slice_num) {
+    (void)slice_num;
+}
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    if (num == PWM_IRQ_WRAP) {
+        sim_pwm_handler = handler;
+    }
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    if (num == PWM_IRQ_WRAP) {
+        sim_pwm_irq_on = enabled;
+    }
+}
+
+uint32_t sim_pin_duty(uint pin) {
+    const sim_pin_t *p = &sim_pins[pin];
+    const sim_pwm_t *s = &sim_pwm[pwm_gpio_to_slice_num(pin)];
+    if (p->func != GPIO_FUNC_PWM || !s->en) {
+        return p->level ? 1000u : 0u;
+    }
+    uint ch  = pwm_gpio_to_channel(pin);
+    bool inv = (s->csr & (ch ? PWM_CH0_CSR_B_INV_BITS : PWM_CH0_CSR_A_INV_BITS)) != 0;
+    uint32_t cc   = s->cc[ch] > s->top + 1u ? s->top + 1u : s->cc[ch];
+    uint32_t duty = (uint32_t)((uint64_t)cc * 1000u / (s->top + 1u));
+    return inv ? 1000u - duty : duty;
+}
+
+// ========== 时钟推进 ==========
+
+uint64_t sim_now_us(void) {
+    return sim_now;
+}
+
+uint64_t time_us_64(void) {
+    return sim_now;
+}
+
+bool sim_step(uint64_t limit_us) {
+    // 关中断期间 alarm / PWM 回绕只能等着，外部世界照常运转
+    sim_alarm_t *a = sim_irq_off ? NULL : alarm_next_due();
+    sim_pwm_t   *w = sim_irq_off ? NULL : pwm_next_wrap();
+    bool has_act = act_count > 0;
+
+    uint64_t t_act   = has_act ? act_heap[0].t_us : UINT64_MAX;
+    uint64_t t_alarm = a ? a->due_us : UINT64_MAX;
+    uint64_t t_wrap  = w ? w->next_wrap_us : UINT64_MAX;
+    uint64_t t = (t_act <= t_alarm) ? t_act : t_alarm;
+    if (t_wrap < t) {
+        t = t_wrap;
+    }
+
+    if ((!has_act && !a && !w) || t > limit_us) {
+        if (limit_us != UINT64_MAX && limit_us > sim_now) {
+            sim_now = limit_us;
+        }
+        return false;
+    }
+    if (t > sim_now) {
+        sim_now = t;
+    }
+
+    if (has_act && t_act <= t_alarm && t_act <= t_wrap) {
+        sim_action_t act = act_pop();
+        sim_stats.actions++;
+        act.fn(act.ctx);
+    } else if (a && t_alarm <= t_wrap) {
+        alarm_fire(a);
+    } else {
+        pwm_fire(w);
+    }
+    return true;
+}
+
+void sim_run_until(uint64_t t_us) {
+    while (sim_step(t_us)) {
+    }
+}
+
+void sleep_us(uint64_t us) {
+    sim_run_until(sim_now + us);
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_us((uint64_t)ms * 1000u);
+}
+
+void sleep_until(absolute_time_t t) {
+    sim_run_until(to_us_since_boot(t));
+}
+
+void tight_loop_contents(void) {
+    sim_run_until(sim_now + 1);
+}
+
+// ========== 中断屏蔽 / WFE ==========
+
+uint32_t save_and_disable_interrupts(void) {
+    return sim_irq_off++;
+}
+
+void restore_interrupts(uint32_t status) {
+    sim_irq_off = status;
+    if (sim_irq_off == 0) {
+        // 屏蔽期间到点的 alarm 由下一次推进补上；攒下的 GPIO 边沿现在就派发
+        pin_dispatch_irqs();
+    }
+}
+
+uint __get_current_exception(void) {
+    return sim_in_irq ? 16u : 0u;   // 随便给一个外设中断号
+}
+
+void __sev(void) {
+    sim_event_flag = true;
+}
+
+void __wfe(void) {
+    if (!sim_event_flag) {
+        sim_stats.wfe_sleeps++;
+        if (!sim_step(UINT64_MAX)) {
+            sim_idle_forever();
+        }
+    }
+    sim_event_flag = false;
+}
+
+void __wfi(void) {
+    __wfe();
+}
+
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp) {
+    uint64_t t = to_us_since_boot(timeout_timestamp);
+    if (!sim_event_flag && sim_now < t) {
+        sim_stats.wfe_sleeps++;
+        sim_step(t);
+    }
+    sim_event_flag = false;
+    return sim_now >= t;
+}
+
+void sim_set_idle_forever(void (*fn)(void)) {
+    sim_idle_forever = fn ? fn : sim_default_idle_forever;
+}
+
+// ========== 时钟 / PLL / 晶振 ==========
+
+static uint32_t sim_clk_hz[CLK_COUNT] = {
+    [clk_ref]  = 12000000u,
+    [clk_sys]  = 125000000u,
+    [clk_peri] = 125000000u,
+    [clk_usb]  = 48000000u,
+    [clk_adc]  = 48000000u,
+    [clk_rtc]  = 46875u,
+};
+static bool sim_pll_on[2] = { true, true };
+
+bool clock_configure(enum clock_index clk_index, uint32_t src, uint32_t auxsrc, uint32_t src_freq, uint32_t freq) {
+    (void)src;
+    (void)auxsrc;
+    if (freq > src_freq) {
+        return false;
+    }
+    sim_clk_hz[clk_index] = freq;
+    return true;
+}
+
+void clock_stop(enum clock_index clk_index) {
+    sim_clk_hz[clk_index] = 0;
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index) {
+    return sim_clk_hz[clk_index];
+}
+
+void pll_init(PLL pll, uint ref_div, uint vco_freq, uint post_div1, uint post_div2) {
+    (void)ref_div;
+    (void)vco_freq;
+    (void)post_div1;
+    (void)post_div2;
+    sim_pll_on[pll] = true;
+}
+
+void pll_deinit(PLL pll) {
+    sim_pll_on[pll] = false;
+}
+
+bool sim_pll_running(PLL pll) {
+    return sim_pll_on[pll];
+}
+
+void xosc_init(void) {
+}
+
+// 只推进外部动作，alarm 不动；没有动作了就当永远醒不来
+static void dormant_run_actions(uint64_t until_us) {
+    while (act_count > 0 && act_heap[0].t_us <= until_us) {
+        sim_action_t act = act_pop();
+        if (act.t_us > sim_now) {
+            sim_now = act.t_us;
+        }
+        sim_stats.actions++;
+        act.fn(act.ctx);
+    }
+    if (until_us != UINT64_MAX && until_us > sim_now) {
+        sim_now = until_us;
+    }
+}
+
+void xosc_dormant(void) {
+    uint64_t t0 = sim_now;
+    sim_stats.dormant_sleeps++;
+    sim_dormant       = true;
+    sim_dormant_woken = false;
+
+    while (!sim_dormant_woken) {
+        if (act_count == 0) {
+            sim_idle_forever();
+            return;
+        }
+        dormant_run_actions(act_heap[0].t_us);
+    }
+    // 晶振起振期间芯片还睡着，外面的旋钮照样在转
+    dormant_run_actions(sim_now + SIM_XOSC_STARTUP_US);
+    sim_dormant = false;
+
+    // timer 跟着晶振停了这么久：所有 alarm 往后挪，醒来以后相对间隔不变
+    uint64_t frozen = sim_now - t0;
+    for (int i = 0; i < SIM_MAX_ALARMS; ++i) {
+        if (sim_alarms[i].used) {
+            sim_alarms[i].due_us += frozen;
+        }
+    }
+    for (uint i = 0; i < NUM_PWM_SLICES; ++i) {
+        sim_pwm[i].next_wrap_us += frozen;
+    }
+    sim_stats.dormant_us += frozen;
+}
+
+void sim_get_stats(sim_stats_t *out) {
+    *out = sim_stats;
+}
+
+bool stdio_init_all(void) {
+    return true;
+}
+
+// ========== USB ==========
+
+static sim_usb_t sim_usb = SIM_USB_OFF;
+
+void sim_usb_set(sim_usb_t state) {
+    sim_usb = state;
+    if (state == SIM_USB_OFF) {
+        sim_pin_release(PICO_VBUS_PIN);
+    } else {
+        sim_pin_drive(PICO_VBUS_PIN, true);
+    }
+    sim_event_flag = true;   // 真片子上插拔会来 USB 中断
+}
+
+bool tud_mounted(void) {
+    return sim_usb >= SIM_USB_MOUNTED;
+}
+
+bool stdio_usb_connected(void) {
+    return sim_usb >= SIM_USB_TERMINAL;
+}
+
+// ========== 串口输入 ==========
+
+static char     serial_buf[256];
+static uint32_t serial_head = 0, serial_tail = 0;
+
+void sim_serial_push(const char *text) {
+    for (; *text; ++text) {
+        if (serial_head - serial_tail < sizeof(serial_buf)) {
+            serial_buf[serial_head++ % sizeof(serial_buf)] = *text;
+        }
+    }
+    sim_event_flag = true;
+}
+
+int getchar_timeout_us(uint32_t timeout_us) {
+    (void)timeout_us;
+    if (serial_tail == serial_head) {
+        return PICO_ERROR_TIMEOUT;
+    }
+    return (unsigned char)serial_buf[serial_tail++ % sizeof(serial_buf)];
+}
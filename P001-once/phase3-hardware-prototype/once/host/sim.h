@@ -0,0 +1,80 @@
+// sim.h
+// 主机仿真内核：虚拟 us 时钟 + 事件队列 + 仿真引脚。
+// host/sdk 下的 SDK 接口都落到这里；场景脚本（sim_main.c）和仿真 LCD（mock_pcf8576.c）
+// 也通过这里往“外部世界”注入输入、观察输出。
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 外部事件（场景脚本的拧旋钮、按键、检查点）：到点时在“外部世界”执行，不受关中断影响
+typedef void (*sim_action_fn)(void *ctx);
+
+// 引脚电平变化时通知观察者（仿真 LCD 靠它解码位模拟出来的 I2C）
+typedef void (*sim_pin_watch_fn)(uint pin, bool level);
+
+uint64_t sim_now_us(void);
+
+/**
+ * 在绝对时刻 t_us 执行一次 fn(ctx)。同一时刻的外部事件按加入顺序、且先于 alarm 执行。
+ */
+void sim_schedule(uint64_t t_us, sim_action_fn fn, void *ctx);
+
+/**
+ * 往后推进到下一个事件（不超过 limit_us）并派发它。
+ * 返回 false 表示 limit_us 之前什么都没有，时钟直接停在 limit_us。
+ */
+bool sim_step(uint64_t limit_us);
+
+// 把时钟推进到 t_us，途中到点的事件全部派发
+void sim_run_until(uint64_t t_us);
+
+// 外部驱动引脚（例如编码器触点接地）；release 之后电平回到上下拉决定的值
+void sim_pin_drive(uint pin, bool level);
+void sim_pin_release(uint pin);
+bool sim_pin_level(uint pin);
+
+// 引脚在一个周期里为高的比例（千分比）：PWM 功能时按比较值 / (TOP + 1) 和极性算，其余就是 0 或 1000
+uint32_t sim_pin_duty(uint pin);
+
+void sim_set_pin_watch(sim_pin_watch_fn fn);
+
+// 往固件的串口输入里塞字符（相当于 USB CDC 收到数据，会叫醒 WFE）
+void sim_serial_push(const char *text);
+
+// USB 线：不插 / 只有 VBUS（充电器）/ 主机枚举了 / 再开着串口终端（DTR）。
+// VBUS 接在 PICO_VBUS_PIN 上，tud_mounted() 和 stdio_usb_connected() 按这个回答
+typedef enum {
+    SIM_USB_OFF = 0,
+    SIM_USB_VBUS,
+    SIM_USB_MOUNTED,
+    SIM_USB_TERMINAL,
+} sim_usb_t;
+
+void sim_usb_set(sim_usb_t state);
+
+// 队列里再也没有事件、固件却要 WFE 时调用（默认直接退出）
+void sim_set_idle_forever(void (*fn)(void));
+
+// 统计：派发了多少次回调 / 外部事件，WFE 睡了几次
+typedef struct {
+    uint64_t alarms_fired;
+    uint64_t gpio_irqs;
+    uint64_t pwm_irqs;         // PWM 回绕中断
+    uint64_t actions;
+    uint64_t wfe_sleeps;
+    uint64_t dormant_sleeps;   // 进了几次 xosc_dormant()
+    uint64_t dormant_us;       // 在里面待了多久（虚拟时间，alarm 冻住的那段）
+} sim_stats_t;
+
+void sim_get_stats(sim_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
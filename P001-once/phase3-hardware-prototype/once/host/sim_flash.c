@@ -0,0 +1,55 @@
+// sim_flash.c
+// 仿真 NOR flash：hardware/flash.h、pico/flash.h 的主机实现。
+// 擦一个扇区 / 写一页期间虚拟时钟照走、中断照样被挡住，
+// 固件量出来的关中断窗口和真板子上同一个量级。
+
+#include "sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+
+// W25Q16JV 手册上的典型值：扇区擦除 45 ms，页编程 0.4 ms
+#define SIM_FLASH_ERASE_US     45000
+#define SIM_FLASH_PROGRAM_US   400
+
+uint8_t sim_flash[PICO_FLASH_SIZE_BYTES];
+
+// 出厂是全 0xff
+__attribute__((constructor))
+static void sim_flash_blank(void) {
+    memset(sim_flash, 0xff, sizeof(sim_flash));
+}
+
+static void sim_flash_check(const char *what, uint32_t offs, size_t count, uint32_t align) {
+    if (offs % align || count % align || (uint64_t)offs + count > sizeof(sim_flash)) {
+        fprintf(stderr, "[SIM] %s: bad range offs=0x%x count=%zu\n", what, (unsigned)offs, count);
+        abort();
+    }
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    sim_flash_check("flash_range_erase", flash_offs, count, FLASH_SECTOR_SIZE);
+    memset(&sim_flash[flash_offs], 0xff, count);
+    sim_run_until(sim_now_us() + (uint64_t)(count / FLASH_SECTOR_SIZE) * SIM_FLASH_ERASE_US);
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    sim_flash_check("flash_range_program", flash_offs, count, FLASH_PAGE_SIZE);
+    for (size_t i = 0; i < count; ++i) {
+        sim_flash[flash_offs + i] &= data[i];
+    }
+    sim_run_until(sim_now_us() + (uint64_t)(count / FLASH_PAGE_SIZE) * SIM_FLASH_PROGRAM_US);
+}
+
+int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms) {
+    (void)enter_exit_timeout_ms;
+    uint32_t irq = save_and_disable_interrupts();
+    func(param);
+    restore_interrupts(irq);
+    return PICO_OK;
+}
@@ -0,0 +1,397 @@
+// sim_main.c
+// 主机仿真入口：读场景脚本，把拧旋钮 / 按键 / 检查点排进虚拟时钟，然后跑固件的 main()。
+//
+// 用法：once_host [场景文件]      （不给文件就读 stdin）
+//
+// 脚本每行一条：<时刻> <动作> [参数...]，# 开头是注释
+//   时刻：1500 / 1500ms / 1.5s / 2m / 1h，前面加 + 表示相对上一行
+//   cw <格数> [每格 ms]        顺时针拧（默认每格 30 ms）
+//   ccw <格数> [每格 ms]       逆时针拧
+//   press [按住 ms] [抖动次数]   按一下按键（默认 80 ms，不抖）；抖动次数 n 表示按下和松开时
+//                              各先来回弹 n 次（间隔 300 us）才稳定
+//   expect <文字>              检查屏上内容，例如 expect 01:00 / expect 0.0 3.5 / expect 1:30
+//   expect-bl on|off           检查背光（亮度不是 0 就算 on）
+//   expect-bl <低>..<高>       检查背光亮度，按 PWM 占空比的百分数，例如 expect-bl 60..75
+//   expect-pwm-irqs <最多>     检查从上一条 expect-pwm-irqs（或开机）到现在的 PWM 回绕中断次数
+//   expect-dormant <次数>      检查开机以来进了几次 DORMANT
+//   usb off|vbus|mounted|terminal  插拔 USB 线：不插 / 只有 VBUS / 主机枚举了 / 再开着串口终端（开机时是 off）
+//   show                       打印屏上内容
+//   send <文字>                往固件的串口输入里塞字符（例如 send p 打印计时统计）
+//   end                        结束仿真（没写就在最后一条之后 1 s 结束）
+//
+// 固件的 printf 照常走 stdout，仿真自己的输出走 stderr。
+// 有检查失败时退出码为 1，方便在 CI 里直接跑。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+
+#include "sim.h"
+#include "mock_pcf8576.h"
+#include "drivers/board.h"
+#include "drivers/lcd_pcf8576.h"
+
+int once_main(void);   // once.c 的 main，主机构建时改了名
+
+#define LCD_ADDR_8BIT   0x70
+
+typedef enum {
+    ACT_PIN = 0,
+    ACT_EXPECT,
+    ACT_EXPECT_BL,
+    ACT_EXPECT_PWM_IRQS,
+    ACT_EXPECT_DORMANT,
+    ACT_USB,
+    ACT_SHOW,
+    ACT_SEND,
+    ACT_END,
+} act_kind_t;
+
+typedef struct {
+    act_kind_t kind;
+    uint       pin;
+    bool       release;       // ACT_PIN：放开（回到上拉）还是拉低
+    uint16_t   bl_lo;         // ACT_EXPECT_BL：亮的占空比范围，千分比
+    uint16_t   bl_hi;
+    uint32_t   num;           // ACT_EXPECT_PWM_IRQS 的上限 / ACT_EXPECT_DORMANT 的次数 / ACT_USB 的 sim_usb_t
+    int        line;
+    char       text[72];      // ACT_EXPECT / ACT_SEND
+} act_t;
+
+static uint32_t checks   = 0;
+static uint32_t failures = 0;
+static uint64_t pwm_irqs_mark = 0;   // 上一条 expect-pwm-irqs 时的 pwm_irqs
+static struct timespec wall_t0;
+
+static double wall_ms(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)(t.tv_sec - wall_t0.tv_sec) * 1e3 + (double)(t.tv_nsec - wall_t0.tv_nsec) / 1e6;
+}
+
+static void sim_finish(void) {
+    fflush(stdout);
+
+    sim_stats_t ss;
+    mock_pcf8576_stats_t ms;
+    lcd_pcf8576_stats_t ls;
+    sim_get_stats(&ss);
+    mock_pcf8576_get_stats(&ms);
+    lcd_pcf8576_get_stats(&ls);
+
+    double sim_s = (double)sim_now_us() / 1e6;
+    double real  = wall_ms();
+    fprintf(stderr, "[SIM] simulated %.3f s in %.1f ms (x%.0f)\n",
+            sim_s, real, real > 0 ? sim_s * 1e3 / real : 0.0);
+    fprintf(stderr, "[SIM] alarms=%llu gpio_irqs=%llu pwm_irqs=%llu wfe=%llu dormant=%llu (%.3f s)\n",
+            (unsigned long long)ss.alarms_fired,
+            (unsigned long long)ss.gpio_irqs,
+            (unsigned long long)ss.pwm_irqs,
+            (unsigned long long)ss.wfe_sleeps,
+            (unsigned long long)ss.dormant_sleeps,
+            (double)ss.dormant_us / 1e6);
+    fprintf(stderr, "[SIM] lcd frames=%lu bytes=%lu nacks=%lu bad=%lu  driver sent=%lu/%lu B\n",
+            (unsigned long)ms.frames, (unsigned long)ms.bytes,
+            (unsigned long)ms.nacks, (unsigned long)ms.bad_frames,
+            (unsigned long)ls.bytes_sent, (unsigned long)ls.bytes_requested);
+    fprintf(stderr, "[SIM] checks=%lu failed=%lu  display=\"%s\"\n",
+            (unsigned long)checks, (unsigned long)failures, mock_pcf8576_text());
+
+    exit((failures || ms.bad_frames) ? 1 : 0);
+}
+
+// 背光亮着的时间比例（千分比），按极性换算
+static uint32_t backlight_lit(void) {
+    uint32_t duty = sim_pin_duty(LCD_BL_PIN);
+    return LCD_BL_ACTIVE_HIGH ? duty : 1000u - duty;
+}
+
+static void run_action(void *ctx) {
+    act_t *a = (act_t *)ctx;
+    double t_s = (double)sim_now_us() / 1e6;
+
+    switch (a->kind) {
+    case ACT_PIN:
+        if (a->release) {
+            sim_pin_release(a->pin);
+        } else {
+            sim_pin_drive(a->pin, false);
+        }
+        break;
+    case ACT_EXPECT: {
+        const char *got = mock_pcf8576_text();
+        while (*got == ' ') {
+            got++;   // H:MM 第 1 位空着，脚本里写不出前导空格
+        }
+        checks++;
+        if (strcmp(got, a->text) != 0) {
+            failures++;
+            fprintf(stderr, "[SIM] %10.3f s  line %d: expect \"%s\", display \"%s\"  FAIL\n",
+                    t_s, a->line, a->text, got);
+        }
+        break;
+    }
+    case ACT_EXPECT_BL: {
+        uint32_t lit = backlight_lit();
+        checks++;
+        if (lit < a->bl_lo || lit > a->bl_hi) {
+            failures++;
+            fprintf(stderr, "[SIM] %10.3f s  line %d: expect backlight %s, lit %lu.%lu%%  FAIL\n",
+                    t_s, a->line, a->text, (unsigned long)lit / 10, (unsigned long)lit % 10);
+        }
+        break;
+    }
+    case ACT_EXPECT_PWM_IRQS: {
+        sim_stats_t ss;
+        sim_get_stats(&ss);
+        uint64_t got = ss.pwm_irqs - pwm_irqs_mark;
+        pwm_irqs_mark = ss.pwm_irqs;
+        checks++;
+        if (got > a->num) {
+            failures++;
+            fprintf(stderr, "[SIM] %10.3f s  line %d: expect at most %lu pwm irqs, got %llu  FAIL\n",
+                    t_s, a->line, (unsigned long)a->num, (unsigned long long)got);
+        }
+        break;
+    }
+    case ACT_EXPECT_DORMANT: {
+        sim_stats_t ss;
+        sim_get_stats(&ss);
+        checks++;
+        if (ss.dormant_sleeps != a->num) {
+            failures++;
+            fprintf(stderr, "[SIM] %10.3f s  line %d: expect %lu dormant sleeps, got %llu  FAIL\n",
+                    t_s, a->line, (unsigned long)a->num, (unsigned long long)ss.dormant_sleeps);
+        }
+        break;
+    }
+    case ACT_USB:
+        sim_usb_set((sim_usb_t)a->num);
+        break;
+    case ACT_SHOW: {
+        uint32_t lit = backlight_lit();
+        fprintf(stderr, "[SIM] %10.3f s  display \"%s\"  backlight %s (lit %lu.%lu%%)\n",
+                t_s, mock_pcf8576_text(), sim_pin_level(LCD_BL_PIN) ? "high" : "low",
+                (unsigned long)lit / 10, (unsigned long)lit % 10);
+        break;
+    }
+    case ACT_SEND:
+        sim_serial_push(a->text);
+        break;
+    case ACT_END:
+        sim_finish();
+        break;
+    }
+}
+
+static act_t *new_act(act_kind_t kind, int line) {
+    act_t *a = calloc(1, sizeof(*a));
+    if (!a) {
+        abort();
+    }
+    a->kind = kind;
+    a->line = line;
+    return a;
+}
+
+static void schedule_pin(uint64_t t_us, uint pin, bool low, int line) {
+    act_t *a = new_act(ACT_PIN, line);
+    a->pin     = pin;
+    a->release = !low;
+    sim_schedule(t_us, run_action, a);
+}
+
+// 一格 = 4 个边沿；触点接地为 0，放开靠上拉回到 1。cw 是 A 先落下
+static uint64_t schedule_rotate(uint64_t t_us, bool clockwise, int detents, uint32_t ms_per_detent, int line) {
+    static const uint8_t SEQ_CW[4][2]  = { {0, 1}, {0, 0}, {1, 0}, {1, 1} };
+    static const uint8_t SEQ_CCW[4][2] = { {1, 0}, {0, 0}, {0, 1}, {1, 1} };
+    const uint8_t (*seq)[2] = clockwise ? SEQ_CW : SEQ_CCW;
+    uint64_t step = (uint64_t)ms_per_detent * 1000u / 4u;
+
+    for (int d = 0; d < detents; ++d) {
+        for (int k = 0; k < 4; ++k) {
+            schedule_pin(t_us, ENCODER_EC11_PIN_A, seq[k][0] == 0, line);
+            schedule_pin(t_us, ENCODER_EC11_PIN_B, seq[k][1] == 0, line);
+            t_us += step;
+        }
+    }
+    return t_us;
+}
+
+// 按键触点抖动：在 t_us 处先来回弹 bounces 次，最后停在 pressed
+#define BOUNCE_STEP_US  300
+
+static void schedule_press_edge(uint64_t t_us, bool pressed, int bounces, int line) {
+    for (int k = 0; k < bounces; ++k) {
+        schedule_pin(t_us, ENCODER_EC11_PIN_C, pressed, line);
+        t_us += BOUNCE_STEP_US;
+        schedule_pin(t_us, ENCODER_EC11_PIN_C, !pressed, line);
+        t_us += BOUNCE_STEP_US;
+    }
+    schedule_pin(t_us, ENCODER_EC11_PIN_C, pressed, line);
+}
+
+// "1500" / "1500ms" / "1.5s" / "2m" / "1h" -> us
+static bool parse_time(const char *s, uint64_t *out) {
+    char *end;
+    double v = strtod(s, &end);
+    if (end == s || v < 0) {
+        return false;
+    }
+    double scale = 1000.0;   // 默认 ms
+    if (strcmp(end, "us") == 0)       scale = 1.0;
+    else if (strcmp(end, "ms") == 0 || *end == '\0') scale = 1000.0;
+    else if (strcmp(end, "s") == 0)  scale = 1e6;
+    else if (strcmp(end, "m") == 0)  scale = 60e6;
+    else if (strcmp(end, "h") == 0)  scale = 3600e6;
+    else return false;
+    *out = (uint64_t)(v * scale + 0.5);
+    return true;
+}
+
+static int load_script(FILE *f) {
+    char buf[256];
+    int line = 0;
+    uint64_t t_prev = 0, t_last = 0;
+    bool has_end = false;
+
+    while (fgets(buf, sizeof(buf), f)) {
+        line++;
+        char *hash = strchr(buf, '#');
+        if (hash) {
+            *hash = '\0';
+        }
+
+        char t_tok[32], verb[32], a1[32] = "", a2[32] = "";
+        int n = sscanf(buf, "%31s %31s %31s %31s", t_tok, verb, a1, a2);
+        if (n <= 0) {
+            continue;
+        }
+        if (n < 2) {
+            fprintf(stderr, "[SIM] line %d: missing action\n", line);
+            return -1;
+        }
+
+        bool rel = (t_tok[0] == '+');
+        uint64_t t;
+        if (!parse_time(t_tok + (rel ? 1 : 0), &t)) {
+            fprintf(stderr, "[SIM] line %d: bad time \"%s\"\n", line, t_tok);
+            return -1;
+        }
+        if (rel) {
+            t += t_prev;
+        }
+        t_prev = t;
+        uint64_t t_done = t;
+
+        if (strcmp(verb, "cw") == 0 || strcmp(verb, "ccw") == 0) {
+            int detents = (n >= 3) ? atoi(a1) : 1;
+            uint32_t ms = (n >= 4) ? (uint32_t)atoi(a2) : 30;
+            if (ms * 1000u / 4u < 2u * ENCODER_SAMPLE_FAST_US) {
+                // 快采时每个相位至少要采到两次
+                fprintf(stderr, "[SIM] line %d: %u ms/detent is faster than the %u us sampler can follow\n",
+                        line, (unsigned)ms, (unsigned)ENCODER_SAMPLE_FAST_US);
+            }
+            t_done = schedule_rotate(t, verb[1] == 'w', detents, ms, line);
+        } else if (strcmp(verb, "press") == 0) {
+            uint32_t hold    = (n >= 3) ? (uint32_t)atoi(a1) : 80;
+            int      bounces = (n >= 4) ? atoi(a2) : 0;
+            schedule_press_edge(t, true, bounces, line);
+            t_done = t + (uint64_t)hold * 1000u;
+            schedule_press_edge(t_done, false, bounces, line);
+        } else if (strcmp(verb, "expect") == 0 && n >= 3) {
+            act_t *a = new_act(ACT_EXPECT, line);
+            // 冒号没亮时是空格，脚本里写成 "12 34" 会被拆开，这里拼回去
+            snprintf(a->text, sizeof(a->text), n >= 4 ? "%s %s" : "%s", a1, a2);
+            sim_schedule(t, run_action, a);
+        } else if (strcmp(verb, "expect-bl") == 0 && n >= 3) {
+            act_t *a = new_act(ACT_EXPECT_BL, line);
+            unsigned lo, hi;
+            snprintf(a->text, sizeof(a->text), "%s", a1);
+            if (strcmp(a1, "on") == 0) {
+                a->bl_lo = 1;
+                a->bl_hi = 1000;
+            } else if (strcmp(a1, "off") == 0) {
+                a->bl_lo = 0;
+                a->bl_hi = 0;
+            } else if (sscanf(a1, "%u..%u", &lo, &hi) == 2 && lo <= hi && hi <= 100) {
+                a->bl_lo = (uint16_t)(lo * 10);
+                a->bl_hi = (uint16_t)(hi * 10);
+            } else {
+                fprintf(stderr, "[SIM] line %d: expect-bl wants on, off or <lo>..<hi>\n", line);
+                return -1;
+            }
+            sim_schedule(t, run_action, a);
+        } else if (strcmp(verb, "expect-pwm-irqs") == 0 && n >= 3) {
+            act_t *a = new_act(ACT_EXPECT_PWM_IRQS, line);
+            a->num = (uint32_t)strtoul(a1, NULL, 10);
+            sim_schedule(t, run_action, a);
+        } else if (strcmp(verb, "expect-dormant") == 0 && n >= 3) {
+            act_t *a = new_act(ACT_EXPECT_DORMANT, line);
+            a->num = (uint32_t)strtoul(a1, NULL, 10);
+            sim_schedule(t, run_action, a);
+        } else if (strcmp(verb, "usb") == 0 && n >= 3) {
+            static const char *const USB_STATES[] = { "off", "vbus", "mounted", "terminal" };
+            act_t *a = new_act(ACT_USB, line);
+            a->num = UINT32_MAX;
+            for (uint32_t k = 0; k < sizeof(USB_STATES) / sizeof(USB_STATES[0]); ++k) {
+                if (strcmp(a1, USB_STATES[k]) == 0) {
+                    a->num = k;
+                }
+            }
+            if (a->num == UINT32_MAX) {
+                fprintf(stderr, "[SIM] line %d: usb wants off, vbus, mounted or terminal\n", line);
+                return -1;
+            }
+            sim_schedule(t, run_action, a);
+        } else if (strcmp(verb, "send") == 0 && n >= 3) {
+            act_t *a = new_act(ACT_SEND, line);
+            snprintf(a->text, sizeof(a->text), "%s", a1);
+            sim_schedule(t, run_action, a);
+        } else if (strcmp(verb, "show") == 0) {
+            sim_schedule(t, run_action, new_act(ACT_SHOW, line));
+        } else if (strcmp(verb, "end") == 0) {
+            sim_schedule(t, run_action, new_act(ACT_END, line));
+            has_end = true;
+        } else {
+            fprintf(stderr, "[SIM] line %d: unknown action \"%s\"\n", line, verb);
+            return -1;
+        }
+
+        if (t_done > t_last) {
+            t_last = t_done;
+        }
+    }
+
+    if (!has_end) {
+        sim_schedule(t_last + 1000000u, run_action, new_act(ACT_END, line));
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    FILE *f = stdin;
+    if (argc > 1) {
+        f = fopen(argv[1], "r");
+        if (!f) {
+            perror(argv[1]);
+            return 2;
+        }
+    }
+    if (load_script(f) != 0) {
+        return 2;
+    }
+    if (f != stdin) {
+        fclose(f);
+    }
+
+    mock_pcf8576_attach(LCD_SDA_PIN, LCD_SCL_PIN, LCD_ADDR_8BIT);
+    sim_set_idle_forever(sim_finish);
+    clock_gettime(CLOCK_MONOTONIC, &wall_t0);
+
+    once_main();
+    sim_finish();
+    return 0;
+}
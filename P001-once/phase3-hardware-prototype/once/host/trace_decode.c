@@ -0,0 +1,132 @@
+// trace_decode.c
+// 事件日志解码：把固件串口输出里 "#T <十六进制记录...>" 的行还原成可读日志，
+// 其余行（普通 printf、计时统计）原样照抄，两者按出现顺序混在一起。
+//
+// 用法：
+//   trace_decode [日志文件]          不给文件就读 stdin，例如
+//   cat /dev/ttyACM0 | trace_decode
+//   once_host scenarios/countdown.txt | trace_decode
+//
+// 输出每条一行：[秒.微秒] 来源 事件 参数...，来源是 c0/c1（核）加 thr/irq（线程 / 中断）。
+// 32 位时间戳约 71 分钟回绕一次，这里按相邻记录的差值展开成 64 位。
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "drivers/trace.h"
+
+#define TRACE_FMT_ENTRY(id, fmt)  fmt,
+
+static const char *const TRACE_FMTS[TRACE_EVENT_COUNT] = {
+    TRACE_EVENT_LIST(TRACE_FMT_ENTRY)
+};
+
+#define REC_HEX_LEN  (2 * sizeof(trace_rec_t))
+
+static uint64_t t_base  = 0;       // 展开后的 64 位时间
+static uint32_t t_last  = 0;
+static bool     t_valid = false;
+static unsigned long n_records = 0, n_bad = 0;
+
+static int hex_nibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool parse_hex(const char *s, uint8_t *out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        int hi = hex_nibble(s[2 * i]);
+        int lo = hex_nibble(s[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        out[i] = (uint8_t)((hi << 4) | lo);
+    }
+    return true;
+}
+
+// 线上格式固定小端，不依赖本机字节序
+static uint32_t le32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void print_record(const uint8_t *b) {
+    uint32_t t32 = le32(&b[0]);
+    uint8_t  id  = b[4];
+    uint8_t  src = b[5];
+    long     a0  = (long)((uint16_t)b[6] | ((uint16_t)b[7] << 8));
+    long     a1  = (long)(int32_t)le32(&b[8]);
+    long     a2  = (long)(int32_t)le32(&b[12]);
+
+    // 多个环按时间戳合并，DROPPED 用的是发出时刻，所以允许小幅倒退
+    if (!t_valid) {
+        t_base  = t32;
+        t_valid = true;
+    } else {
+        t_base += (uint64_t)(int64_t)(int32_t)(t32 - t_last);
+    }
+    t_last = t32;
+
+    printf("[%6llu.%06llu] c%d %s  ",
+           (unsigned long long)(t_base / 1000000u),
+           (unsigned long long)(t_base % 1000000u),
+           (src & 2) ? 1 : 0,
+           (src & 1) ? "irq" : "thr");
+
+    if (id < TRACE_EVENT_COUNT) {
+        printf(TRACE_FMTS[id], a0, a1, a2);
+    } else {
+        printf("unknown id=%u a0=%ld a1=%ld a2=%ld", id, a0, a1, a2);
+    }
+    printf("\n");
+    n_records++;
+}
+
+static void decode_line(const char *p) {
+    while (*p == ' ') {
+        ++p;
+    }
+    size_t len = strcspn(p, "\r\n");
+    while (len >= REC_HEX_LEN) {
+        uint8_t b[sizeof(trace_rec_t)];
+        if (!parse_hex(p, b, sizeof(b))) {
+            n_bad++;
+            return;
+        }
+        print_record(b);
+        p   += REC_HEX_LEN;
+        len -= REC_HEX_LEN;
+    }
+    if (len > 0) {
+        n_bad++;   // 行尾不够一条（串口截断）
+    }
+}
+
+int main(int argc, char **argv) {
+    FILE *f = stdin;
+    if (argc > 1) {
+        f = fopen(argv[1], "r");
+        if (!f) {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+
+    static char line[4096];
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "#T ", 3) == 0) {
+            decode_line(line + 3);
+        } else {
+            fputs(line, stdout);
+        }
+    }
+    if (f != stdin) {
+        fclose(f);
+    }
+
+    fprintf(stderr, "[TRACE] %lu records, %lu malformed\n", n_records, n_bad);
+    return n_bad ? 1 : 0;
+}
@@ -4,243 +4,307 @@
 #include "hardware/timer.h"
 #include "hardware/clocks.h"
 #include "hardware/gpio.h"
-#include "drivers/lcd_pcf8576.h"
 #include "drivers/board.h"
 #include "drivers/encoder_ec11.h"
-
-// 小工具：根据总秒数显示 MM:SS
+#include "drivers/deadline.h"
+#include "drivers/instr.h"
+#include "drivers/trace.h"
+#include "drivers/ui_core.h"
+#include "drivers/cpu_load.h"
+#include "drivers/session_log.h"
+#include "drivers/boot_time.h"
+#include "drivers/power.h"
+#include "drivers/backlight.h"
+#include "app/timer_fsm.h"
+#include "app/accel.h"
+#include "app/score.h"
+
+// 小工具：根据总秒数显示 MM:SS（异步提交，不阻塞主循环；双核时交给 core 1）
 static void show_time_from_total_sec(uint16_t total_sec) {
-    if (total_sec > 59 * 60 + 59) {
-        total_sec = 59 * 60 + 59;
+    if (total_sec > TIMER_FSM_MAX_SEC) {
+        total_sec = TIMER_FSM_MAX_SEC;
     }
     uint8_t mm = total_sec / 60;
     uint8_t ss = total_sec % 60;
-    lcd_pcf8576_show_time_mmss(mm, ss);
+    ui_show_mmss(mm, ss);
 }
 
-typedef enum {
-    TIMER_STATE_SET = 0,      // 设定目标时间
-    TIMER_STATE_RUNNING,      // 正在计时
-    TIMER_STATE_PAUSED,       // 暂停在中途某个时间
-    TIMER_STATE_DONE          // 计时完成，闪烁背光
-} timer_state_t;
+// 显示计时：tenths 单位 0.1 s，状态机已经按分档取过整
+static void show_elapsed(const timer_fsm_t *fsm, uint32_t tenths) {
+    uint32_t sec = tenths / 10;
+    switch (timer_fsm_show_fmt(fsm->tenths, (uint64_t)tenths * 100000)) {
+    case TIMER_SHOW_MSSD:
+        ui_show_mssd((uint8_t)(sec / 60), (uint8_t)(sec % 60), (uint8_t)(tenths % 10));
+        break;
+    case TIMER_SHOW_MMSS:
+        ui_show_mmss((uint8_t)(sec / 60), (uint8_t)(sec % 60));
+        break;
+    case TIMER_SHOW_HMM:
+        ui_show_hmm((uint8_t)(sec / 3600), (uint8_t)(sec / 60 % 60));
+        break;
+    }
+}
 
-int main() {
-    stdio_init_all();
-    sleep_ms(200);
+// 没有更早的截止时间时用它表示“一直睡到有中断为止”
+#define NO_DEADLINE  UINT64_MAX
 
-    lcd_pcf8576_init();
-    lcd_backlight_on();
+// 睡到 deadline_us 或者任意中断（编码器 / 按键 / LCD 完成 / USB）到来
+static void idle_until(uint64_t deadline_us) {
+#if ONCE_IDLE_WFE
+    if (deadline_us == NO_DEADLINE) {
+        __wfe();
+    } else {
+        best_effort_wfe_or_timeout(from_us_since_boot(deadline_us));
+    }
+#else
+    (void)deadline_us;
+    tight_loop_contents();
+#endif
+}
+
+// 计时刷新（每秒，或显示 0.1 s 时每 100 ms）和闪烁：都挂在硬件 alarm 上。
+// PWM 背光时闪烁整个交给 backlight.c 的回绕中断，blink_tick 不用
+static deadline_t run_tick;
+static deadline_t blink_tick;
+
+#define BLINK_PERIOD_US  300000   // 0.3s
+
+// 把状态机给出的副作用落到硬件上；t_us 是触发它的事件时刻
+static void ONCE_HOT_FUNC(apply_effects)(const timer_fsm_t *fsm, const timer_fx_list_t *fx, uint64_t t_us) {
+    for (uint8_t i = 0; i < fx->count; ++i) {
+        const timer_fx_t *f = &fx->fx[i];
+        switch (f->kind) {
+        case TIMER_FX_SHOW:
+            show_time_from_total_sec((uint16_t)f->arg);
+            break;
+        case TIMER_FX_SHOW_ELAPSED:
+            show_elapsed(fsm, (uint32_t)f->arg);
+            break;
+        case TIMER_FX_BACKLIGHT:
+            ui_backlight(f->arg != 0);
+            break;
+        case TIMER_FX_TICK_START:
+            // 从 t_us 起 arg us 后走第一跳（暂停前没走完的那一格接着数）
+            if (!deadline_start(&run_tick, t_us + (uint32_t)f->arg, timer_fsm_tick_us(fsm))) {
+                TRACE(TICK_NO_ALARM, fsm->state, f->arg, timer_fsm_tick_us(fsm));   // alarm 池满了
+            }
+            break;
+        case TIMER_FX_TICK_STOP:
+            deadline_cancel(&run_tick);
+            break;
+        case TIMER_FX_BLINK_START:
+#if ONCE_BL_PWM
+            ui_backlight_pattern(BACKLIGHT_BLINK, t_us);
+#else
+            deadline_start(&blink_tick, t_us + BLINK_PERIOD_US, BLINK_PERIOD_US);
+#endif
+            break;
+        case TIMER_FX_BLINK_STOP:
+#if ONCE_BL_PWM
+            ui_backlight(fsm->backlight_on);   // 停在状态机认为的亮 / 灭上
+#else
+            deadline_cancel(&blink_tick);
+#endif
+            break;
+        }
+    }
+}
+
+// 喂一个事件给状态机并执行副作用，返回事件有没有被处理
+static bool ONCE_HOT_FUNC(dispatch)(timer_fsm_t *fsm, timer_event_kind_t kind, int32_t arg, uint64_t t_us) {
+    const timer_event_t ev = { kind, arg, t_us };
+    timer_fx_list_t fx;
+    INSTR_BEGIN(FSM_STEP);
+    bool handled = timer_fsm_step(fsm, &ev, fsm, &fx);
+    INSTR_END(FSM_STEP);
+    if (!handled) {
+        return false;
+    }
+    apply_effects(fsm, &fx, t_us);
+    return true;
+}
+
+int main() {
+    instr_init();
+    trace_init();
+    boot_mark(BOOT_MAIN);
+    power_init();         // clk_peri 挪到 pll_usb，要赶在 LCD 的 I2C 算波特率之前
+
+    // 开机先让屏亮起来：LCD 总线 + 模式设置 -> 目标时间 00:00 -> 写完再开背光。
+    // 双核时 LCD 在 core 1 上初始化，这里等它就绪
+    timer_fsm_t fsm;
+    timer_fsm_init(&fsm);
+    timer_fsm_set_tenths(&fsm, ONCE_SHOW_TENTHS);
+    ui_init();
+    show_time_from_total_sec(fsm.target_sec);
+    ui_first_frame();   // 到这里状态机的初始输出（00:00、背光亮）和硬件一致
 
     Encoder_Init();
+    boot_mark(BOOT_ENCODER);
 
     // GP9 输出高电平，给模块供电
     gpio_init(9);
     gpio_set_dir(9, GPIO_OUT);
     gpio_put(9, 1);
 
-    uint16_t target_total_sec  = 0;   // 目标时间（秒）
-    uint16_t elapsed_total_sec = 0;   // 已经计时（秒）
-    show_time_from_total_sec(target_total_sec);
-
-    printf("ENC debug start.\r\n");
-    printf("A=%d B=%d C=%d\r\n",
-           gpio_get(ENCODER_EC11_PIN_A),
-           gpio_get(ENCODER_EC11_PIN_B),
-           gpio_get(ENCODER_EC11_PIN_C));
-
-    timer_state_t state = TIMER_STATE_SET;
-
-    // 速度相关状态
-    int32_t  step_seconds = 1;
-    int8_t   last_dir     = 0;        // +1(逆时针)、-1(顺时针) —— 逻辑方向
-    uint64_t last_rot_us  = 0;
-
-    // 你手感好的这套
-    const int32_t STEP_TAB[]    = {1, 2, 5, 10, 20, 30};
-    const int     STEP_TAB_LEN  = sizeof(STEP_TAB) / sizeof(STEP_TAB[0]);
-    int           step_idx      = 0;
-
-    // 调得更“迟钝”一点
-    const uint32_t FAST_MS = 50;      // < 50ms 才算真快
-    const uint32_t SLOW_MS = 400;     // > 400ms 算停顿
-
-    // 计时 & 闪烁
-    uint64_t last_sec_tick_us = 0;
-    uint64_t last_blink_us    = 0;
-    bool     backlight_is_on  = true;
-
+    TRACE(BOOT,
+          gpio_get(ENCODER_EC11_PIN_A),
+          gpio_get(ENCODER_EC11_PIN_B),
+          gpio_get(ENCODER_EC11_PIN_C));
+
+    // 不急的放后面：flash 里的会话记录只读几个扇区头，不擦不写；USB 串口最后起
+    session_log_init();
+    boot_mark(BOOT_SESSION_LOG);
+    ui_start_io();
+
+    // 旋钮加速：默认按平滑后的转速查曲线，ONCE_ACCEL_VELOCITY=0 退回原来的六档阶梯
+#if ONCE_ACCEL_VELOCITY
+    accel_t accel;
+    accel_reset(&accel);
+#else
+    accel_ladder_t ladder;
+    accel_ladder_reset(&ladder);
+#endif
+
+    // 主循环统计：每秒迭代次数，对比忙等和 WFE 睡眠
+    uint32_t loop_iters   = 0;
+    uint64_t loop_stat_us = time_us_64();
+    cpu_load_t load;
+    cpu_load_init(&load, 0);
+
+    boot_mark(BOOT_MAIN_LOOP);
     while (true) {
+        INSTR_BEGIN(MAIN_LOOP);
         uint64_t now = time_us_64();
 
-        // 计时：只有 RUNNING 状态才走表
-        if (state == TIMER_STATE_RUNNING && target_total_sec > 0) {
-            if (last_sec_tick_us == 0) {
-                last_sec_tick_us = now;
-            }
-
-            if (now - last_sec_tick_us >= 1000000) {
-                last_sec_tick_us += 1000000;
+        loop_iters++;
+        if (now - loop_stat_us >= 1000000) {
+#if ONCE_LOOP_STATS
+            TRACE(LOOP, fsm.state, loop_iters, 0);
+#endif
+            loop_iters   = 0;
+            loop_stat_us = now;
+        }
+        cpu_load_poll(&load, now);
 
-                if (elapsed_total_sec < target_total_sec) {
-                    elapsed_total_sec++;
-                    show_time_from_total_sec(elapsed_total_sec);
+        // 处理编码器事件：一次取走所有待处理事件，时间用中断里检测到的那一刻
+        encoder_event_t evs[16];
+        INSTR_BEGIN(ENC_READ);
+        size_t n_ev = Encoder_ReadEvents(evs, sizeof(evs) / sizeof(evs[0]));
+        INSTR_END(ENC_READ);
 
-                    if (elapsed_total_sec >= target_total_sec) {
-                        elapsed_total_sec = target_total_sec;
-                        state = TIMER_STATE_DONE;
-                        last_blink_us = now;
-                        backlight_is_on = true;
-                        lcd_backlight_on();
-                    }
-                }
-            }
-        } else {
-            last_sec_tick_us = 0;
+        // 有人动了，或者在计时 / 暂停：保持满速；SET / DONE 里没人碰才会降频、休眠
+        if (n_ev > 0 || fsm.state == TIMER_STATE_RUNNING || fsm.state == TIMER_STATE_PAUSED) {
+            power_kick(now);
         }
 
-        // 背光闪烁：DONE 状态
-        if (state == TIMER_STATE_DONE) {
-            const uint32_t BLINK_PERIOD_US = 300000; // 0.3s
-            if (last_blink_us == 0) {
-                last_blink_us = now;
-            }
-            if (now - last_blink_us >= BLINK_PERIOD_US) {
-                last_blink_us += BLINK_PERIOD_US;
-                backlight_is_on = !backlight_is_on;
-                if (backlight_is_on) {
-                    lcd_backlight_on();
-                } else {
-                    lcd_backlight_off();
+        // 计时：刷新由硬件 alarm 按理论时刻打点，这里只数到点了几次。
+        // 和编码器事件按时间戳先后交替喂给状态机，按键正好卡在刷新前后时也不会显示错一格
+        const uint32_t tick_us = run_tick.period_us;
+        uint64_t tick_due_us = 0;   // 没到点时 deadline_take 不写，也用不上
+        uint32_t n_tick = deadline_take(&run_tick, &tick_due_us);
+        uint64_t next_tick_us = tick_due_us - (uint64_t)(n_tick ? n_tick - 1 : 0) * tick_us;
+
+        size_t i = 0;
+        while (n_tick > 0 || i < n_ev) {
+            if (n_tick > 0 && (i == n_ev || next_tick_us <= evs[i].t_us)) {
+                if (!dispatch(&fsm, TIMER_EV_TICK, 0, next_tick_us)) {
+                    n_tick = 0;   // 已经不在 RUNNING，剩下的刷新作废
+                    continue;
                 }
+#if ONCE_TICK_STATS
+                deadline_stats_t ts;
+                deadline_get_stats(&run_tick, &ts);
+                TRACE(TICK, ts.last_late_us, timer_fsm_elapsed_us(&fsm, next_tick_us) / 1000,
+                      time_us_64() - next_tick_us);
+#endif
+                next_tick_us += tick_us;
+                n_tick--;
+                continue;
             }
-        } else {
-            if (!backlight_is_on) {
-                lcd_backlight_on();
-                backlight_is_on = true;
-            }
-            last_blink_us = 0;
-        }
 
-        // 处理编码器事件
-        uint8_t ev = Encoder_ReadData();
+            uint8_t  ev    = evs[i].type;
+            uint64_t ev_us = evs[i].t_us;
+            i++;
 
-        if (ev != encoder_none) {
-            int32_t delta = 0;
-            const char *ev_name = "none";
-
-            // 按键：切换状态，不改目标时间
+            // 按键：切换状态，不改目标时间；暂停时的计时按按键时间戳结算
             if (ev == key) {
-                ev_name = "key";
-
-                if (state == TIMER_STATE_SET) {
-                    // 从 SET → RUNNING
-                    elapsed_total_sec = 0;
-                    show_time_from_total_sec(elapsed_total_sec);
-                    state = TIMER_STATE_RUNNING;
-                    last_sec_tick_us = now;
-                    backlight_is_on = true;
-                    lcd_backlight_on();
-                } else if (state == TIMER_STATE_RUNNING) {
-                    // RUNNING → PAUSED
-                    state = TIMER_STATE_PAUSED;
-                    show_time_from_total_sec(elapsed_total_sec);
-                    backlight_is_on = true;
-                    lcd_backlight_on();
-                } else if (state == TIMER_STATE_PAUSED) {
-                    // PAUSED → RUNNING
-                    state = TIMER_STATE_RUNNING;
-                    last_sec_tick_us = now;
-                    show_time_from_total_sec(elapsed_total_sec);
-                    backlight_is_on = true;
-                    lcd_backlight_on();
-                } else if (state == TIMER_STATE_DONE) {
-                    // DONE → SET（停止闪烁，计时归零）
-                    state = TIMER_STATE_SET;
-                    elapsed_total_sec = 0;
-                    backlight_is_on = true;
-                    lcd_backlight_on();
-                    show_time_from_total_sec(target_total_sec);
+                // 计时中按下就是一次“停”：按按键时刻的实际计时打分、记进会话记录（到点自动结束的不算）
+                bool     stopping = (fsm.state == TIMER_STATE_RUNNING);
+                uint64_t run_us   = stopping ? timer_fsm_elapsed_us(&fsm, ev_us) : 0;
+
+                dispatch(&fsm, TIMER_EV_KEY, 0, ev_us);
+                TRACE(KEY, fsm.state, fsm.elapsed_us / 1000, fsm.target_sec);
+
+                if (stopping) {
+                    uint64_t target_us = (uint64_t)fsm.target_sec * 1000000u;
+                    INSTR_BEGIN(SCORE);
+                    uint8_t points = score_run(run_us, target_us);
+                    INSTR_END(SCORE);
+                    if (points != SCORE_NONE) {
+                        TRACE(SCORE, points, (int32_t)(((int64_t)run_us - (int64_t)target_us) / 1000),
+                              fsm.target_sec);
+#if ONCE_BL_PWM
+                        if (points >= SCORE_SWEET_SPOT) {
+                            ui_backlight_pattern(BACKLIGHT_PULSE, ev_us);
+                        }
+#endif
+                    }
+                    session_log_append(fsm.target_sec, run_us, points);
                 }
-
-                printf("[KEY]   state=%d  target=%4u  elapsed=%4u\n",
-                       state, target_total_sec, elapsed_total_sec);
             }
 
-            // 旋转：设定 / 重设目标时间
-            if (ev == cw || ev == ccw) {
+            // 旋转：设定 / 重设目标时间（RUNNING 状态下旋钮不改目标时间）
+            if ((ev == cw || ev == ccw) && timer_fsm_rotate_adjusts(&fsm)) {
                 // 注意：这里的 cw/ccw 是“驱动眼中的方向”，和你手上顺/逆时针，
                 // 目前因为接线关系是反的，但逻辑是稳定的。
                 int8_t dir = (ev == ccw) ? +1 : -1;
-                ev_name = (ev == ccw) ? "ccw" : "cw";
-
-                // DONE 状态下旋钮一动：回到 SET 模式，停掉闪烁
-                if (state == TIMER_STATE_DONE) {
-                    state = TIMER_STATE_SET;
-                    elapsed_total_sec = 0;
-                    backlight_is_on = true;
-                    lcd_backlight_on();
-                    show_time_from_total_sec(target_total_sec);
-                }
 
-                // PAUSED 状态下旋钮一动：回到 SET 模式，基于原目标时间调整
-                if (state == TIMER_STATE_PAUSED) {
-                    state = TIMER_STATE_SET;
-                    elapsed_total_sec = 0;
-                    backlight_is_on = true;
-                    lcd_backlight_on();
-                    show_time_from_total_sec(target_total_sec);
-                }
-
-                // RUNNING 状态下旋钮不改目标时间
-                if (state == TIMER_STATE_RUNNING) {
-                    delta = 0;
-                } else {
-                    // SET 状态下才调整 target_total_sec
-                    uint64_t diff_ms = 0;
-                    if (last_rot_us != 0) {
-                        uint64_t diff = now - last_rot_us;
-                        diff_ms = diff / 1000;
-                    }
-
-                    if (last_rot_us == 0) {
-                        step_idx = 0;
-                    } else {
-                        if (dir == last_dir && diff_ms > 0 && diff_ms < FAST_MS) {
-                            if (step_idx < STEP_TAB_LEN - 1) {
-                                step_idx++;
-                            }
-                        } else if (diff_ms > SLOW_MS || dir != last_dir) {
-                            step_idx = 0;
-                        }
-                    }
+#if ONCE_ACCEL_VELOCITY
+                int32_t delta = accel_step(&accel, &ACCEL_CURVE_DEFAULT, dir, ev_us, fsm.target_sec);
+                int32_t step_seconds = accel.step_sec;
+#else
+                int32_t delta = accel_ladder_step(&ladder, dir, ev_us);
+                int32_t step_seconds = delta * dir;
+#endif
+
+                int32_t before_target = fsm.target_sec;
+                dispatch(&fsm, TIMER_EV_ROTATE, delta, ev_us);
+                TRACE(ENC, step_seconds, before_target, fsm.target_sec);
+            }
+        }
 
-                    step_seconds = STEP_TAB[step_idx];
-                    last_dir     = dir;
-                    last_rot_us  = now;
+        // 背光闪烁：每到点一次翻转一次（DONE 以外状态机会忽略）
+        uint64_t blink_due_us = 0;
+        uint32_t n_blink = deadline_take(&blink_tick, &blink_due_us);
+        while (n_blink-- > 0) {
+            dispatch(&fsm, TIMER_EV_BLINK, 0, blink_due_us);
+        }
 
-                    int32_t before_target = target_total_sec;
-                    int32_t t = before_target + dir * step_seconds;
-                    if (t < 0) t = 0;
-                    if (t > 59 * 60 + 59) t = 59 * 60 + 59;
-                    target_total_sec = (uint16_t)t;
-                    delta = dir * step_seconds;
+        INSTR_END(MAIN_LOOP);
 
-                    if (state == TIMER_STATE_SET) {
-                        show_time_from_total_sec(target_total_sec);
-                    }
+        // 会话记录写 flash 要关中断（擦扇区几十 ms），只在 SET / DONE 里每圈做一步。
+        // PAUSED 也算计时中：关中断期间按键的边沿中断进不来，继续的那一下时刻记晚，直接算进成绩
+        bool slog_idle = (fsm.state == TIMER_STATE_SET || fsm.state == TIMER_STATE_DONE);
+        bool slog_busy = slog_idle && session_log_service();
 
-                    printf("[ENC]  before=%4d  after=%4d  step=%2d  delta=%+4d  ev=%s\n",
-                           before_target,
-                           target_total_sec,
-                           step_seconds,
-                           delta,
-                           ev_name);
-                }
+        // 秒跳、闪烁由 alarm 中断 SEV 叫醒；这里只需一直睡到有中断为止
+        // 还有没取完的事件就不睡，马上再跑一圈；单核时串口命令和日志也只在这时候处理
+        if (!slog_busy && !Encoder_HasEvent() && !ui_service()) {
+            // DORMANT 里 timer 跟着晶振停，只有没有截止时间在跑（SET 里）、背光也没在播图案才能进
+            bool quiet = !deadline_running(&run_tick) && !deadline_running(&blink_tick) && !backlight_busy();
+            if (power_idle(now, quiet)) {
+                continue;   // 刚醒来，先去取叫醒它的那一格
             }
-        }
 
-        tight_loop_contents();
+            uint64_t deadline = power_next_us(quiet);   // 没有下一级时就是 NO_DEADLINE
+#if ONCE_LOOP_STATS
+            if (loop_stat_us + 1000000 < deadline) deadline = loop_stat_us + 1000000;
+#endif
+            cpu_load_idle_begin(&load);
+            idle_until(deadline);
+            cpu_load_idle_end(&load);
+        }
     }
 
     return 0;